@@ -388,6 +388,133 @@ TEST_P(CacheTest, EvictEmptyCache) {
   ASSERT_OK(cache->Insert("foo", nullptr, 10, dumbDeleter));
 }
 
+TEST_P(CacheTest, EvictionCallback) {
+  std::shared_ptr<Cache> cache = NewCache(10, 0, false);
+  std::vector<int> evicted_keys;
+  int tag;
+  Status s = cache->AddEvictionCallback(
+      &tag, [&](const Slice& key, void* value, size_t charge,
+                void (*deleter)(const Slice&, void*)) {
+        ASSERT_EQ(1U, charge);
+        ASSERT_EQ(&CacheTest::Deleter, deleter);
+        ASSERT_EQ(DecodeKey(key) + 1000, DecodeValue(value));
+        evicted_keys.push_back(DecodeKey(key));
+      });
+  if (GetParam() == kClock) {
+    ASSERT_TRUE(s.IsNotSupported());
+    return;
+  }
+  ASSERT_OK(s);
+
+  for (int i = 0; i < 10; i++) {
+    Insert(cache, i, 1000 + i);
+  }
+  ASSERT_TRUE(evicted_keys.empty());
+  Insert(cache, 10, 1010);
+  ASSERT_EQ(1U, evicted_keys.size());
+  ASSERT_EQ(0, evicted_keys[0]);
+
+  // Erased and replaced entries are not evicted
+  Erase(cache, 5);
+  Insert(cache, 6, 1006);
+  ASSERT_EQ(1U, evicted_keys.size());
+  ASSERT_EQ(3U, deleted_keys_.size());
+
+  // Shrinking evicts the least recently used entries
+  cache->SetCapacity(5);
+  ASSERT_EQ(5U, evicted_keys.size());
+  ASSERT_EQ(4, evicted_keys.back());
+
+  cache->RemoveEvictionCallback(&tag);
+  Insert(cache, 11, 1011);
+  ASSERT_EQ(5U, evicted_keys.size());
+}
+
+TEST_P(CacheTest, EvictionCallbackRegistration) {
+  std::shared_ptr<Cache> cache = NewCache(1, 0, false);
+  if (GetParam() == kClock) {
+    return;
+  }
+  int tag_a, tag_b;
+  // The callbacks own their counters, so the test can tell when the cache
+  // has destroyed them
+  auto count_a = std::make_shared<int>(0);
+  auto count_a2 = std::make_shared<int>(0);
+  auto count_b = std::make_shared<int>(0);
+  std::weak_ptr<int> weak_a = count_a;
+  auto callback = [](std::shared_ptr<int> count) {
+    return [count](const Slice&, void*, size_t, void (*)(const Slice&, void*)) {
+      ++*count;
+    };
+  };
+  ASSERT_OK(cache->AddEvictionCallback(&tag_a, callback(count_a)));
+  ASSERT_OK(cache->AddEvictionCallback(&tag_b, callback(count_b)));
+  // Same tag, only a reference is taken and the first callback is kept
+  ASSERT_OK(cache->AddEvictionCallback(&tag_a, callback(count_a2)));
+
+  Insert(cache, 1, 1001);
+  Insert(cache, 2, 1002);
+  ASSERT_EQ(1, *count_a);
+  ASSERT_EQ(1, *count_b);
+  ASSERT_EQ(0, *count_a2);
+
+  cache->RemoveEvictionCallback(&tag_a);
+  Insert(cache, 3, 1003);
+  ASSERT_EQ(2, *count_a);
+  ASSERT_EQ(2, *count_b);
+
+  cache->RemoveEvictionCallback(&tag_a);
+  Insert(cache, 4, 1004);
+  ASSERT_EQ(2, *count_a);
+  ASSERT_EQ(3, *count_b);
+  count_a.reset();
+  ASSERT_TRUE(weak_a.expired());
+
+  cache->RemoveEvictionCallback(&tag_b);
+  Insert(cache, 5, 1005);
+  ASSERT_EQ(3, *count_b);
+}
+
+class LIRSCacheTest : public testing::Test {
+ public:
+  static void Deleter(const Slice& /*key*/, void* /*value*/) { ++num_deleted_; }
+
+  static size_t num_deleted_;
+};
+
+size_t LIRSCacheTest::num_deleted_ = 0;
+
+TEST_F(LIRSCacheTest, EvictionCallback) {
+  std::shared_ptr<Cache> cache = NewLIRSCache(10, 0, false);
+  num_deleted_ = 0;
+  size_t num_evicted = 0;
+  int tag;
+  ASSERT_OK(cache->AddEvictionCallback(
+      &tag, [&](const Slice& /*key*/, void* /*value*/, size_t /*charge*/,
+                void (*deleter)(const Slice&, void*)) {
+        ASSERT_EQ(&LIRSCacheTest::Deleter, deleter);
+        ++num_evicted;
+      }));
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), EncodeValue(1000 + i), 1,
+                            &LIRSCacheTest::Deleter));
+    Cache::Handle* handle = cache->Lookup(EncodeKey(i / 2));
+    if (handle != nullptr) {
+      cache->Release(handle);
+    }
+  }
+  ASSERT_LT(0U, num_evicted);
+  ASSERT_EQ(num_deleted_, num_evicted);
+
+  cache->RemoveEvictionCallback(&tag);
+  size_t num_evicted_before = num_evicted;
+  for (int i = 100; i < 120; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), EncodeValue(1000 + i), 1,
+                            &LIRSCacheTest::Deleter));
+  }
+  ASSERT_EQ(num_evicted_before, num_evicted);
+}
+
 TEST_P(CacheTest, EraseFromDeleter) {
   // Have deleter which will erase item from cache, which will re-enter
   // the cache at that point.
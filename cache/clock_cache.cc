@@ -714,6 +714,11 @@ class ClockCache : public ShardedCache {
 
   virtual void DisownData() override { shards_ = nullptr; }
 
+  virtual Status AddEvictionCallback(const void* /*tag*/,
+                                     EvictionCallback /*callback*/) override {
+    return Status::NotSupported("ClockCache doesn't report evictions");
+  }
+
  private:
   ClockCacheShard* shards_;
 };
@@ -324,6 +324,7 @@ bool LIRSCacheShard::Release(Cache::Handle* handle, bool force_erase) {
   }
   LIRSHandle* e = reinterpret_cast<LIRSHandle*>(handle);
   bool last_reference = false;
+  EvictionCallbackPtr eviction_callback;
   {
     MutexLock l(&mutex_);
     last_reference = Unref(e);
@@ -340,11 +341,15 @@ bool LIRSCacheShard::Release(Cache::Handle* handle, bool force_erase) {
         Unref(e);
         usage_ -= e->charge;
         last_reference = true;
+        if (!force_erase) {
+          eviction_callback = eviction_callback_;
+        }
       }
     }
   }
 
   // free outside of mutex
+  NotifyEvicted(eviction_callback, e);
   if (last_reference) {
     e->Free();
   }
@@ -370,9 +375,15 @@ Status LIRSCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   memcpy(e->key_data, key.data(), key.size());
 
   autovector<LIRSHandle*> last_reference_list;
+  size_t num_evicted = 0;
+  EvictionCallbackPtr eviction_callback;
   {
     MutexLock l(&mutex_);
     EvictFromLIRS(charge, &last_reference_list);
+    num_evicted = last_reference_list.size();
+    if (num_evicted > 0) {
+      eviction_callback = eviction_callback_;
+    }
     if (usage_ + charge > capacity_ && strict_capacity_limit_) {
       e->refs = 0;
       last_reference_list.push_back(e);
@@ -400,6 +411,7 @@ Status LIRSCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
     }
   }
 
+  NotifyEvicted(eviction_callback, last_reference_list, num_evicted);
   for (auto entry : last_reference_list) {
     entry->Free();
   }
@@ -443,6 +455,12 @@ size_t LIRSCacheShard::GetPinnedUsage() const {
   return usage_ - stack_usage_;
 }
 
+void LIRSCacheShard::SetEvictionCallback(EvictionCallbackPtr callback) {
+  // The previous callback is released outside of mutex
+  MutexLock l(&mutex_);
+  eviction_callback_.swap(callback);
+}
+
 std::string LIRSCacheShard::GetPrintableOptions() const {
   const int kBufferSize = 200;
   char buffer[kBufferSize];
@@ -118,6 +118,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LIRSCacheShard : public CacheShard {
 
   virtual std::string GetPrintableOptions() const override;
 
+  virtual void SetEvictionCallback(EvictionCallbackPtr callback) override;
+
  private:
   void PushToQueue(LIRSHandle* h);
   void RemoveFromQueue(LIRSHandle* h);
@@ -262,14 +262,20 @@ void LRUCacheShardTemplate<CacheMonitor>::EvictFromLRU(
 template <class CacheMonitor>
 void LRUCacheShardTemplate<CacheMonitor>::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
+  EvictionCallbackPtr eviction_callback;
   {
     MutexLock l(&mutex_);
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
     EvictFromLRU(0, &last_reference_list);
+    if (!last_reference_list.empty()) {
+      eviction_callback = eviction_callback_;
+    }
   }
   // we free the entries here outside of mutex for
   // performance reasons
+  NotifyEvicted(eviction_callback, last_reference_list,
+                last_reference_list.size());
   for (auto entry : last_reference_list) {
     entry->Free();
   }
@@ -326,6 +332,7 @@ bool LRUCacheShardTemplate<CacheMonitor>::Release(Cache::Handle* handle,
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
   bool last_reference = false;
+  EvictionCallbackPtr eviction_callback;
   {
     MutexLock l(&mutex_);
     last_reference = Unref(e);
@@ -344,6 +351,9 @@ bool LRUCacheShardTemplate<CacheMonitor>::Release(Cache::Handle* handle,
         Unref(e);
         UsageSub(e);
         last_reference = true;
+        if (!force_erase) {
+          eviction_callback = eviction_callback_;
+        }
       } else {
         // put the item on the list to be potentially freed
         LRU_Insert(e);
@@ -352,6 +362,7 @@ bool LRUCacheShardTemplate<CacheMonitor>::Release(Cache::Handle* handle,
   }
 
   // free outside of mutex
+  NotifyEvicted(eviction_callback, e);
   if (last_reference) {
     e->Free();
   }
@@ -370,6 +381,8 @@ Status LRUCacheShardTemplate<CacheMonitor>::Insert(
       new char[sizeof(LRUHandle) - 1 + key.size()]);
   Status s;
   autovector<LRUHandle*> last_reference_list;
+  size_t num_evicted = 0;
+  EvictionCallbackPtr eviction_callback;
 
   e->value = value;
   e->deleter = deleter;
@@ -391,6 +404,10 @@ Status LRUCacheShardTemplate<CacheMonitor>::Insert(
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty
     EvictFromLRU(charge, &last_reference_list);
+    num_evicted = last_reference_list.size();
+    if (num_evicted > 0) {
+      eviction_callback = eviction_callback_;
+    }
 
     if (usage_ - lru_usage_ + charge > capacity_ &&
         (strict_capacity_limit_ || handle == nullptr)) {
@@ -430,6 +447,7 @@ Status LRUCacheShardTemplate<CacheMonitor>::Insert(
 
   // we free the entries here outside of mutex for
   // performance reasons
+  NotifyEvicted(eviction_callback, last_reference_list, num_evicted);
   for (auto entry : last_reference_list) {
     entry->Free();
   }
@@ -477,6 +495,14 @@ size_t LRUCacheShardTemplate<CacheMonitor>::GetPinnedUsage() const {
   return usage_ - lru_usage_;
 }
 
+template <class CacheMonitor>
+void LRUCacheShardTemplate<CacheMonitor>::SetEvictionCallback(
+    EvictionCallbackPtr callback) {
+  // The previous callback is released outside of mutex
+  MutexLock l(&mutex_);
+  eviction_callback_.swap(callback);
+}
+
 template <class CacheMonitor>
 std::string LRUCacheShardTemplate<CacheMonitor>::GetPrintableOptions() const {
   const int kBufferSize = 200;
@@ -225,6 +225,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShardTemplate : public CacheMonitor,
 
   virtual std::string GetPrintableOptions() const override;
 
+  virtual void SetEvictionCallback(EvictionCallbackPtr callback) override;
+
   void TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri);
 
   //  Retrieves number of elements in LRU, for unit test purpose only
@@ -48,6 +48,60 @@ void ShardedCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
+Status ShardedCache::AddEvictionCallback(const void* tag,
+                                         EvictionCallback callback) {
+  MutexLock l(&capacity_mutex_);
+  for (auto& entry : eviction_callbacks_) {
+    if (entry.tag == tag) {
+      ++entry.refs;
+      return Status::OK();
+    }
+  }
+  eviction_callbacks_.push_back({tag, 1, std::move(callback)});
+  InstallEvictionCallbacks();
+  return Status::OK();
+}
+
+void ShardedCache::RemoveEvictionCallback(const void* tag) {
+  MutexLock l(&capacity_mutex_);
+  for (auto it = eviction_callbacks_.begin(); it != eviction_callbacks_.end();
+       ++it) {
+    if (it->tag == tag) {
+      if (--it->refs == 0) {
+        eviction_callbacks_.erase(it);
+        InstallEvictionCallbacks();
+      }
+      return;
+    }
+  }
+}
+
+void ShardedCache::InstallEvictionCallbacks() {
+  std::shared_ptr<const EvictionCallback> callback;
+  if (eviction_callbacks_.size() == 1) {
+    callback = std::make_shared<const EvictionCallback>(
+        eviction_callbacks_.front().callback);
+  } else if (!eviction_callbacks_.empty()) {
+    std::vector<EvictionCallback> callbacks;
+    for (auto& entry : eviction_callbacks_) {
+      callbacks.push_back(entry.callback);
+    }
+    callback = std::make_shared<const EvictionCallback>(
+        [callbacks](const Slice& key, void* value, size_t charge,
+                    void (*deleter)(const Slice&, void*)) {
+          for (auto& c : callbacks) {
+            c(key, value, charge, deleter);
+          }
+        });
+  }
+  // The shards drop their reference to the previous callback, which is
+  // destroyed once the evictions still running it are done
+  int num_shards = 1 << num_shard_bits_;
+  for (int s = 0; s < num_shards; s++) {
+    GetShard(s)->SetEvictionCallback(callback);
+  }
+}
+
 Status ShardedCache::Insert(const Slice& key, void* value, size_t charge,
                             void (*deleter)(const Slice& key, void* value),
                             Handle** handle, Priority priority) {
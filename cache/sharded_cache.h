@@ -10,11 +10,14 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "port/port.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/terark_namespace.h"
+#include "util/autovector.h"
 #include "util/hash.h"
 
 namespace TERARKDB_NAMESPACE {
@@ -41,6 +44,42 @@ class CacheShard {
                                       bool thread_safe) = 0;
   virtual void EraseUnRefEntries() = 0;
   virtual std::string GetPrintableOptions() const { return ""; }
+
+  // Installs the callback evictions are reported to, a null one disables the
+  // notification. Shards that can report evictions swap it under their mutex.
+  virtual void SetEvictionCallback(
+      std::shared_ptr<const Cache::EvictionCallback> /*callback*/) {}
+
+ protected:
+  using EvictionCallbackPtr = std::shared_ptr<const Cache::EvictionCallback>;
+
+  // Reports the first `num_evicted` entries of `entries` to `callback`, a
+  // copy of eviction_callback_ taken under the shard mutex so it outlives a
+  // concurrent SetEvictionCallback(). Must be called without the shard mutex
+  // held.
+  template <class HandleType>
+  static void NotifyEvicted(const EvictionCallbackPtr& callback,
+                            const autovector<HandleType*>& entries,
+                            size_t num_evicted) {
+    if (callback == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < num_evicted; ++i) {
+      HandleType* e = entries[i];
+      (*callback)(e->key(), e->value, e->charge, e->deleter);
+    }
+  }
+
+  template <class HandleType>
+  static void NotifyEvicted(const EvictionCallbackPtr& callback,
+                            HandleType* e) {
+    if (callback != nullptr) {
+      (*callback)(e->key(), e->value, e->charge, e->deleter);
+    }
+  }
+
+  // Guarded by the shard mutex
+  EvictionCallbackPtr eviction_callback_;
 };
 
 // Generic cache interface which shards cache by hash of keys. 2^num_shard_bits
@@ -79,6 +118,9 @@ class ShardedCache : public Cache {
                                       bool thread_safe) override;
   virtual void EraseUnRefEntries() override;
   virtual std::string GetPrintableOptions() const override;
+  virtual Status AddEvictionCallback(const void* tag,
+                                     EvictionCallback callback) override;
+  virtual void RemoveEvictionCallback(const void* tag) override;
 
   int GetNumShardBits() const { return num_shard_bits_; }
 
@@ -87,6 +129,10 @@ class ShardedCache : public Cache {
     return Hash(s.data(), s.size(), 0);
   }
 
+  // Hands the combination of all registered callbacks to every shard
+  // REQUIRES: capacity_mutex_ held
+  void InstallEvictionCallbacks();
+
   uint32_t Shard(uint32_t hash) {
     // Note, hash >> 32 yields hash in gcc, not the zero we expect!
     return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
@@ -97,6 +143,13 @@ class ShardedCache : public Cache {
   size_t capacity_;
   bool strict_capacity_limit_;
   std::atomic<uint64_t> last_id_;
+  struct EvictionCallbackEntry {
+    const void* tag;
+    size_t refs;
+    EvictionCallback callback;
+  };
+  // Guarded by capacity_mutex_
+  std::vector<EvictionCallbackEntry> eviction_callbacks_;
 };
 
 extern int GetDefaultCacheShardBits(size_t capacity);
@@ -0,0 +1,338 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/background_scheduler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include "rocksdb/terark_namespace.h"
+#include "util/mutexlock.h"
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+// Pools a job may be stolen into, the BOTTOM pool last
+const Env::Priority kPools[] = {Env::Priority::HIGH, Env::Priority::LOW,
+                                Env::Priority::BOTTOM};
+// Weight of a new sample in the compaction rate averages
+const double kRateAlpha = 0.3;
+// Samples at a new limit before it may be lowered again
+const int kMinSamples = 4;
+}  // namespace
+
+const uint64_t BackgroundScheduler::kDefaultStarvationMicros;
+const int BackgroundScheduler::kMaxConcurrency;
+const int BackgroundScheduler::kProbeSamples;
+const double BackgroundScheduler::kMinGain = 0.05;
+
+BackgroundScheduler::BackgroundScheduler(Env* env, bool work_stealing,
+                                         uint64_t starvation_micros)
+    : env_(env),
+      work_stealing_(work_stealing),
+      starvation_micros_(starvation_micros),
+      cv_(&mutex_),
+      outstanding_tokens_(0),
+      compaction_limit_(0),
+      samples_since_change_(0) {
+  for (int i = 0; i < Env::Priority::TOTAL; ++i) {
+    tokens_[i].scheduler = this;
+    tokens_[i].pri = static_cast<Env::Priority>(i);
+    running_[i] = 0;
+  }
+  std::fill(compaction_rate_, compaction_rate_ + kMaxConcurrency + 1, 0.0);
+}
+
+BackgroundScheduler::~BackgroundScheduler() {
+  UnSchedule();
+  MutexLock l(&mutex_);
+  while (outstanding_tokens_ > 0) {
+    cv_.Wait();
+  }
+}
+
+void BackgroundScheduler::Schedule(JobClass job_class,
+                                   void (*function)(void*), void* arg,
+                                   void (*unschedule_function)(void*)) {
+  Env::Priority pri;
+  {
+    MutexLock l(&mutex_);
+    queues_[job_class].push_back(
+        Job{function, arg, unschedule_function, env_->NowMicros()});
+    ++stats_[job_class].queued;
+    ++stats_[job_class].scheduled;
+    pri = PlaceToken(job_class);
+    ++outstanding_tokens_;
+  }
+  SubmitToken(pri);
+}
+
+int BackgroundScheduler::UnSchedule() {
+  std::vector<Job> removed;
+  {
+    MutexLock l(&mutex_);
+    for (int c = 0; c < kNumJobClasses; ++c) {
+      for (auto& job : queues_[c]) {
+        removed.push_back(job);
+      }
+      stats_[c].unscheduled += queues_[c].size();
+      stats_[c].queued = 0;
+      queues_[c].clear();
+    }
+  }
+  // The tokens of the removed jobs would find nothing to run
+  for (auto pri : kPools) {
+    env_->UnSchedule(this, pri);
+  }
+  // Jobs queued in the meantime lost their tokens as well
+  std::vector<Env::Priority> resubmit;
+  {
+    MutexLock l(&mutex_);
+    for (int c = 0; c < kNumJobClasses; ++c) {
+      resubmit.insert(resubmit.end(), queues_[c].size(),
+                      HomePool(static_cast<JobClass>(c)));
+    }
+    outstanding_tokens_ += static_cast<int>(resubmit.size());
+  }
+  for (auto pri : resubmit) {
+    SubmitToken(pri);
+  }
+  for (auto& job : removed) {
+    if (job.unschedule_function != nullptr) {
+      job.unschedule_function(job.arg);
+    }
+  }
+  return static_cast<int>(removed.size());
+}
+
+void BackgroundScheduler::ReportCompaction(int concurrency,
+                                           int max_compactions, uint64_t bytes,
+                                           uint64_t micros) {
+  if (!work_stealing_ || bytes == 0 || micros == 0) {
+    return;
+  }
+  int max_limit = std::min(std::max(max_compactions, 1), kMaxConcurrency);
+  int c = std::min(std::max(concurrency, 1), kMaxConcurrency);
+  double rate = static_cast<double>(bytes) * 1000000 / micros;
+
+  MutexLock l(&mutex_);
+  double& avg = compaction_rate_[c];
+  avg = avg == 0 ? rate : avg * (1 - kRateAlpha) + rate * kRateAlpha;
+  ++samples_since_change_;
+  int limit = compaction_limit_ == 0 ? max_limit
+                                     : std::min(compaction_limit_, max_limit);
+  if (limit >= 2 && samples_since_change_ >= kMinSamples &&
+      compaction_rate_[limit] > 0 && compaction_rate_[limit - 1] > 0 &&
+      limit * compaction_rate_[limit] <
+          (limit - 1) * compaction_rate_[limit - 1] * (1 + kMinGain)) {
+    --limit;
+    samples_since_change_ = 0;
+  } else if (limit < max_limit && samples_since_change_ >= kProbeSamples) {
+    ++limit;
+    samples_since_change_ = 0;
+  }
+  compaction_limit_ = limit;
+}
+
+int BackgroundScheduler::CompactionLimit(int max_compactions) const {
+  MutexLock l(&mutex_);
+  if (compaction_limit_ == 0) {
+    return max_compactions;
+  }
+  return std::max(1, std::min(compaction_limit_, max_compactions));
+}
+
+void BackgroundScheduler::GetStats(JobClass job_class,
+                                   ClassStats* stats) const {
+  MutexLock l(&mutex_);
+  *stats = stats_[job_class];
+}
+
+std::string BackgroundScheduler::ToString() const {
+  MutexLock l(&mutex_);
+  std::string result;
+  char buf[256];
+  snprintf(buf, sizeof(buf), "%-18s %8s %10s %10s %8s %11s %12s %12s\n",
+           "Class", "Queued", "Scheduled", "Run", "Stolen", "Unscheduled",
+           "AvgWait(us)", "MaxWait(us)");
+  result.append(buf);
+  for (int c = 0; c < kNumJobClasses; ++c) {
+    const ClassStats& s = stats_[c];
+    snprintf(buf, sizeof(buf),
+             "%-18s %8" PRIu64 " %10" PRIu64 " %10" PRIu64 " %8" PRIu64
+             " %11" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+             JobClassName(static_cast<JobClass>(c)), s.queued, s.scheduled,
+             s.run, s.stolen, s.unscheduled,
+             s.run == 0 ? 0 : s.total_wait_micros / s.run, s.max_wait_micros);
+    result.append(buf);
+  }
+  snprintf(buf, sizeof(buf), "Work stealing: %s\n",
+           work_stealing_ ? "enabled" : "disabled");
+  result.append(buf);
+  if (compaction_limit_ != 0) {
+    snprintf(buf, sizeof(buf), "Compaction limit: %d\n", compaction_limit_);
+    result.append(buf);
+    for (int c = 1; c <= kMaxConcurrency; ++c) {
+      if (compaction_rate_[c] > 0) {
+        snprintf(buf, sizeof(buf),
+                 "  %d concurrent compactions: %.1f MB/s each\n", c,
+                 compaction_rate_[c] / 1048576.0);
+        result.append(buf);
+      }
+    }
+  }
+  return result;
+}
+
+const char* BackgroundScheduler::JobClassName(JobClass job_class) {
+  switch (job_class) {
+    case kFlush:
+      return "Flush";
+    case kCompaction:
+      return "Compaction";
+    case kGarbageCollection:
+      return "GarbageCollection";
+    case kBottomCompaction:
+      return "BottomCompaction";
+    default:
+      return "Unknown";
+  }
+}
+
+void BackgroundScheduler::RunToken(void* arg) {
+  auto* token = reinterpret_cast<Token*>(arg);
+  token->scheduler->Run(token->pri);
+}
+
+void BackgroundScheduler::UnscheduleToken(void* arg) {
+  auto* token = reinterpret_cast<Token*>(arg);
+  BackgroundScheduler* scheduler = token->scheduler;
+  MutexLock l(&scheduler->mutex_);
+  --scheduler->outstanding_tokens_;
+  scheduler->cv_.SignalAll();
+}
+
+void BackgroundScheduler::Run(Env::Priority pri) {
+  mutex_.Lock();
+  uint64_t now = env_->NowMicros();
+  int c = PickJob(pri, now);
+  if (c < 0) {
+    // Hand the token over to the pool of the first queued job, if any
+    for (int i = 0; i < kNumJobClasses; ++i) {
+      if (!queues_[i].empty()) {
+        Env::Priority home = HomePool(static_cast<JobClass>(i));
+        mutex_.Unlock();
+        SubmitToken(home);
+        return;
+      }
+    }
+    --outstanding_tokens_;
+    cv_.SignalAll();
+    mutex_.Unlock();
+    return;
+  }
+  JobClass job_class = static_cast<JobClass>(c);
+  Job job = queues_[c].front();
+  queues_[c].pop_front();
+  ClassStats& s = stats_[c];
+  uint64_t wait = now > job.enqueue_micros ? now - job.enqueue_micros : 0;
+  --s.queued;
+  ++s.run;
+  s.total_wait_micros += wait;
+  s.max_wait_micros = std::max(s.max_wait_micros, wait);
+  if (pri != HomePool(job_class)) {
+    ++s.stolen;
+  }
+  ++running_[pri];
+  mutex_.Unlock();
+
+  job.function(job.arg);
+
+  // The DB may be closing once the job returned, only the scheduler, which
+  // waits for its tokens, may be touched
+  MutexLock l(&mutex_);
+  --running_[pri];
+  --outstanding_tokens_;
+  cv_.SignalAll();
+}
+
+Env::Priority BackgroundScheduler::HomePool(JobClass job_class) const {
+  switch (job_class) {
+    case kFlush:
+      return env_->GetBackgroundThreads(Env::Priority::HIGH) > 0
+                 ? Env::Priority::HIGH
+                 : Env::Priority::LOW;
+    case kBottomCompaction:
+      return Env::Priority::BOTTOM;
+    default:
+      return Env::Priority::LOW;
+  }
+}
+
+int BackgroundScheduler::IdleThreads(Env::Priority pri,
+                                     bool count_queued) const {
+  int idle = env_->GetBackgroundThreads(pri) - running_[pri];
+  if (count_queued) {
+    idle -= static_cast<int>(env_->GetThreadPoolQueueLen(pri));
+  }
+  return idle;
+}
+
+bool BackgroundScheduler::MayRun(Env::Priority pri, JobClass job_class) const {
+  mutex_.AssertHeld();
+  if (pri == HomePool(job_class)) {
+    return true;
+  }
+  if (!work_stealing_) {
+    return false;
+  }
+  // Other threads of the pool besides the one of this token
+  int reserve = pri == Env::Priority::HIGH && job_class != kFlush ? 1 : 0;
+  return IdleThreads(pri, false /* count_queued */) - 1 >= reserve;
+}
+
+Env::Priority BackgroundScheduler::PlaceToken(JobClass job_class) const {
+  mutex_.AssertHeld();
+  Env::Priority home = HomePool(job_class);
+  if (!work_stealing_ || IdleThreads(home, true /* count_queued */) > 0) {
+    return home;
+  }
+  for (auto pri : kPools) {
+    int reserve = pri == Env::Priority::HIGH && job_class != kFlush ? 1 : 0;
+    if (pri != home && IdleThreads(pri, true /* count_queued */) > reserve) {
+      return pri;
+    }
+  }
+  return home;
+}
+
+int BackgroundScheduler::PickJob(Env::Priority pri, uint64_t now) const {
+  mutex_.AssertHeld();
+  int best = -1;
+  int oldest = -1;
+  for (int c = 0; c < kNumJobClasses; ++c) {
+    if (queues_[c].empty() || !MayRun(pri, static_cast<JobClass>(c))) {
+      continue;
+    }
+    if (best < 0) {
+      best = c;
+    }
+    uint64_t enqueued = queues_[c].front().enqueue_micros;
+    if (now > enqueued && now - enqueued > starvation_micros_ &&
+        (oldest < 0 || enqueued < queues_[oldest].front().enqueue_micros)) {
+      oldest = c;
+    }
+  }
+  return oldest >= 0 ? oldest : best;
+}
+
+void BackgroundScheduler::SubmitToken(Env::Priority pri) {
+  env_->Schedule(&BackgroundScheduler::RunToken, &tokens_[pri], pri, this,
+                 &BackgroundScheduler::UnscheduleToken);
+}
+
+}  // namespace TERARKDB_NAMESPACE
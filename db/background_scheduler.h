@@ -0,0 +1,142 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Runs the flushes, compactions, garbage collections and bottom compactions
+// of one DB on the Env thread pools.
+//
+// Jobs wait in one FIFO queue per class. For every queued job a token is
+// submitted to a thread pool, and a token that gets a thread runs the best
+// job it may run there: the job that waited longest once any job waited more
+// than starvation_micros, otherwise the first job of the highest priority
+// class, flushes first. A job runs on the pool of its class, flushes on the
+// LOW pool when the HIGH pool has no threads.
+//
+// With work stealing, a job whose pool has no idle thread is submitted to a
+// pool that has one, and a token runs jobs of other classes as long as it
+// does not take the last idle HIGH priority thread, which is kept for
+// flushes. A token that finds nothing it may run moves to the pool of the
+// first queued job. Idle threads are estimated from the jobs of this
+// scheduler and the queue length of the pools, so jobs of other DBs sharing
+// the Env are only seen while they are queued.
+//
+// With work stealing, the scheduler also suggests a compaction concurrency:
+// every finished compaction reports its throughput, which is averaged per
+// number of concurrent compactions. When running L compactions moves less
+// than kMinGain more bytes per second than running L - 1, the device is
+// deemed saturated and the limit is lowered, otherwise it is raised again
+// every kProbeSamples compactions to see whether the device keeps up.
+class BackgroundScheduler {
+ public:
+  enum JobClass : int {
+    kFlush = 0,
+    kCompaction,
+    kGarbageCollection,
+    kBottomCompaction,
+    kNumJobClasses,
+  };
+
+  struct ClassStats {
+    // Jobs waiting right now
+    uint64_t queued = 0;
+    uint64_t scheduled = 0;
+    uint64_t run = 0;
+    // Jobs that ran on another pool than the one of their class
+    uint64_t stolen = 0;
+    uint64_t unscheduled = 0;
+    uint64_t total_wait_micros = 0;
+    uint64_t max_wait_micros = 0;
+  };
+
+  static const uint64_t kDefaultStarvationMicros = 10 * 1000 * 1000;
+  static const int kMaxConcurrency = 64;
+  static const int kProbeSamples = 16;
+  static const double kMinGain;
+
+  BackgroundScheduler(Env* env, bool work_stealing,
+                      uint64_t starvation_micros = kDefaultStarvationMicros);
+  // Removes the tokens still queued in the Env and waits for the running ones
+  ~BackgroundScheduler();
+
+  // Queues `function(arg)`. If the job is removed by UnSchedule(),
+  // `unschedule_function(arg)` is called instead, if not null.
+  void Schedule(JobClass job_class, void (*function)(void*), void* arg,
+                void (*unschedule_function)(void*) = nullptr);
+
+  // Removes the jobs that did not start yet, returns their number
+  int UnSchedule();
+
+  // Reports a compaction that read and wrote `bytes` in `micros`, while
+  // `concurrency` compactions including this one were running
+  void ReportCompaction(int concurrency, int max_compactions, uint64_t bytes,
+                        uint64_t micros);
+
+  // Suggested number of concurrent compactions, at most max_compactions
+  int CompactionLimit(int max_compactions) const;
+
+  bool work_stealing() const { return work_stealing_; }
+
+  void GetStats(JobClass job_class, ClassStats* stats) const;
+
+  std::string ToString() const;
+
+  static const char* JobClassName(JobClass job_class);
+
+ private:
+  struct Job {
+    void (*function)(void*);
+    void* arg;
+    void (*unschedule_function)(void*);
+    uint64_t enqueue_micros;
+  };
+  struct Token {
+    BackgroundScheduler* scheduler;
+    Env::Priority pri;
+  };
+
+  static void RunToken(void* arg);
+  static void UnscheduleToken(void* arg);
+
+  void Run(Env::Priority pri);
+
+  // Requires mutex_
+  Env::Priority HomePool(JobClass job_class) const;
+  int IdleThreads(Env::Priority pri, bool count_queued) const;
+  bool MayRun(Env::Priority pri, JobClass job_class) const;
+  Env::Priority PlaceToken(JobClass job_class) const;
+  int PickJob(Env::Priority pri, uint64_t now) const;
+  void SubmitToken(Env::Priority pri);
+
+  Env* env_;
+  const bool work_stealing_;
+  const uint64_t starvation_micros_;
+
+  mutable port::Mutex mutex_;
+  port::CondVar cv_;
+  std::deque<Job> queues_[kNumJobClasses];
+  ClassStats stats_[kNumJobClasses];
+  Token tokens_[Env::Priority::TOTAL];
+  // Jobs of this scheduler running on each pool
+  int running_[Env::Priority::TOTAL];
+  // Tokens submitted to the Env and not yet finished
+  int outstanding_tokens_;
+
+  // Average bytes per second of one compaction, by concurrency
+  double compaction_rate_[kMaxConcurrency + 1];
+  int compaction_limit_;
+  int samples_since_change_;
+};
+
+}  // namespace TERARKDB_NAMESPACE
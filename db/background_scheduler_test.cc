@@ -0,0 +1,319 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#include "db/background_scheduler.h"
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/testharness.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Keeps the scheduled functions in per-pool queues, the test runs them on its
+// own thread with RunOne()
+class ManualPoolEnv : public EnvWrapper {
+ public:
+  ManualPoolEnv() : EnvWrapper(nullptr) {
+    for (int i = 0; i < Env::Priority::TOTAL; ++i) {
+      threads_[i] = 0;
+    }
+  }
+
+  void Schedule(void (*function)(void*), void* arg, Priority pri, void* tag,
+                void (*unschedFunction)(void*)) override {
+    queues_[pri].push_back(Item{function, arg, tag, unschedFunction});
+  }
+
+  int UnSchedule(void* tag, Priority pri) override {
+    int count = 0;
+    std::vector<Item> removed;
+    for (auto it = queues_[pri].begin(); it != queues_[pri].end();) {
+      if (it->tag == tag) {
+        removed.push_back(*it);
+        it = queues_[pri].erase(it);
+        ++count;
+      } else {
+        ++it;
+      }
+    }
+    for (auto& item : removed) {
+      if (item.unschedule_function != nullptr) {
+        item.unschedule_function(item.arg);
+      }
+    }
+    return count;
+  }
+
+  unsigned int GetThreadPoolQueueLen(Priority pri) const override {
+    return static_cast<unsigned int>(queues_[pri].size());
+  }
+
+  int GetBackgroundThreads(Priority pri) override { return threads_[pri]; }
+
+  void SetBackgroundThreads(int num, Priority pri) override {
+    threads_[pri] = num;
+  }
+
+  uint64_t NowMicros() override { return now_micros_; }
+
+  // Runs the first function queued on `pri`, returns false if there is none
+  bool RunOne(Priority pri) {
+    if (queues_[pri].empty()) {
+      return false;
+    }
+    Item item = queues_[pri].front();
+    queues_[pri].pop_front();
+    item.function(item.arg);
+    return true;
+  }
+
+  uint64_t now_micros_ = 0;
+
+ private:
+  struct Item {
+    void (*function)(void*);
+    void* arg;
+    void* tag;
+    void (*unschedule_function)(void*);
+  };
+
+  std::deque<Item> queues_[Env::Priority::TOTAL];
+  int threads_[Env::Priority::TOTAL];
+};
+
+class BackgroundSchedulerTest : public testing::Test {
+ public:
+  // Job whose function runs `body` and logs `name`
+  struct Job {
+    BackgroundSchedulerTest* test;
+    std::string name;
+    std::function<void()> body;
+  };
+
+  static void RunJob(void* arg) {
+    auto* job = reinterpret_cast<Job*>(arg);
+    job->test->log_.push_back(job->name);
+    if (job->body) {
+      job->body();
+    }
+  }
+
+  static void UnscheduleJob(void* arg) {
+    auto* job = reinterpret_cast<Job*>(arg);
+    job->test->log_.push_back("unscheduled " + job->name);
+  }
+
+  Job* NewJob(const std::string& name, std::function<void()> body = nullptr) {
+    jobs_.emplace_back(new Job{this, name, std::move(body)});
+    return jobs_.back().get();
+  }
+
+  void Schedule(BackgroundScheduler* scheduler,
+                BackgroundScheduler::JobClass job_class, Job* job) {
+    scheduler->Schedule(job_class, &RunJob, job, &UnscheduleJob);
+  }
+
+  ManualPoolEnv env_;
+  std::vector<std::string> log_;
+  std::vector<std::unique_ptr<Job>> jobs_;
+};
+
+TEST_F(BackgroundSchedulerTest, PriorityOrder) {
+  // No HIGH priority threads, flushes share the LOW pool
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  BackgroundScheduler scheduler(&env_, false /* work_stealing */);
+  Schedule(&scheduler, BackgroundScheduler::kGarbageCollection, NewJob("gc"));
+  Schedule(&scheduler, BackgroundScheduler::kCompaction,
+           NewJob("compaction"));
+  env_.now_micros_ = 10;
+  Schedule(&scheduler, BackgroundScheduler::kFlush, NewJob("flush"));
+  ASSERT_EQ(3U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+
+  env_.now_micros_ = 100;
+  while (env_.RunOne(Env::Priority::LOW)) {
+  }
+  ASSERT_EQ((std::vector<std::string>{"flush", "compaction", "gc"}), log_);
+
+  BackgroundScheduler::ClassStats stats;
+  scheduler.GetStats(BackgroundScheduler::kFlush, &stats);
+  ASSERT_EQ(0U, stats.queued);
+  ASSERT_EQ(1U, stats.scheduled);
+  ASSERT_EQ(1U, stats.run);
+  ASSERT_EQ(0U, stats.stolen);
+  ASSERT_EQ(90U, stats.max_wait_micros);
+  scheduler.GetStats(BackgroundScheduler::kGarbageCollection, &stats);
+  ASSERT_EQ(100U, stats.total_wait_micros);
+  ASSERT_NE(std::string::npos, scheduler.ToString().find("GarbageCollection"));
+}
+
+TEST_F(BackgroundSchedulerTest, StarvationControl) {
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  BackgroundScheduler scheduler(&env_, false /* work_stealing */,
+                                100 /* starvation_micros */);
+  Schedule(&scheduler, BackgroundScheduler::kGarbageCollection, NewJob("gc"));
+  env_.now_micros_ = 50;
+  Schedule(&scheduler, BackgroundScheduler::kCompaction,
+           NewJob("compaction"));
+  Schedule(&scheduler, BackgroundScheduler::kFlush, NewJob("flush"));
+
+  // Nobody waited too long yet
+  env_.now_micros_ = 60;
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ("flush", log_.back());
+  // Both did, the garbage collection longer
+  env_.now_micros_ = 200;
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ("gc", log_.back());
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ("compaction", log_.back());
+  ASSERT_FALSE(env_.RunOne(Env::Priority::LOW));
+}
+
+TEST_F(BackgroundSchedulerTest, NoStealingByDefault) {
+  env_.SetBackgroundThreads(2, Env::Priority::HIGH);
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  BackgroundScheduler scheduler(&env_, false /* work_stealing */);
+  Schedule(&scheduler, BackgroundScheduler::kCompaction,
+           NewJob("compaction1", [&]() {
+             Schedule(&scheduler, BackgroundScheduler::kCompaction,
+                      NewJob("compaction2"));
+           }));
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  // The LOW pool was busy, the HIGH pool idle
+  ASSERT_EQ(0U, env_.GetThreadPoolQueueLen(Env::Priority::HIGH));
+  ASSERT_EQ(1U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ((std::vector<std::string>{"compaction1", "compaction2"}), log_);
+}
+
+TEST_F(BackgroundSchedulerTest, WorkStealing) {
+  env_.SetBackgroundThreads(2, Env::Priority::HIGH);
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  BackgroundScheduler scheduler(&env_, true /* work_stealing */);
+  Schedule(&scheduler, BackgroundScheduler::kCompaction,
+           NewJob("compaction1", [&]() {
+             Schedule(&scheduler, BackgroundScheduler::kCompaction,
+                      NewJob("compaction2"));
+             ASSERT_EQ(1U, env_.GetThreadPoolQueueLen(Env::Priority::HIGH));
+             // Runs next to this one on a HIGH priority thread
+             ASSERT_TRUE(env_.RunOne(Env::Priority::HIGH));
+           }));
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ((std::vector<std::string>{"compaction1", "compaction2"}), log_);
+
+  BackgroundScheduler::ClassStats stats;
+  scheduler.GetStats(BackgroundScheduler::kCompaction, &stats);
+  ASSERT_EQ(2U, stats.run);
+  ASSERT_EQ(1U, stats.stolen);
+}
+
+TEST_F(BackgroundSchedulerTest, LastHighPriorityThreadKeptForFlushes) {
+  env_.SetBackgroundThreads(1, Env::Priority::HIGH);
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  BackgroundScheduler scheduler(&env_, true /* work_stealing */);
+  Schedule(&scheduler, BackgroundScheduler::kCompaction,
+           NewJob("compaction1", [&]() {
+             Schedule(&scheduler, BackgroundScheduler::kCompaction,
+                      NewJob("compaction2"));
+             ASSERT_EQ(0U, env_.GetThreadPoolQueueLen(Env::Priority::HIGH));
+             Schedule(&scheduler, BackgroundScheduler::kFlush,
+                      NewJob("flush"));
+           }));
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ(1U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_EQ(1U, env_.GetThreadPoolQueueLen(Env::Priority::HIGH));
+  // The idle LOW priority thread runs the flush first
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ("flush", log_.back());
+  // The token of the flush may not run the compaction and moves to the LOW
+  // pool
+  ASSERT_TRUE(env_.RunOne(Env::Priority::HIGH));
+  ASSERT_EQ(2U, log_.size());
+  ASSERT_EQ(1U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_EQ("compaction2", log_.back());
+  ASSERT_FALSE(env_.RunOne(Env::Priority::LOW));
+  ASSERT_FALSE(env_.RunOne(Env::Priority::HIGH));
+
+  BackgroundScheduler::ClassStats stats;
+  scheduler.GetStats(BackgroundScheduler::kFlush, &stats);
+  ASSERT_EQ(1U, stats.stolen);
+}
+
+TEST_F(BackgroundSchedulerTest, UnSchedule) {
+  env_.SetBackgroundThreads(1, Env::Priority::HIGH);
+  env_.SetBackgroundThreads(1, Env::Priority::LOW);
+  {
+    BackgroundScheduler scheduler(&env_, false /* work_stealing */);
+    Schedule(&scheduler, BackgroundScheduler::kFlush, NewJob("flush"));
+    Schedule(&scheduler, BackgroundScheduler::kCompaction,
+             NewJob("compaction"));
+    ASSERT_EQ(2, scheduler.UnSchedule());
+    ASSERT_EQ((std::vector<std::string>{"unscheduled flush",
+                                        "unscheduled compaction"}),
+              log_);
+    ASSERT_EQ(0U, env_.GetThreadPoolQueueLen(Env::Priority::HIGH));
+    ASSERT_EQ(0U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+
+    // Still usable afterwards
+    Schedule(&scheduler, BackgroundScheduler::kCompaction,
+             NewJob("compaction"));
+    ASSERT_TRUE(env_.RunOne(Env::Priority::LOW));
+    ASSERT_EQ("compaction", log_.back());
+
+    BackgroundScheduler::ClassStats stats;
+    scheduler.GetStats(BackgroundScheduler::kCompaction, &stats);
+    ASSERT_EQ(2U, stats.scheduled);
+    ASSERT_EQ(1U, stats.unscheduled);
+    ASSERT_EQ(1U, stats.run);
+
+    // The destructor removes the tokens left in the pools
+    Schedule(&scheduler, BackgroundScheduler::kGarbageCollection,
+             NewJob("gc"));
+  }
+  ASSERT_EQ(0U, env_.GetThreadPoolQueueLen(Env::Priority::LOW));
+  ASSERT_EQ("unscheduled gc", log_.back());
+}
+
+TEST_F(BackgroundSchedulerTest, CompactionLimit) {
+  const uint64_t kMB = 1 << 20;
+  BackgroundScheduler fixed(&env_, false /* work_stealing */);
+  fixed.ReportCompaction(4, 4, 100 * kMB, 1000000);
+  ASSERT_EQ(4, fixed.CompactionLimit(4));
+
+  BackgroundScheduler scheduler(&env_, true /* work_stealing */);
+  ASSERT_EQ(4, scheduler.CompactionLimit(4));
+  // Three compactions move 100MB/s, so do four
+  for (int i = 0; i < 4; ++i) {
+    scheduler.ReportCompaction(3, 4, 100 * kMB / 3, 1000000);
+  }
+  ASSERT_EQ(4, scheduler.CompactionLimit(4));
+  scheduler.ReportCompaction(4, 4, 100 * kMB / 4, 1000000);
+  ASSERT_EQ(3, scheduler.CompactionLimit(4));
+  ASSERT_EQ(2, scheduler.CompactionLimit(2));
+
+  // Faster at three now, but nothing is known about two, so the limit stays
+  // until the next probe
+  for (int i = 0; i < BackgroundScheduler::kProbeSamples - 1; ++i) {
+    scheduler.ReportCompaction(3, 4, 60 * kMB, 1000000);
+    ASSERT_EQ(3, scheduler.CompactionLimit(4));
+  }
+  scheduler.ReportCompaction(3, 4, 60 * kMB, 1000000);
+  ASSERT_EQ(4, scheduler.CompactionLimit(4));
+  ASSERT_NE(std::string::npos,
+            scheduler.ToString().find("Compaction limit: 4"));
+}
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -555,6 +555,7 @@ void ColumnFamilyData::SetDropped() {
   assert(id_ != 0);
   dropped_ = true;
   write_controller_token_.reset();
+  column_family_set_->write_controller_->RemoveWriteDebt(id_);
 
   // remove from column_family_set
   column_family_set_->RemoveColumnFamily(this);
@@ -731,6 +732,63 @@ ColumnFamilyData::GetWriteStallConditionAndCause(
   return {WriteStallCondition::kNormal, WriteStallCause::kNone};
 }
 
+WriteDebt ColumnFamilyData::EstimateWriteDebt(
+    const MutableCFOptions& mutable_cf_options) {
+  // 0 at `begin`, 1 at `end`
+  auto ramp = [](double x, double begin, double end) {
+    if (end <= begin) {
+      return x >= end ? 1.0 : 0.0;
+    }
+    return std::max(0.0, (x - begin) / (end - begin));
+  };
+  WriteDebt debt;
+  if (current_ == nullptr) {
+    return debt;
+  }
+  auto* vstorage = current_->storage_info();
+  debt.flush_bytes = imm()->ApproximateUnflushedMemTablesMemoryUsage();
+  debt.compaction_bytes = vstorage->estimated_compaction_needed_bytes();
+  for (auto f : vstorage->LevelFiles(-1)) {
+    if (!f->is_gc_permitted() || f->prop.num_entries == 0) {
+      continue;
+    }
+    double garbage_ratio = std::min(
+        1.0, static_cast<double>(f->num_antiquation) / f->prop.num_entries);
+    if (garbage_ratio >= mutable_cf_options.blob_gc_ratio) {
+      debt.gc_bytes +=
+          static_cast<uint64_t>(f->fd.GetFileSize() * garbage_ratio);
+    }
+  }
+
+  int max_write_buffer_number = mutable_cf_options.max_write_buffer_number;
+  debt.pressure = ramp(imm()->NumNotFlushed(), max_write_buffer_number / 2,
+                       max_write_buffer_number);
+  if (!mutable_cf_options.disable_auto_compactions) {
+    int l0_speedup = GetL0ThresholdSpeedupCompaction(
+        mutable_cf_options.level0_file_num_compaction_trigger,
+        mutable_cf_options.level0_slowdown_writes_trigger);
+    int stop = mutable_cf_options.level0_stop_writes_trigger;
+    debt.pressure = std::max(
+        debt.pressure, ramp(vstorage->l0_delay_trigger_count(), l0_speedup,
+                            stop));
+    // Map SSTs and overlapping files add read amplification that has to be
+    // compacted away
+    debt.pressure = std::max(
+        debt.pressure,
+        ramp(vstorage->read_amplification() - ioptions_.num_levels,
+             l0_speedup, stop));
+    // Garbage collection rewrites like a compaction does
+    if (mutable_cf_options.hard_pending_compaction_bytes_limit > 0) {
+      debt.pressure = std::max(
+          debt.pressure,
+          ramp(static_cast<double>(debt.total_bytes()),
+               mutable_cf_options.soft_pending_compaction_bytes_limit / 4.0,
+               mutable_cf_options.hard_pending_compaction_bytes_limit));
+    }
+  }
+  return debt;
+}
+
 WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     const MutableCFOptions& mutable_cf_options) {
   auto write_stall_condition = WriteStallCondition::kNormal;
@@ -751,8 +809,61 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     bool was_stopped = write_controller->IsStopped();
     bool needed_delay = write_controller->NeedsDelay();
 
-    if (write_stall_condition == WriteStallCondition::kStopped &&
-        write_stall_cause == WriteStallCause::kMemtableLimit) {
+    WriteDebt debt;
+    uint64_t write_rate = 0;
+    if (write_controller->feedback_control()) {
+      debt = EstimateWriteDebt(mutable_cf_options);
+      write_rate = write_controller->UpdateWriteDebt(
+          id_, debt, ioptions_.env->NowMicros());
+    }
+
+    if (write_controller->feedback_control() &&
+        write_stall_condition != WriteStallCondition::kStopped) {
+      // Stops stay as they are, the feedback loop sets the rate otherwise
+      if (write_rate < write_controller->max_delayed_write_rate()) {
+        write_controller_token_ = write_controller->GetDelayToken(write_rate);
+        // Same as after a delay, low-pri writes get a quarter of the rate
+        write_controller->low_pri_rate_limiter()->SetBytesPerSecond(
+            write_rate / 4);
+      } else if (debt.pressure > 0) {
+        write_controller_token_ =
+            write_controller->GetCompactionPressureToken();
+      } else {
+        write_controller_token_.reset();
+      }
+      if (write_stall_condition == WriteStallCondition::kDelayed) {
+        switch (write_stall_cause) {
+          case WriteStallCause::kMemtableLimit:
+            internal_stats_->AddCFStats(
+                InternalStats::MEMTABLE_LIMIT_SLOWDOWNS, 1);
+            break;
+          case WriteStallCause::kL0FileCountLimit:
+            internal_stats_->AddCFStats(
+                InternalStats::L0_FILE_COUNT_LIMIT_SLOWDOWNS, 1);
+            break;
+          case WriteStallCause::kPendingCompactionBytes:
+            internal_stats_->AddCFStats(
+                InternalStats::PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS, 1);
+            break;
+          case WriteStallCause::kReadAmpLimit:
+            internal_stats_->AddCFStats(
+                InternalStats::READ_AMP_LIMIT_SLOWDOWNS, 1);
+            break;
+          default:
+            break;
+        }
+      }
+      if (write_rate != write_controller->max_delayed_write_rate() ||
+          needed_delay) {
+        ROCKS_LOG_INFO(
+            ioptions_.info_log,
+            "[%s] Write pressure %.3f, debt %" PRIu64 " bytes (gc %" PRIu64
+            "), write rate %" PRIu64,
+            name_.c_str(), debt.pressure, debt.total_bytes(), debt.gc_bytes,
+            write_rate);
+      }
+    } else if (write_stall_condition == WriteStallCondition::kStopped &&
+               write_stall_cause == WriteStallCause::kMemtableLimit) {
       write_controller_token_ = write_controller->GetStopToken();
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_LIMIT_STOPS, 1);
       ROCKS_LOG_WARN(
@@ -1025,7 +1136,9 @@ Status ColumnFamilyData::RangesOverlapWithMemtables(
   Arena arena;
   ReadOptions read_opts;
   read_opts.total_order_seek = true;
-  MergeIteratorBuilder merge_iter_builder(&internal_comparator_, &arena);
+  MergeIteratorBuilder merge_iter_builder(
+      &internal_comparator_, &arena, false /* prefix_seek_mode */,
+      ioptions_.use_loser_tree_merging_iterator);
   merge_iter_builder.AddIterator(
       super_version->mem->NewIterator(read_opts, &arena));
   super_version->imm->AddIterators(read_opts, &merge_iter_builder);
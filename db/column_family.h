@@ -405,6 +405,10 @@ class ColumnFamilyData {
   WriteStallCondition RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options);
 
+  // Flush, compaction and blob garbage collection debt, and how close it
+  // brings the column family to a write stop
+  WriteDebt EstimateWriteDebt(const MutableCFOptions& mutable_cf_options);
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -0,0 +1,195 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include <map>
+
+#include "db/db_impl.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/columnar_table_factory.h"
+#include "util/coding.h"
+#include "util/string_util.h"
+#include "util/testharness.h"
+#include "util/testutil.h"
+
+namespace TERARKDB_NAMESPACE {
+
+class ColumnarTableDBTest : public testing::Test {
+ private:
+  std::string dbname_;
+  DB* db_;
+
+ public:
+  ColumnarTableDBTest() {
+    dbname_ = test::PerThreadDBPath("columnar_table_db_test");
+    EXPECT_OK(DestroyDB(dbname_, Options()));
+    db_ = nullptr;
+    Reopen();
+  }
+
+  ~ColumnarTableDBTest() {
+    delete db_;
+    EXPECT_OK(DestroyDB(dbname_, Options()));
+  }
+
+  // A 4 byte counter, a short name and a free form tail
+  Options CurrentOptions() {
+    ColumnarTableOptions table_options;
+    table_options.block_rows = 64;
+    ColumnarTableColumn id;
+    id.type = ColumnarTableColumn::kFixedLength;
+    id.encoding = ColumnarTableColumn::kRleVarint;
+    id.size = 4;
+    table_options.columns.push_back(id);
+    ColumnarTableColumn name;
+    name.type = ColumnarTableColumn::kVariableLength;
+    table_options.columns.push_back(name);
+
+    Options options;
+    options.table_factory.reset(NewColumnarTableFactory(table_options));
+    options.create_if_missing = true;
+    return options;
+  }
+
+  DBImpl* dbfull() { return reinterpret_cast<DBImpl*>(db_); }
+
+  void Reopen() {
+    delete db_;
+    db_ = nullptr;
+    ASSERT_OK(DB::Open(CurrentOptions(), dbname_, &db_));
+  }
+
+  static std::string MakeValue(uint32_t id, const std::string& name,
+                               const std::string& tail) {
+    std::string value;
+    PutFixed32(&value, id);
+    value.push_back(static_cast<char>(name.size()));
+    value.append(name);
+    value.append(tail);
+    return value;
+  }
+
+  // Write `n` keys, every 7th is deleted and every 11th is too short to be
+  // split into columns, then flush
+  void Fill(int n, std::map<std::string, std::string>* expected) {
+    for (int i = 0; i < n; ++i) {
+      std::string key = "key" + ToString(100000 + i);
+      std::string value = i % 11 == 0
+                              ? std::string("x")
+                              : MakeValue(i / 10, "name" + ToString(i),
+                                          "tail" + ToString(i * 3));
+      ASSERT_OK(db_->Put(WriteOptions(), key, value));
+      (*expected)[key] = value;
+    }
+    for (int i = 0; i < n; i += 7) {
+      std::string key = "key" + ToString(100000 + i);
+      ASSERT_OK(db_->Delete(WriteOptions(), key));
+      expected->erase(key);
+    }
+    ASSERT_OK(dbfull()->TEST_FlushMemTable());
+  }
+
+  void Verify(const std::map<std::string, std::string>& expected) {
+    for (auto& kv : expected) {
+      std::string value;
+      ASSERT_OK(db_->Get(ReadOptions(), kv.first, &value));
+      ASSERT_EQ(kv.second, value);
+    }
+    std::string value;
+    ASSERT_TRUE(
+        db_->Get(ReadOptions(), "key" + ToString(100000), &value).IsNotFound());
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_TRUE(it != expected.end());
+      ASSERT_EQ(it->first, iter->key().ToString());
+      ASSERT_EQ(it->second, iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(it == expected.end());
+
+    auto rit = expected.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+      ASSERT_TRUE(rit != expected.rend());
+      ASSERT_EQ(rit->first, iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(rit == expected.rend());
+
+    iter->Seek("key100500");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(expected.lower_bound("key100500")->first,
+              iter->key().ToString());
+  }
+
+  DB* db() { return db_; }
+};
+
+TEST_F(ColumnarTableDBTest, FlushAndCompact) {
+  std::map<std::string, std::string> expected;
+  Fill(1000, &expected);
+  Verify(expected);
+
+  ASSERT_OK(db()->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Verify(expected);
+
+  Reopen();
+  Verify(expected);
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db()->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1U, props.size());
+  auto& user_props = props.begin()->second->user_collected_properties;
+  ASSERT_TRUE(user_props.count(ColumnarTablePropertyNames::kColumns) > 0);
+  ASSERT_GT(props.begin()->second->num_data_blocks, 1U);
+}
+
+TEST_F(ColumnarTableDBTest, ColumnMask) {
+  std::map<std::string, std::string> expected;
+  Fill(300, &expected);
+
+  // Leave out the counter and the tail, only the name is decoded
+  ReadOptions read_options;
+  read_options.column_mask = uint64_t(1) << 1;
+  std::unique_ptr<Iterator> iter(db()->NewIterator(read_options));
+  auto it = expected.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+    ASSERT_TRUE(it != expected.end());
+    ASSERT_EQ(it->first, iter->key().ToString());
+    if (it->second == "x") {
+      // Stored whole, always read
+      ASSERT_EQ("x", iter->value().ToString());
+      continue;
+    }
+    Slice full(it->second);
+    size_t name_size = 1 + static_cast<uint8_t>(full[4]);
+    ASSERT_EQ(std::string(4, '\0') + full.ToString().substr(4, name_size),
+              iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_TRUE(it == expected.end());
+}
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else
+#include <stdio.h>
+
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr,
+          "SKIPPED as Columnar table is not supported in ROCKSDB_LITE\n");
+  return 0;
+}
+
+#endif  // ROCKSDB_LITE
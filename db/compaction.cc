@@ -210,6 +210,10 @@ void ProcessFileMetaData(const char* job_info, FileMetaData* meta,
     GetCompactionTimePoint(tp->user_collected_properties,
                            &meta->prop.earliest_time_begin_compact,
                            &meta->prop.latest_time_end_compact);
+    meta->prop.latest_time_expire =
+        GetLatestTimeExpire(tp->user_collected_properties);
+    meta->prop.earliest_time_expire =
+        GetEarliestTimeExpire(tp->user_collected_properties);
     ROCKS_LOG_INFO(iopt->info_log,
                    "%s earliest_time_begin_compact = %" PRIu64
                    ", latest_time_end_compact = %" PRIu64,
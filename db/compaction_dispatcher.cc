@@ -683,7 +683,9 @@ std::string RemoteCompactionDispatcher::Worker::DoCompaction(Slice data) {
 
   Arena arena;
   auto create_input_iterator = [&]() -> InternalIterator* {
-    MergeIteratorBuilder merge_iter_builder(icmp, &arena);
+    MergeIteratorBuilder merge_iter_builder(
+        icmp, &arena, false /* prefix_seek_mode */,
+        immutable_cf_options.use_loser_tree_merging_iterator);
     for (auto& pair : inputs) {
       if (pair.first == 0 || pair.second.size() == 1) {
         merge_iter_builder.AddIterator(new_iterator(
@@ -158,6 +158,7 @@ CompactionIterator::CompactionIterator(
       shutting_down_(shutting_down),
       preserve_deletes_seqnum_(preserve_deletes_seqnum),
       ignore_snapshots_(false),
+      cached_stripe_index_(0),
       current_user_key_sequence_(0),
       current_user_key_snapshot_(0),
       merge_out_iter_(merge_helper_),
@@ -190,6 +191,7 @@ CompactionIterator::CompactionIterator(
     if (compaction_filter_->IgnoreSnapshots()) {
       ignore_snapshots_ = true;
     }
+    filter_value_meta_only_ = compaction_filter_->IsValueMetaOnly();
   } else {
     ignore_snapshots_ = false;
   }
@@ -284,10 +286,14 @@ void CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
     CompactionFilter::Decision filter;
     compaction_filter_value_.clear();
     compaction_filter_skip_until_.Clear();
+    const LazyBuffer& existing_value =
+        ikey_.type == kTypeValueIndex && filter_value_meta_only_
+            ? MergeHelper::MetaOnlyFilterValue()
+            : value_;
     auto doFilter = [&]() {
       filter = compaction_filter_->FilterV2(
           compaction_->level(), ikey_.user_key,
-          CompactionFilter::ValueType::kValue, value_meta_, value_,
+          CompactionFilter::ValueType::kValue, value_meta_, existing_value,
           &compaction_filter_value_, compaction_filter_skip_until_.rep());
     };
     auto sample = filter_sample_interval_;
@@ -716,7 +722,7 @@ void CompactionIterator::NextFromInput() {
       // 1. new user key -OR-
       // 2. different snapshot stripe
       bool should_delete = range_del_agg_->ShouldDelete(
-          key_, RangeDelPositioningMode::kForwardTraversal);
+          ikey_, RangeDelPositioningMode::kForwardTraversal);
       if (should_delete) {
         ++iter_stats_.num_record_drop_hidden;
         ++iter_stats_.num_record_drop_range_del;
@@ -858,15 +864,25 @@ void CompactionIterator::PrepareOutput() {
 inline SequenceNumber CompactionIterator::findEarliestVisibleSnapshot(
     SequenceNumber in, SequenceNumber* prev_snapshot) {
   assert(snapshots_->size());
+  auto& snapshots = *snapshots_;
+  if (snapshot_checker_ == nullptr) {
+    size_t i = cached_stripe_index_;
+    if ((i == 0 || snapshots[i - 1] < in) &&
+        (i == snapshots.size() || in <= snapshots[i])) {
+      *prev_snapshot = i == 0 ? 0 : snapshots[i - 1];
+      return i == snapshots.size() ? kMaxSequenceNumber : snapshots[i];
+    }
+  }
   auto snapshots_iter =
-      std::lower_bound(snapshots_->begin(), snapshots_->end(), in);
-  if (snapshots_iter == snapshots_->begin()) {
+      std::lower_bound(snapshots.begin(), snapshots.end(), in);
+  cached_stripe_index_ = snapshots_iter - snapshots.begin();
+  if (snapshots_iter == snapshots.begin()) {
     *prev_snapshot = 0;
   } else {
     *prev_snapshot = *std::prev(snapshots_iter);
     assert(*prev_snapshot < in);
   }
-  for (; snapshots_iter != snapshots_->end(); ++snapshots_iter) {
+  for (; snapshots_iter != snapshots.end(); ++snapshots_iter) {
     auto cur = *snapshots_iter;
     assert(in <= cur);
     if (snapshot_checker_ == nullptr ||
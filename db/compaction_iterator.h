@@ -136,8 +136,8 @@ class CompactionIterator {
   // earliest snapshot that this sequence number is visible in.
   // The snapshots themselves are arranged in ascending order of
   // sequence numbers.
-  // Employ a sequential search because the total number of
-  // snapshots are typically small.
+  // Consecutive input keys usually fall into the same snapshot stripe, so
+  // the stripe of the last lookup is checked before searching.
   inline SequenceNumber findEarliestVisibleSnapshot(
       SequenceNumber in, SequenceNumber* prev_snapshot);
 
@@ -169,6 +169,10 @@ class CompactionIterator {
   SequenceNumber earliest_snapshot_;
   SequenceNumber latest_snapshot_;
   bool ignore_snapshots_;
+  bool filter_value_meta_only_ = false;
+  // Index into snapshots_ of the earliest snapshot found by the last
+  // findEarliestVisibleSnapshot, snapshots_->size() if there was none
+  size_t cached_stripe_index_;
 
   // State
   //
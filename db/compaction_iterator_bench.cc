@@ -0,0 +1,151 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "db/compaction_iterator.h"
+#include "db/dbformat.h"
+#include "db/merge_helper.h"
+#include "db/range_del_aggregator.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/coding.h"
+#include "util/gflags_compat.h"
+#include "util/random.h"
+#include "util/stop_watch.h"
+#include "util/testutil.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+
+DEFINE_int32(num_keys, 1000000, "number of distinct user keys");
+
+DEFINE_int32(versions_per_key, 1, "number of versions of each user key");
+
+DEFINE_int32(key_size, 16, "size of each user key");
+
+DEFINE_int32(value_size, 16, "size of each value");
+
+DEFINE_int32(num_snapshots, 0,
+             "number of snapshots spread evenly over the sequence range");
+
+DEFINE_int32(num_runs, 10, "number of test runs");
+
+DEFINE_int32(seed, 0, "random number generator seed");
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+// Big-endian, zero padded to FLAGS_key_size so bytewise order is numeric
+std::string UserKey(uint64_t val) {
+  std::string key(std::max(FLAGS_key_size, 8), '\0');
+  for (size_t i = 0; i < 8; ++i) {
+    key[key.size() - 1 - i] = static_cast<char>(val >> (i * 8));
+  }
+  return key;
+}
+
+}  // anonymous namespace
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  using namespace TERARKDB_NAMESPACE;
+
+  const InternalKeyComparator icmp(BytewiseComparator());
+  const uint64_t num_entries =
+      static_cast<uint64_t>(FLAGS_num_keys) * FLAGS_versions_per_key;
+  const SequenceNumber max_seq = num_entries;
+
+  // Internal keys in iteration order, versions of a key newest first
+  Random64 rnd(FLAGS_seed);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  keys.reserve(num_entries);
+  values.reserve(num_entries);
+  // Distinct sequence numbers per key, Floyd's sampling without replacement
+  std::set<SequenceNumber, std::greater<SequenceNumber>> seqs;
+  for (int i = 0; i < FLAGS_num_keys; ++i) {
+    std::string user_key = UserKey(i);
+    seqs.clear();
+    for (SequenceNumber j = max_seq - FLAGS_versions_per_key + 1; j <= max_seq;
+         ++j) {
+      SequenceNumber seq = rnd.Uniform(j) + 1;
+      if (!seqs.insert(seq).second) {
+        seqs.insert(j);
+      }
+    }
+    for (auto seq : seqs) {
+      keys.emplace_back(
+          InternalKey(user_key, seq, kTypeValue).Encode().ToString());
+      values.emplace_back(FLAGS_value_size, 'v');
+    }
+  }
+
+  std::vector<SequenceNumber> snapshots;
+  for (int i = 1; i <= FLAGS_num_snapshots; ++i) {
+    snapshots.push_back(max_seq * i / (FLAGS_num_snapshots + 1));
+  }
+
+  std::atomic<bool> shutting_down{false};
+  uint64_t total_nanos = 0;
+  uint64_t num_output = 0;
+  for (int run = 0; run < FLAGS_num_runs; ++run) {
+    test::VectorIterator input(keys, values);
+    MergeHelper merge_helper(Env::Default(), icmp.user_comparator(),
+                             nullptr /* merge_operator */,
+                             nullptr /* compaction_filter */, nullptr, false,
+                             0 /* latest_snapshot */, nullptr, 0, nullptr,
+                             &shutting_down);
+    CompactionRangeDelAggregator range_del_agg(&icmp, snapshots);
+    input.SeekToFirst();
+    CompactionIterator c_iter(
+        &input, nullptr /* separate_helper */, nullptr /* end */,
+        icmp.user_comparator(), &merge_helper, kMaxSequenceNumber, &snapshots,
+        kMaxSequenceNumber, nullptr /* snapshot_checker */, Env::Default(),
+        false /* report_detailed_time */, false, &range_del_agg,
+        std::unique_ptr<CompactionIterator::CompactionProxy>(),
+        BlobConfig{size_t(-1), 0.0}, nullptr /* compaction_filter */,
+        &shutting_down);
+
+    StopWatchNano timer(Env::Default(), true /* auto_start */);
+    for (c_iter.SeekToFirst(); c_iter.Valid(); c_iter.Next()) {
+      ++num_output;
+    }
+    total_nanos += timer.ElapsedNanos();
+  }
+
+  std::cout << std::left << std::setw(25) << "Input entries: " << num_entries
+            << "\n"
+            << std::setw(25) << "Output entries: "
+            << num_output / std::max(FLAGS_num_runs, 1) << "\n"
+            << std::setw(25) << "Snapshots: " << snapshots.size() << "\n"
+            << std::setw(25) << "Time per input entry: "
+            << total_nanos /
+                   (std::max<uint64_t>(num_entries, 1) *
+                    std::max(FLAGS_num_runs, 1) * 1.0)
+            << " ns\n";
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -1197,6 +1197,10 @@ Status CompactionJob::Run() {
                 tp->user_collected_properties,
                 &output.meta.prop.earliest_time_begin_compact,
                 &output.meta.prop.latest_time_end_compact);
+            output.meta.prop.latest_time_expire =
+                GetLatestTimeExpire(tp->user_collected_properties);
+            output.meta.prop.earliest_time_expire =
+                GetEarliestTimeExpire(tp->user_collected_properties);
             ROCKS_LOG_INFO(
                 db_options_.info_log,
                 "CompactionOutput earliest_time_begin_compact = %" PRIu64
@@ -1594,9 +1598,13 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       snapshot_checker_, compact_->compaction->level(),
       db_options_.statistics.get(), shutting_down_);
 
-  struct BuilderSeparateHelper : public SeparateHelper {
-    SeparateHelper* separate_helper = nullptr;
+  struct BuilderSeparateHelper : public SeparateHelper,
+                                 public LazyBufferState {
+    Version* separate_helper = nullptr;
     std::unique_ptr<ValueExtractor> value_meta_extractor;
+    // Separated values read back from blob files by this sub compaction
+    mutable uint64_t num_blob_fetches = 0;
+    mutable uint64_t total_blob_fetch_bytes = 0;
     Status (*trans_to_separate_callback)(void* args, const Slice& key,
                                          LazyBuffer& value) = nullptr;
     void* trans_to_separate_callback_args = nullptr;
@@ -1619,7 +1627,22 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
 
     LazyBuffer TransToCombined(const Slice& user_key, uint64_t sequence,
                                const LazyBuffer& value) const override {
-      return separate_helper->TransToCombined(user_key, sequence, value);
+      return separate_helper->TransToCombined(user_key, sequence, value, this);
+    }
+
+    void destroy(LazyBuffer* /*buffer*/) const override {}
+
+    Status pin_buffer(LazyBuffer* /*buffer*/) const override {
+      return Status::OK();
+    }
+
+    Status fetch_buffer(LazyBuffer* buffer) const override {
+      Status s = separate_helper->FetchCombined(buffer);
+      if (s.ok()) {
+        ++num_blob_fetches;
+        total_blob_fetch_bytes += buffer->size();
+      }
+      return s;
     }
   } separate_helper;
   if (compact_->compaction->immutable_cf_options()
@@ -2016,6 +2039,11 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  sub_compact->compaction_job_stats.num_blob_fetches +=
+      separate_helper.num_blob_fetches;
+  sub_compact->compaction_job_stats.total_blob_fetch_bytes +=
+      separate_helper.total_blob_fetch_bytes;
+
   if (!rebuild_blobs_info.blobs.empty()) {
     ROCKS_LOG_INFO(
         db_options_.info_log,
@@ -10,6 +10,7 @@
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
 #include "rocksdb/terark_namespace.h"
+#include "rocksdb/value_extractor.h"
 
 namespace TERARKDB_NAMESPACE {
 
@@ -880,6 +881,95 @@ TEST_F(DBTestCompactionFilter, SkipUntilWithBloomFilter) {
   EXPECT_EQ("v50", val);
 }
 
+// Uses the first byte of a value as its meta
+class FirstByteExtractor : public ValueExtractor {
+ public:
+  Status Extract(const Slice& /*key*/, const Slice& value,
+                 std::string* output) const override {
+    output->assign(value.data(), std::min<size_t>(value.size(), 1));
+    return Status::OK();
+  }
+};
+
+class FirstByteExtractorFactory : public ValueExtractorFactory {
+ public:
+  std::unique_ptr<ValueExtractor> CreateValueExtractor(
+      const Context& /*context*/) const override {
+    return std::unique_ptr<ValueExtractor>(new FirstByteExtractor());
+  }
+  const char* Name() const override { return "FirstByteExtractorFactory"; }
+};
+
+// Removes values starting with 'd', deciding on the meta if meta_only
+class FirstByteFilter : public CompactionFilter {
+ public:
+  explicit FirstByteFilter(bool meta_only) : meta_only_(meta_only) {}
+
+  Decision FilterV2(int /*level*/, const Slice& /*key*/,
+                    ValueType /*value_type*/, const Slice& existing_value_meta,
+                    const LazyBuffer& existing_value, LazyBuffer* new_value,
+                    std::string* /*skip_until*/) const override {
+    Slice first_byte = existing_value_meta;
+    if (!meta_only_) {
+      auto s = existing_value.fetch();
+      if (!s.ok()) {
+        new_value->reset(std::move(s));
+        return Decision::kChangeValue;
+      }
+      first_byte = Slice(existing_value.data(), 1);
+    }
+    return first_byte == "d" ? Decision::kRemove : Decision::kKeep;
+  }
+
+  bool IsValueMetaOnly() const override { return meta_only_; }
+
+  const char* Name() const override { return "FirstByteFilter"; }
+
+ private:
+  bool meta_only_;
+};
+
+class BlobFetchListener : public EventListener {
+ public:
+  void OnCompactionCompleted(DB* /*db*/, const CompactionJobInfo& ci) override {
+    num_blob_fetches += ci.stats.num_blob_fetches;
+  }
+  std::atomic<uint64_t> num_blob_fetches{0};
+};
+
+TEST_F(DBTestCompactionFilter, ValueMetaOnlyFilterSkipsBlobFetch) {
+  for (bool meta_only : {true, false}) {
+    FirstByteFilter filter(meta_only);
+    auto listener = std::make_shared<BlobFetchListener>();
+    Options options = CurrentOptions();
+    options.blob_size = 64;
+    options.value_meta_extractor_factory.reset(new FirstByteExtractorFactory);
+    options.compaction_filter = &filter;
+    options.disable_auto_compactions = true;
+    options.listeners.push_back(listener);
+    DestroyAndReopen(options);
+
+    const int kNumKeys = 100;
+    for (int i = 0; i < kNumKeys; ++i) {
+      std::string value(200, 'v');
+      value[0] = i % 2 == 0 ? 'd' : 'k';
+      ASSERT_OK(Put(Key(i), value));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_EQ(i % 2 == 0 ? "NOT_FOUND" : "k" + std::string(199, 'v'),
+                Get(Key(i)));
+    }
+    if (meta_only) {
+      ASSERT_EQ(0, listener->num_blob_fetches);
+    } else {
+      ASSERT_GE(listener->num_blob_fetches, kNumKeys);
+    }
+  }
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 int main(int argc, char** argv) {
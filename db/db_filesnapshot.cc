@@ -81,6 +81,35 @@ int DBImpl::IsFileDeletionsEnabled() const {
   return !disable_delete_obsolete_files_;
 }
 
+Status DBImpl::FlushForLiveFiles() {
+  mutex_.AssertHeld();
+  // flush all dirty data to disk.
+  autovector<ColumnFamilyData*> cfds;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    cfd->Ref();
+    cfds.push_back(cfd);
+  }
+  mutex_.Unlock();
+  Status status =
+      FlushMemTable(cfds, FlushOptions(), FlushReason::kGetLiveFiles);
+  TEST_SYNC_POINT("DBImpl::GetLiveFiles:1");
+  TEST_SYNC_POINT("DBImpl::GetLiveFiles:2");
+  mutex_.Lock();
+  for (auto cfd : cfds) {
+    cfd->Unref();
+  }
+  versions_->GetColumnFamilySet()->FreeDeadColumnFamilies();
+
+  if (!status.ok()) {
+    ROCKS_LOG_ERROR(immutable_db_options_.info_log, "Cannot Flush data %s\n",
+                    status.ToString().c_str());
+  }
+  return status;
+}
+
 Status DBImpl::GetLiveFiles(std::vector<std::string>& ret,
                             uint64_t* manifest_file_size, bool flush_memtable) {
   *manifest_file_size = 0;
@@ -88,30 +117,9 @@ Status DBImpl::GetLiveFiles(std::vector<std::string>& ret,
   mutex_.Lock();
 
   if (flush_memtable) {
-    // flush all dirty data to disk.
-    autovector<ColumnFamilyData*> cfds;
-    for (auto cfd : *versions_->GetColumnFamilySet()) {
-      if (cfd->IsDropped()) {
-        continue;
-      }
-      cfd->Ref();
-      cfds.push_back(cfd);
-    }
-    mutex_.Unlock();
-    Status status =
-        FlushMemTable(cfds, FlushOptions(), FlushReason::kGetLiveFiles);
-    TEST_SYNC_POINT("DBImpl::GetLiveFiles:1");
-    TEST_SYNC_POINT("DBImpl::GetLiveFiles:2");
-    mutex_.Lock();
-    for (auto cfd : cfds) {
-      cfd->Unref();
-    }
-    versions_->GetColumnFamilySet()->FreeDeadColumnFamilies();
-
+    Status status = FlushForLiveFiles();
     if (!status.ok()) {
       mutex_.Unlock();
-      ROCKS_LOG_ERROR(immutable_db_options_.info_log, "Cannot Flush data %s\n",
-                      status.ToString().c_str());
       return status;
     }
   }
@@ -145,6 +153,38 @@ Status DBImpl::GetLiveFiles(std::vector<std::string>& ret,
   return Status::OK();
 }
 
+Status DBImpl::GetCurrentVersionSnapshot(
+    std::vector<std::string>* live_files,
+    std::vector<std::string>* manifest_records, uint64_t* manifest_file_number,
+    uint64_t* min_log_number, bool flush_memtable) {
+  InstrumentedMutexLock l(&mutex_);
+
+  if (flush_memtable) {
+    Status status = FlushForLiveFiles();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // Unlike GetLiveFiles(), files only referenced by older versions are left
+  // out, the MANIFEST written from these records does not know about them
+  std::vector<FileDescriptor> live;
+  Status s = versions_->GetCurrentStateSnapshot(manifest_records, &live);
+  if (!s.ok()) {
+    return s;
+  }
+
+  live_files->clear();
+  live_files->reserve(live.size() + 1);  // *.sst + OPTIONS
+  for (const auto& live_file : live) {
+    live_files->push_back(MakeTableFileName("", live_file.GetNumber()));
+  }
+  live_files->push_back(OptionsFileName("", versions_->options_file_number()));
+  *manifest_file_number = versions_->manifest_file_number();
+  *min_log_number = versions_->MinLogNumberWithUnflushedData();
+  return Status::OK();
+}
+
 Status DBImpl::GetSortedWalFiles(VectorLogPtr& files) {
   {
     // If caller disabled deletions, this function should return files that are
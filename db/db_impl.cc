@@ -79,6 +79,7 @@
 #include "util/filename.h"
 #include "util/log_buffer.h"
 #include "util/logging.h"
+#include "util/mutexlock.h"
 #include "util/sst_file_manager_impl.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
@@ -279,6 +280,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       immutable_db_options_(initial_db_options_),
       mutable_db_options_(initial_db_options_),
       stats_(immutable_db_options_.statistics.get()),
+      perf_sampler_(env_, mutable_db_options_.perf_sampling_interval,
+                    immutable_db_options_.listeners),
       db_lock_(nullptr),
       mutex_(stats_, env_, DB_MUTEX_WAIT_MICROS,
              immutable_db_options_.use_adaptive_mutex),
@@ -316,6 +319,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_ttl_drop_scheduled_(0),
+      bg_scheduler_(env_, immutable_db_options_.adaptive_background_scheduling),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(env_->NowMicros()),
@@ -426,6 +431,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   // WriteUnprepared, which should use seq_per_batch_.
   assert(batch_per_txn_ || seq_per_batch_);
   env_->GetAbsolutePath(dbname, &db_absolute_path_);
+  write_controller_.set_feedback_control(
+      immutable_db_options_.adaptive_write_throttling);
 
   // Reserve ten files or so for other uses and give the rest to TableCache.
   // Give a large number for setting of "infinite" open files.
@@ -619,6 +626,7 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 
 Status DBImpl::CloseHelper() {
   console_runner_.closing_ = true;
+  tailing_notifier_.Shutdown();
 
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
@@ -637,15 +645,14 @@ Status DBImpl::CloseHelper() {
 
   Status ret;
   mutex_.Lock();
-  int bg_unscheduled = env_->UnSchedule(this, Env::Priority::BOTTOM);
-  bg_unscheduled += env_->UnSchedule(this, Env::Priority::LOW);
-  bg_unscheduled += env_->UnSchedule(this, Env::Priority::HIGH);
+  int bg_unscheduled = bg_scheduler_.UnSchedule();
 
   // Wait for background work to finish
   while (true) {
     int bg_scheduled = bg_bottom_compaction_scheduled_ +
                        bg_compaction_scheduled_ + bg_flush_scheduled_ +
-                       bg_purge_scheduled_ - bg_unscheduled;
+                       bg_purge_scheduled_ + bg_ttl_drop_scheduled_ -
+                       bg_unscheduled;
     if (bg_scheduled || pending_purge_obsolete_files_ ||
         error_handler_.IsRecoveryInProgress() || !console_runner_.closed_) {
       TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
@@ -655,6 +662,7 @@ Status DBImpl::CloseHelper() {
       bg_compaction_scheduled_ = 0;
       bg_flush_scheduled_ = 0;
       bg_purge_scheduled_ = 0;
+      bg_ttl_drop_scheduled_ = 0;
       break;
     }
   }
@@ -1016,6 +1024,7 @@ void DBImpl::ScheduleTtlGC() {
     }
     return should_mark;
   };
+  bool need_drop_expired = false;
   mutex_.Lock();
   for (auto cfd : *versions_->GetColumnFamilySet()) {
     uint64_t new_mark_count = 0;
@@ -1026,6 +1035,8 @@ void DBImpl::ScheduleTtlGC() {
       continue;
     }
     uint64_t now = cfd->ioptions()->ttl_extractor_factory->Now();
+    need_drop_expired |=
+        cfd->GetLatestMutableCFOptions()->ttl_drop_expired_files;
     VersionStorageInfo* vstorage = cfd->current()->storage_info();
     for (int l = 0; l < vstorage->num_non_empty_levels(); l++) {
       for (auto meta : vstorage->LevelFiles(l)) {
@@ -1067,11 +1078,176 @@ void DBImpl::ScheduleTtlGC() {
   if (unscheduled_compactions_ > 0) {
     MaybeScheduleFlushOrCompaction();
   }
+  // Dropping writes the manifest and deletes files, keep it off the timer
+  if (need_drop_expired && bg_ttl_drop_scheduled_ == 0 &&
+      !shutting_down_.load(std::memory_order_acquire)) {
+    bg_ttl_drop_scheduled_++;
+    env_->Schedule(&DBImpl::BGWorkDropExpiredTtlFiles, this,
+                   Env::Priority::LOW, nullptr);
+  }
   mutex_.Unlock();
   log_buffer_info.FlushBufferToLog();
   log_buffer_debug.FlushBufferToLog();
 }
 
+void DBImpl::BGWorkDropExpiredTtlFiles(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkDropExpiredTtlFiles:start");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallDropExpiredTtlFiles();
+  TEST_SYNC_POINT("DBImpl::BGWorkDropExpiredTtlFiles:end");
+}
+
+void DBImpl::BackgroundCallDropExpiredTtlFiles() {
+  JobContext job_context(next_job_id_.fetch_add(1), true);
+  LogBuffer log_buffer(InfoLogLevel::INFO_LEVEL,
+                       immutable_db_options_.info_log.get());
+  mutex_.Lock();
+  autovector<ColumnFamilyData*> cfds;
+  if (!shutting_down_.load(std::memory_order_acquire)) {
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->initialized() && !cfd->IsDropped() &&
+          cfd->ioptions()->ttl_extractor_factory != nullptr &&
+          cfd->GetLatestMutableCFOptions()->ttl_drop_expired_files) {
+        cfd->Ref();
+        cfds.push_back(cfd);
+      }
+    }
+  }
+  size_t drop_count = 0;
+  for (auto cfd : cfds) {
+    // LogAndApply releases the mutex, the cfd may be dropped meanwhile
+    if (!cfd->IsDropped() && !shutting_down_.load(std::memory_order_acquire)) {
+      uint64_t now = cfd->ioptions()->ttl_extractor_factory->Now();
+      drop_count += DropExpiredTtlFiles(cfd, now, &job_context, &log_buffer);
+    }
+    if (cfd->Unref()) {
+      delete cfd;
+    }
+  }
+  if (drop_count > 0) {
+    FindObsoleteFiles(&job_context, false);
+  }
+  mutex_.Unlock();
+  log_buffer.FlushBufferToLog();
+  if (job_context.HaveSomethingToDelete()) {
+    PurgeObsoleteFiles(job_context);
+  }
+  job_context.Clean(&mutex_);
+
+  mutex_.Lock();
+  bg_ttl_drop_scheduled_--;
+  bg_cv_.SignalAll();
+  // No code after SignalAll, the DB destructor may be waiting on it
+  mutex_.Unlock();
+}
+
+size_t DBImpl::DropExpiredTtlFiles(ColumnFamilyData* cfd, uint64_t now,
+                                   JobContext* job_context,
+                                   LogBuffer* log_buffer) {
+  mutex_.AssertHeld();
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  const Comparator* ucmp = cfd->user_comparator();
+  bool has_snapshots = !snapshots_.empty();
+  SequenceNumber newest_snapshot = has_snapshots ? snapshots_.GetNewest() : 0;
+  chash_set<FileMetaData*> dropped;
+  std::vector<FileMetaData*> overlaps;
+
+  // Dropping a file must not expose older versions of its keys, so nothing
+  // below it (or in an older L0 file) may overlap unless dropped as well
+  auto overlaps_older = [&](int level, size_t index, FileMetaData* f) {
+    if (level == 0) {
+      auto& l0_files = vstorage->LevelFiles(0);
+      for (size_t i = index + 1; i < l0_files.size(); ++i) {
+        auto o = l0_files[i];
+        if (dropped.count(o) == 0 &&
+            ucmp->Compare(o->smallest.user_key(), f->largest.user_key()) <=
+                0 &&
+            ucmp->Compare(f->smallest.user_key(), o->largest.user_key()) <=
+                0) {
+          return true;
+        }
+      }
+    }
+    for (int l = std::max(level + 1, 1); l < vstorage->num_non_empty_levels();
+         ++l) {
+      vstorage->GetOverlappingInputs(l, &f->smallest, &f->largest, &overlaps,
+                                     -1 /* hint_index */,
+                                     nullptr /* file_index */,
+                                     false /* expand_range */);
+      for (auto o : overlaps) {
+        if (dropped.count(o) == 0) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
+  auto expired = [&](FileMetaData* f) {
+    return !f->prop.has_range_deletions() &&
+           f->prop.latest_time_expire <= now &&
+           (!has_snapshots || newest_snapshot < f->fd.smallest_seqno);
+  };
+  // A map sst is expired when every essence sst it references is, dropping it
+  // lets the version builder release those (and their blob) files as well
+  auto map_expired = [&](FileMetaData* f) {
+    if (f->prop.has_range_deletions() || f->prop.dependence.empty()) {
+      return false;
+    }
+    auto& dependence_map = vstorage->dependence_map();
+    for (auto& dependence : f->prop.dependence) {
+      auto find = dependence_map.find(dependence.file_number);
+      if (find == dependence_map.end() || find->second->prop.is_map_sst() ||
+          !expired(find->second)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  VersionEdit edit;
+  edit.SetColumnFamily(cfd->GetID());
+  // Oldest data first, so a run of expired files can go in one pass
+  for (int l = vstorage->num_non_empty_levels() - 1; l >= 0; --l) {
+    auto& level_files = vstorage->LevelFiles(l);
+    for (size_t i = level_files.size(); i-- > 0;) {
+      auto f = level_files[i];
+      if (f->being_compacted ||
+          !(f->prop.is_map_sst() ? map_expired(f) : expired(f)) ||
+          overlaps_older(l, i, f)) {
+        continue;
+      }
+      edit.DeleteFile(l, f->fd.GetNumber());
+      dropped.emplace(f);
+      f->being_compacted = true;
+      ROCKS_LOG_BUFFER(log_buffer,
+                       "[%s] %s SST #%" PRIu64 " @L%d expired"
+                       ", dropped without compaction, now: %" PRIu64,
+                       cfd->GetName().c_str(),
+                       f->prop.is_map_sst() ? "Map" : "Essence",
+                       f->fd.GetNumber(), l, now);
+      TEST_SYNC_POINT("DBImpl:ScheduleTtlGC-drop");
+    }
+  }
+  if (dropped.empty()) {
+    return 0;
+  }
+  Status s = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(),
+                                    &edit, &mutex_, directories_.GetDbDir());
+  if (s.ok()) {
+    InstallSuperVersionAndScheduleWork(
+        cfd, &job_context->superversion_contexts[0],
+        *cfd->GetLatestMutableCFOptions(), FlushReason::kDeleteFiles);
+  } else {
+    ROCKS_LOG_BUFFER(log_buffer, "[%s] Drop expired SSTs failed: %s",
+                     cfd->GetName().c_str(), s.ToString().c_str());
+  }
+  for (auto f : dropped) {
+    f->being_compacted = false;
+  }
+  return s.ok() ? dropped.size() : 0;
+}
+
 #ifdef WITH_ZENFS
 // Implemented inside `zenfs/fs/fs_zenfs.cc`
 std::vector<ZoneStat> GetStat(Env* env);
@@ -1459,6 +1635,7 @@ Status DBImpl::SetDBOptions(
       }
       write_controller_.set_max_delayed_write_rate(
           new_options.delayed_write_rate);
+      perf_sampler_.SetInterval(new_options.perf_sampling_interval);
       table_cache_.get()->SetCapacity(new_options.max_open_files == -1
                                           ? TableCache::kInfiniteCapacity
                                           : new_options.max_open_files - 10);
@@ -1676,6 +1853,77 @@ SequenceNumber DBImpl::GetLatestSequenceNumber() const {
   return versions_->LastSequence();
 }
 
+Status DBImpl::RegisterNewDataCallback(ColumnFamilyHandle* column_family,
+                                       SequenceNumber seq, const Slice* begin,
+                                       const Slice* end,
+                                       NewDataCallback* callback) {
+  auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family)->cfd();
+  Status s = tailing_notifier_.Register(cfd->GetID(), cfd->user_comparator(),
+                                        seq, begin, end, callback);
+  if (s.ok()) {
+    // Writes published before the registration was visible to them
+    tailing_notifier_.NotifyIfBehind(callback, versions_->LastSequence());
+  }
+  return s;
+}
+
+bool DBImpl::UnregisterNewDataCallback(NewDataCallback* callback) {
+  return tailing_notifier_.Unregister(callback);
+}
+
+namespace {
+class BlockingNewDataCallback : public NewDataCallback {
+ public:
+  BlockingNewDataCallback() : cv_(&mutex_), done_(false) {}
+
+  void OnNewData(const Status& status, SequenceNumber /*seq*/) override {
+    MutexLock l(&mutex_);
+    status_ = status;
+    done_ = true;
+    cv_.SignalAll();
+  }
+
+  // Returns false on timeout
+  bool Wait(Env* env, uint64_t timeout_micros, Status* status) {
+    MutexLock l(&mutex_);
+    uint64_t deadline = env->NowMicros() + timeout_micros;
+    while (!done_) {
+      if (timeout_micros == 0) {
+        cv_.Wait();
+      } else if (cv_.TimedWait(deadline)) {
+        break;
+      }
+    }
+    *status = status_;
+    return done_;
+  }
+
+ private:
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  bool done_;
+  Status status_;
+};
+}  // namespace
+
+Status DBImpl::WaitForNewData(ColumnFamilyHandle* column_family,
+                              SequenceNumber seq, const Slice* begin,
+                              const Slice* end, uint64_t timeout_micros) {
+  BlockingNewDataCallback callback;
+  Status s = RegisterNewDataCallback(column_family, seq, begin, end, &callback);
+  if (!s.ok()) {
+    return s;
+  }
+  if (!callback.Wait(env_, timeout_micros, &s)) {
+    if (tailing_notifier_.Unregister(&callback)) {
+      return Status::TimedOut();
+    }
+    // Called between the timeout and Unregister()
+    callback.Wait(env_, 0, &s);
+  }
+  return s;
+}
+
 void DBImpl::SetLastPublishedSequence(SequenceNumber seq) {
   versions_->SetLastPublishedSequence(seq);
 }
@@ -1834,7 +2082,8 @@ InternalIterator* DBImpl::NewInternalIterator(
   MergeIteratorBuilder merge_iter_builder(
       &cfd->internal_comparator(), arena,
       !read_options.total_order_seek &&
-          super_version->mutable_cf_options.prefix_extractor != nullptr);
+          super_version->mutable_cf_options.prefix_extractor != nullptr,
+      cfd->ioptions()->use_loser_tree_merging_iterator);
   // Collect iterator for mutable mem
   merge_iter_builder.AddIterator(
       super_version->mem->NewIterator(read_options, arena));
@@ -1898,6 +2147,7 @@ Status DBImpl::GetImpl(const ReadOptions& read_options,
   read_qps_reporter_.AddCount(1);
 
   StopWatch sw(env_, stats_, DB_GET);
+  PerfSampleGuard perf_sample(&perf_sampler_, PerfSampleOperation::kGet);
   PERF_TIMER_GUARD(get_snapshot_time);
 
   auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family);
@@ -2109,6 +2359,7 @@ std::vector<Status> DBImpl::MultiGet(
   LatencyHistGuard guard(&read_latency_reporter_);
   read_qps_reporter_.AddCount(keys.size());
   StopWatch sw(env_, stats_, DB_MULTIGET);
+  PerfSampleGuard perf_sample(&perf_sampler_, PerfSampleOperation::kMultiGet);
   PERF_TIMER_GUARD(get_snapshot_time);
 
   SequenceNumber snapshot;
@@ -3042,6 +3293,28 @@ bool DBImpl::GetPropertyHandleOptionsStatistics(std::string* value) {
   return true;
 }
 
+bool DBImpl::GetPropertyHandlePerfSamples(std::string* value) {
+  assert(value != nullptr);
+  if (perf_sampler_.GetInterval() == 0 && perf_sampler_.NumSampled() == 0) {
+    return false;
+  }
+  *value = perf_sampler_.ToString(10 /* top_n */);
+  return true;
+}
+
+bool DBImpl::GetPropertyHandleBackgroundSchedulerStats(std::string* value) {
+  assert(value != nullptr);
+  *value = bg_scheduler_.ToString();
+  return true;
+}
+
+bool DBImpl::GetPropertyHandleWriteControllerStats(std::string* value) {
+  assert(value != nullptr);
+  InstrumentedMutexLock l(&mutex_);
+  *value = write_controller_.FeedbackToString();
+  return true;
+}
+
 #ifndef ROCKSDB_LITE
 Status DBImpl::ResetStats() {
   InstrumentedMutexLock l(&mutex_);
@@ -3444,7 +3717,9 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
         read_options.verify_checksums = true;
         read_options.fill_cache = false;
         read_options.total_order_seek = true;
-        MergeIteratorBuilder builder(&ic, arena);
+        MergeIteratorBuilder builder(
+            &ic, arena, false /* prefix_seek_mode */,
+            cfd->ioptions()->use_loser_tree_merging_iterator);
         input_version->AddIterators(read_options, env_options_, &builder,
                                     nullptr /* range_del_agg */);
         return builder.Finish();
@@ -4525,8 +4800,18 @@ Status DBImpl::IngestExternalFile(
   sv_context.Clean();
   ingestion_job.Cleanup(status);
 
+  if (status.ok() && ingestion_options.warm_table_cache) {
+    SuperVersion* sv = cfd->GetReferencedSuperVersion(this);
+    ingestion_job.WarmTableCache(sv);
+    CleanupSuperVersion(sv);
+  }
+
   if (status.ok()) {
     NotifyOnExternalFileIngested(cfd, ingestion_job);
+    if (tailing_notifier_.HasWaiters()) {
+      tailing_notifier_.NotifyColumnFamily(cfd->GetID(),
+                                           versions_->LastSequence());
+    }
   }
 
   return status;
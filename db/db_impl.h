@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "db/background_scheduler.h"
 #include "db/column_family.h"
 #include "db/compaction_job.h"
 #include "db/dbformat.h"
@@ -35,12 +36,14 @@
 #include "db/read_callback.h"
 #include "db/snapshot_checker.h"
 #include "db/snapshot_impl.h"
+#include "db/tailing_notifier.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "memtable_list.h"
 #include "monitoring/instrumented_mutex.h"
+#include "monitoring/perf_sampler.h"
 #include "options/db_options.h"
 #include "port/port.h"
 #include "rocksdb/db.h"
@@ -248,6 +251,15 @@ class DBImpl : public DB {
   virtual Status UnlockWAL() override;
 
   virtual SequenceNumber GetLatestSequenceNumber() const override;
+  virtual Status RegisterNewDataCallback(ColumnFamilyHandle* column_family,
+                                         SequenceNumber seq, const Slice* begin,
+                                         const Slice* end,
+                                         NewDataCallback* callback) override;
+  virtual bool UnregisterNewDataCallback(NewDataCallback* callback) override;
+  virtual Status WaitForNewData(ColumnFamilyHandle* column_family,
+                                SequenceNumber seq, const Slice* begin,
+                                const Slice* end,
+                                uint64_t timeout_micros = 0) override;
   // REQUIRES: joined the main write queue if two_write_queues is disabled, and
   // the second write queue otherwise.
   virtual void SetLastPublishedSequence(SequenceNumber seq);
@@ -280,6 +292,16 @@ class DBImpl : public DB {
   virtual Status GetLiveFiles(std::vector<std::string>&,
                               uint64_t* manifest_file_size,
                               bool flush_memtable = true) override;
+  // The files of the current version of every column family, blob and
+  // dependence files included, and the records of a MANIFEST describing
+  // exactly that state, to be written with the number of the live MANIFEST.
+  // WAL files numbered from *min_log_number on hold the updates that are not
+  // in those files. All the filenames start with "/"
+  Status GetCurrentVersionSnapshot(std::vector<std::string>* live_files,
+                                   std::vector<std::string>* manifest_records,
+                                   uint64_t* manifest_file_number,
+                                   uint64_t* min_log_number,
+                                   bool flush_memtable = true);
   virtual Status GetSortedWalFiles(VectorLogPtr& files) override;
 
   virtual Status GetUpdatesSince(
@@ -438,6 +460,9 @@ class DBImpl : public DB {
   // is only for the special test of CancelledCompactions
   Status TEST_WaitForCompact(bool waitUnscheduled = false);
 
+  // Wait for the scheduled expired ttl file drop job
+  void TEST_WaitForTtlDrop();
+
   // Return the maximum overlapping data (in bytes) at next level for any
   // file at a level >= 1.
   int64_t TEST_MaxNextLevelOverlappingBytes(
@@ -686,6 +711,8 @@ class DBImpl : public DB {
   using ThroughputReporter = CountReporterHandle&;
   using DistributionReporter = HistReporterHandle&;
 
+  PerfSampler* perf_sampler() { return &perf_sampler_; }
+
   std::unordered_map<std::string, RecoveredTransaction*>
   recovered_transactions() {
     return recovered_transactions_;
@@ -807,6 +834,12 @@ class DBImpl : public DB {
 
   void ScheduleTtlGC();
 
+  // Drops SSTs of cfd whose values have all expired by now through a
+  // metadata-only edit, returns the number of files dropped.
+  // REQUIRES: mutex_ held
+  size_t DropExpiredTtlFiles(ColumnFamilyData* cfd, uint64_t now,
+                             JobContext* job_context, LogBuffer* log_buffer);
+
 #ifdef WITH_ZENFS
   // schedule GC by polling ZNS zone status
   void ScheduleZNSGC();
@@ -826,6 +859,8 @@ class DBImpl : public DB {
   const ImmutableDBOptions immutable_db_options_;
   MutableDBOptions mutable_db_options_;
   Statistics* stats_;
+  // Samples PerfContext of one in every perf_sampling_interval operations
+  PerfSampler perf_sampler_;
   std::unordered_map<std::string, RecoveredTransaction*>
       recovered_transactions_;
   std::unique_ptr<Tracer> tracer_;
@@ -1140,6 +1175,12 @@ class DBImpl : public DB {
                        const FlushOptions& options, FlushReason flush_reason,
                        bool writes_stopped = false);
 
+#ifndef ROCKSDB_LITE
+  // Flush all column families before listing live files.
+  // REQUIRES: mutex_ held, it is released while flushing
+  Status FlushForLiveFiles();
+#endif  // ROCKSDB_LITE
+
   // Wait until flushing this column family won't stall writes
   Status WaitUntilFlushWouldNotStallWrites(ColumnFamilyData* cfd,
                                            bool* flush_needed);
@@ -1250,12 +1291,14 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void BGWorkPurge(void* arg);
+  static void BGWorkDropExpiredTtlFiles(void* arg);
   static void UnscheduleCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
                                 Env::Priority bg_thread_pri);
   void BackgroundCallGarbageCollection();
   void BackgroundCallFlush();
   void BackgroundCallPurge();
+  void BackgroundCallDropExpiredTtlFiles();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer,
                               PrepickedCompaction* prepicked_compaction);
@@ -1490,6 +1533,8 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  // Wakes up the consumers waiting in WaitForNewData() after writes
+  TailingNotifier tailing_notifier_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
@@ -1605,6 +1650,13 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // number of background expired ttl file drop jobs, submitted to the LOW pool
+  int bg_ttl_drop_scheduled_;
+
+  // Runs flushes, compactions, garbage collections and bottom compactions on
+  // the Env thread pools
+  BackgroundScheduler bg_scheduler_;
+
   // Information for a manual compaction
   struct ManualCompactionState {
     ColumnFamilyData* cfd;
@@ -1758,6 +1810,9 @@ class DBImpl : public DB {
                               const DBPropertyInfo& property_info,
                               bool is_locked, uint64_t* value);
   bool GetPropertyHandleOptionsStatistics(std::string* value);
+  bool GetPropertyHandlePerfSamples(std::string* value);
+  bool GetPropertyHandleBackgroundSchedulerStats(std::string* value);
+  bool GetPropertyHandleWriteControllerStats(std::string* value);
 
   bool HasPendingManualCompaction();
   bool HasExclusiveManualCompaction();
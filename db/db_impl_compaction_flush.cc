@@ -136,7 +136,8 @@ Status DBImpl::FlushMemTableToOutputFile(
       GetDataDir(cfd, 0U),
       GetCompressionFlush(*cfd->ioptions(), mutable_cf_options), stats_,
       &event_logger_, mutable_cf_options.report_bg_io_stats,
-      true /* sync_output_directory */, true /* write_manifest */, flush_load);
+      true /* sync_output_directory */, true /* write_manifest */, flush_load,
+      &perf_sampler_);
 
   TEST_SYNC_POINT("DBImpl::FlushMemTableToOutputFile:BeforePickMemtables");
   flush_job.PickMemTable();
@@ -1019,7 +1020,11 @@ Status DBImpl::CompactFilesImpl(
   mutex_.Unlock();
   TEST_SYNC_POINT("CompactFilesImpl:0");
   TEST_SYNC_POINT("CompactFilesImpl:1");
-  compaction_job.Run();
+  {
+    PerfSampleGuard perf_sample(&perf_sampler_,
+                                PerfSampleOperation::kCompaction);
+    compaction_job.Run();
+  }
   TEST_SYNC_POINT("CompactFilesImpl:2");
   TEST_SYNC_POINT("CompactFilesImpl:3");
   mutex_.Lock();
@@ -1496,8 +1501,9 @@ Status DBImpl::RunManualCompaction(
       ca->prepicked_compaction->compaction = compaction;
       manual.incomplete = false;
       bg_compaction_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                     &DBImpl::UnscheduleCallback);
+      bg_scheduler_.Schedule(BackgroundScheduler::kCompaction,
+                             &DBImpl::BGWorkCompaction, ca,
+                             &DBImpl::UnscheduleCallback);
       scheduled = true;
     }
   }
@@ -1829,17 +1835,19 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
   while (!is_flush_pool_empty && unscheduled_flushes_ > 0 &&
          bg_flush_scheduled_ < bg_job_limits.max_flushes) {
     bg_flush_scheduled_++;
-    env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::HIGH, this);
+    bg_scheduler_.Schedule(BackgroundScheduler::kFlush, &DBImpl::BGWorkFlush,
+                           this);
   }
 
-  // special case -- if high-pri (flush) thread pool is empty, then schedule
-  // flushes in low-pri (compaction) thread pool.
+  // special case -- if high-pri (flush) thread pool is empty, then flushes
+  // share the low-pri (compaction) thread pool, bg_scheduler_ runs them there.
   if (is_flush_pool_empty) {
     while (unscheduled_flushes_ > 0 &&
            bg_flush_scheduled_ + bg_compaction_scheduled_ <
                bg_job_limits.max_flushes) {
       bg_flush_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::LOW, this);
+      bg_scheduler_.Schedule(BackgroundScheduler::kFlush, &DBImpl::BGWorkFlush,
+                             this);
     }
   }
 
@@ -1867,8 +1875,9 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     bg_compaction_scheduled_++;
     bg_garbage_collection_scheduled_++;
     unscheduled_garbage_collections_--;
-    env_->Schedule(&DBImpl::BGWorkGarbageCollection, ca, Env::Priority::LOW,
-                   this, &DBImpl::UnscheduleCallback);
+    bg_scheduler_.Schedule(BackgroundScheduler::kGarbageCollection,
+                           &DBImpl::BGWorkGarbageCollection, ca,
+                           &DBImpl::UnscheduleCallback);
   }
 
   if (HasExclusiveManualCompaction()) {
@@ -1885,8 +1894,9 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->prepicked_compaction = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    bg_scheduler_.Schedule(BackgroundScheduler::kCompaction,
+                           &DBImpl::BGWorkCompaction, ca,
+                           &DBImpl::UnscheduleCallback);
   }
 }
 
@@ -1897,11 +1907,17 @@ DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
     need_speedup_compaction |=
         cfd->current()->storage_info()->has_space_amplification();
   }
-  return GetBGJobLimits(immutable_db_options_.max_background_flushes,
-                        mutable_db_options_.max_background_compactions,
-                        mutable_db_options_.max_background_garbage_collections,
-                        mutable_db_options_.max_background_jobs,
-                        need_speedup_compaction);
+  auto res =
+      GetBGJobLimits(immutable_db_options_.max_background_flushes,
+                     mutable_db_options_.max_background_compactions,
+                     mutable_db_options_.max_background_garbage_collections,
+                     mutable_db_options_.max_background_jobs,
+                     need_speedup_compaction);
+  if (need_speedup_compaction) {
+    // Don't add compactions the device cannot keep up with
+    res.max_compactions = bg_scheduler_.CompactionLimit(res.max_compactions);
+  }
+  return res;
 }
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits(
@@ -2783,8 +2799,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     ca->prepicked_compaction->compaction = c.release();
     ca->prepicked_compaction->manual_compaction_state = nullptr;
     ++bg_bottom_compaction_scheduled_;
-    env_->Schedule(&DBImpl::BGWorkBottomCompaction, ca, Env::Priority::BOTTOM,
-                   this, &DBImpl::UnscheduleCallback);
+    bg_scheduler_.Schedule(BackgroundScheduler::kBottomCompaction,
+                           &DBImpl::BGWorkBottomCompaction, ca,
+                           &DBImpl::UnscheduleCallback);
   } else {
     // Normal compactions that needs to control the quantity of workers.
     int output_level __attribute__((__unused__));
@@ -2817,12 +2834,30 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     NotifyOnCompactionBegin(c->column_family_data(), c.get(), status,
                             compaction_job_stats, job_context->job_id);
 
+    int concurrency = num_running_compactions_;
     mutex_.Unlock();
-    compaction_job.Run();
+    {
+      PerfSampleGuard perf_sample(&perf_sampler_,
+                                  PerfSampleOperation::kCompaction);
+      compaction_job.Run();
+    }
     TEST_SYNC_POINT("DBImpl::BackgroundCompaction:NonTrivial:AfterRun");
     mutex_.Lock();
     bg_compaction_scheduled_ -= sub_compaction_scheduled;
     status = compaction_job.Install(*c->mutable_cf_options());
+    if (status.ok() && bg_scheduler_.work_stealing()) {
+      bg_scheduler_.ReportCompaction(
+          concurrency,
+          GetBGJobLimits(immutable_db_options_.max_background_flushes,
+                         mutable_db_options_.max_background_compactions,
+                         mutable_db_options_.max_background_garbage_collections,
+                         mutable_db_options_.max_background_jobs,
+                         true /* parallelize_compactions */)
+              .max_compactions,
+          compaction_job_stats.total_input_bytes +
+              compaction_job_stats.total_output_bytes,
+          compaction_job_stats.elapsed_micros);
+    }
     if (status.ok()) {
       InstallSuperVersionAndScheduleWork(
           c->column_family_data(), &job_context->superversion_contexts[0],
@@ -151,6 +151,13 @@ Status DBImpl::TEST_WaitForCompact(bool wait_unscheduled) {
   return error_handler_.GetBGError();
 }
 
+void DBImpl::TEST_WaitForTtlDrop() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_ttl_drop_scheduled_) {
+    bg_cv_.Wait();
+  }
+}
+
 void DBImpl::TEST_LockMutex() { mutex_.Lock(); }
 
 void DBImpl::TEST_UnlockMutex() { mutex_.Unlock(); }
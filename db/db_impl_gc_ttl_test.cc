@@ -92,9 +92,155 @@ class DBImplGCTTL_Test : public DBTestBase {
         "DBImpl:ScheduleTtlGC-mark", [&](void* /*arg*/) { mark++; });
     TERARKDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
         "DBImpl:Exist-SST", [&](void* /*arg*/) { cnt++; });
+    TERARKDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+        "DBImpl:ScheduleTtlGC-drop", [&](void* /*arg*/) { dropped++; });
+  }
+
+  std::atomic<int> dropped{0};
+
+  void OpenForDrop() {
+    init();
+    options.ttl_drop_expired_files = true;
+    options.disable_auto_compactions = true;
+    options.env = mock_env_.get();
+    SetUp();
+    TERARKDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+    Reopen(options);
+  }
+
+  void PutWithTtl(const std::string& key, uint64_t ttl_time_point) {
+    char ts_string[8];
+    EncodeFixed64(ts_string, ttl_time_point);
+    std::string value = "value_" + key;
+    value.append(ts_string, 8);
+    ASSERT_OK(dbfull()->Put(WriteOptions(), key, value));
+  }
+
+  void PutFile(int first, int last, uint64_t ttl_time_point) {
+    for (int i = first; i < last; ++i) {
+      PutWithTtl(Key(i), ttl_time_point);
+    }
+    ASSERT_OK(dbfull()->Flush(FlushOptions()));
+  }
+
+  // Run the periodic ttl gc at `now` and wait for the drop it schedules
+  int RunTtlGC(uint64_t now) {
+    dropped = 0;
+    dbfull()->TEST_WaitForStatsDumpRun(
+        [&] { mock_env_->set_current_time(now); });
+    dbfull()->TEST_WaitForTtlDrop();
+    return dropped.load();
   }
 };
 
+TEST_F(DBImplGCTTL_Test, DropExpiredFiles) {
+  OpenForDrop();
+  PutFile(0, 100, ttl);
+  PutFile(50, 150, ttl);
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  ASSERT_EQ(0, RunTtlGC(ttl - 50));
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  // The older file goes first, which frees the newer one above it
+  ASSERT_EQ(2, RunTtlGC(ttl + 50));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ("NOT_FOUND", Get(Key(60)));
+}
+
+TEST_F(DBImplGCTTL_Test, KeepExpiredFileSeenBySnapshot) {
+  OpenForDrop();
+  PutFile(0, 100, ttl);
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_EQ(0, RunTtlGC(ttl + 50));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ(1, RunTtlGC(ttl + 100));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBImplGCTTL_Test, KeepExpiredFileOverOlderData) {
+  OpenForDrop();
+  PutFile(0, 100, ttl * 10);
+  PutFile(50, 150, ttl);
+  // Dropping the newer file would bring back the older values of its keys
+  ASSERT_EQ(0, RunTtlGC(ttl + 50));
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBImplGCTTL_Test, KeepExpiredFileWithRangeDeletion) {
+  OpenForDrop();
+  for (int i = 0; i < 100; ++i) {
+    PutWithTtl(Key(i), ttl);
+  }
+  ASSERT_OK(dbfull()->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                  Key(200), Key(300)));
+  ASSERT_OK(dbfull()->Flush(FlushOptions()));
+  ASSERT_EQ(0, RunTtlGC(ttl + 50));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBImplGCTTL_Test, KeepFileWithNeverExpiringValue) {
+  OpenForDrop();
+  for (int i = 0; i < 100; ++i) {
+    PutWithTtl(Key(i), ttl);
+  }
+  PutWithTtl(Key(100), port::kMaxUint64);
+  ASSERT_OK(dbfull()->Flush(FlushOptions()));
+  ASSERT_EQ(0, RunTtlGC(ttl + 50));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBImplGCTTL_Test, DropExpiredFileAfterReopen) {
+  OpenForDrop();
+  PutFile(0, 100, ttl);
+  // latest_time_expire is read back from the manifest
+  Reopen(options);
+  ASSERT_EQ(1, RunTtlGC(ttl + 50));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBImplGCTTL_Test, TimeRangeReadSkipsFiles) {
+  init();
+  options.disable_auto_compactions = true;
+  options.env = mock_env_.get();
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  PutFile(0, 100, 100);
+  PutFile(100, 200, 200);
+  PutFile(200, 300, 300);
+  ASSERT_EQ(3, NumTableFilesAtLevel(0));
+
+  ReadOptions ro;
+  ro.ttl_time_lower_bound = 150;
+  ro.ttl_time_upper_bound = 250;
+  std::string value;
+  ASSERT_OK(db_->Get(ro, Key(150), &value));
+  ASSERT_TRUE(db_->Get(ro, Key(50), &value).IsNotFound());
+  ASSERT_TRUE(db_->Get(ro, Key(250), &value).IsNotFound());
+  // The misses skip the only file holding their key
+  ASSERT_EQ(2, TestGetTickerCount(options, READ_SKIP_FILE_BY_TTL_TIME));
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(100, count);
+  ASSERT_EQ(4, TestGetTickerCount(options, READ_SKIP_FILE_BY_TTL_TIME));
+
+  // Without bounds every file is read
+  ASSERT_OK(db_->Get(ReadOptions(), Key(50), &value));
+  ASSERT_EQ(4, TestGetTickerCount(options, READ_SKIP_FILE_BY_TTL_TIME));
+
+  // A file with a deletion is never skipped
+  ASSERT_OK(db_->Delete(WriteOptions(), Key(0)));
+  PutFile(300, 310, 100);
+  ASSERT_OK(db_->Get(ro, Key(300), &value));
+}
+
 TEST_F(DBImplGCTTL_Test, BlockBasedTableTest) {
   init();
   run();
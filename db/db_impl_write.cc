@@ -80,6 +80,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   write_qps_reporter_.AddCount(WriteBatchInternal::Count(my_batch));
   write_throughput_reporter_.AddCount(WriteBatchInternal::ByteSize(my_batch));
   write_batch_size_reporter_.AddRecord(WriteBatchInternal::ByteSize(my_batch));
+  PerfSampleGuard perf_sample(&perf_sampler_, PerfSampleOperation::kWrite);
 
   assert(!seq_per_batch_ || batch_cnt != 0);
   if (my_batch == nullptr) {
@@ -169,6 +170,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       // TODO(myabandeh): propagate status to write_group
       auto last_sequence = w.write_group->last_sequence;
       versions_->SetLastSequence(last_sequence);
+      if (tailing_notifier_.HasWaiters()) {
+        tailing_notifier_.NotifyWrite(*w.write_group, last_sequence);
+      }
       MemTableInsertStatusCheck(w.status);
       write_thread_.ExitAsBatchGroupFollower(&w);
     }
@@ -409,6 +413,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         }
       }
       versions_->SetLastSequence(last_sequence);
+      if (tailing_notifier_.HasWaiters()) {
+        tailing_notifier_.NotifyWrite(write_group, last_sequence);
+      }
     }
     MemTableInsertStatusCheck(w.status);
     write_thread_.ExitAsBatchGroupLeader(write_group, status);
@@ -523,6 +530,10 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
           0 /*log_number*/, this, false /*concurrent_memtable_writes*/,
           seq_per_batch_, batch_per_txn_);
       versions_->SetLastSequence(memtable_write_group.last_sequence);
+      if (tailing_notifier_.HasWaiters()) {
+        tailing_notifier_.NotifyWrite(memtable_write_group,
+                                      memtable_write_group.last_sequence);
+      }
       write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
     }
   }
@@ -538,6 +549,10 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     if (write_thread_.CompleteParallelMemTableWriter(&w)) {
       MemTableInsertStatusCheck(w.status);
       versions_->SetLastSequence(w.write_group->last_sequence);
+      if (tailing_notifier_.HasWaiters()) {
+        tailing_notifier_.NotifyWrite(*w.write_group,
+                                      w.write_group->last_sequence);
+      }
       write_thread_.ExitAsMemTableWriter(&w, *w.write_group);
     }
   }
@@ -1186,6 +1186,9 @@ void DBIter::Seek(const Slice& target) {
                              ? DummyHistReporterHandle()
                              : (db_impl_->seek_qps_reporter().AddCount(1),
                                 &db_impl_->seek_latency_reporter()));
+  PerfSampleGuard perf_sample(
+      db_impl_ == nullptr ? nullptr : db_impl_->perf_sampler(),
+      PerfSampleOperation::kSeek);
 
   StopWatch sw(env_, statistics_, DB_SEEK);
   status_ = Status::OK();
@@ -1250,6 +1253,9 @@ void DBIter::SeekForPrev(const Slice& target) {
       db_impl_ == nullptr ? DummyHistReporterHandle()
                           : (db_impl_->seekforprev_qps_reporter().AddCount(1),
                              &db_impl_->seekforprev_latency_reporter()));
+  PerfSampleGuard perf_sample(
+      db_impl_ == nullptr ? nullptr : db_impl_->perf_sampler(),
+      PerfSampleOperation::kSeek);
 
   StopWatch sw(env_, statistics_, DB_SEEK);
   status_ = Status::OK();
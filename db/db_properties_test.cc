@@ -1465,6 +1465,35 @@ TEST_F(DBPropertiesTest, SstFilesSize) {
   ASSERT_TRUE(listener->callback_triggered);
 }
 
+TEST_F(DBPropertiesTest, BlobGarbageRatio) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.enable_lazy_compaction = false;
+  options.blob_size = 100;
+  Reopen(options);
+
+  std::string ratio;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlobGarbageRatio, &ratio));
+  ASSERT_EQ(0, std::stod(ratio));
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put("key" + ToString(i), std::string(1000, 'v')));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlobGarbageRatio, &ratio));
+  ASSERT_EQ(0, std::stod(ratio));
+
+  // Half of the values in the first blob file are overwritten
+  for (int i = 0; i < 5; i++) {
+    ASSERT_OK(Put("key" + ToString(i), std::string(1000, 'w')));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlobGarbageRatio, &ratio));
+  ASSERT_GT(std::stod(ratio), 0);
+  ASSERT_LE(std::stod(ratio), 1);
+}
+
 TEST_F(DBPropertiesTest, MinObsoleteSstNumberToKeep) {
   class TestListener : public EventListener {
    public:
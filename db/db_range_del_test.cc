@@ -681,6 +681,106 @@ TEST_F(DBRangeDelTest, GetCoveredKeyFromSst) {
   } while (ChangeOptions(kRangeDelSkipConfigs | kSkipHashCuckoo));
 }
 
+TEST_F(DBRangeDelTest, GetSkipsSstCoveredByNewerTombstone) {
+  Options opts = CurrentOptions();
+  opts.statistics = CreateDBStatistics();
+  DestroyAndReopen(opts);
+
+  ASSERT_OK(db_->Put(WriteOptions(), "key", "val"));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+  ASSERT_OK(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a", "z"));
+
+  std::string value;
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key", &value).IsNotFound());
+  ASSERT_EQ(1, TestGetTickerCount(opts, GET_SKIP_FILE_BY_RANGE_DEL));
+
+  // A newer write inside the range makes the second file readable again
+  ASSERT_OK(db_->Put(WriteOptions(), "key", "val2"));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+  ASSERT_OK(db_->Get(ReadOptions(), "key", &value));
+  ASSERT_EQ("val2", value);
+  ASSERT_EQ(1, TestGetTickerCount(opts, GET_SKIP_FILE_BY_RANGE_DEL));
+}
+
+TEST_F(DBRangeDelTest, GetStopsAtSstCoveredByNewerTombstone) {
+  Options opts = CurrentOptions();
+  opts.statistics = CreateDBStatistics();
+  DestroyAndReopen(opts);
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(db_->Put(WriteOptions(), "key", "val" + ToString(i)));
+    ASSERT_OK(db_->Flush(FlushOptions()));
+  }
+  ASSERT_OK(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a", "z"));
+
+  // The newest covered file ends the lookup, the older ones are not visited
+  std::string value;
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key", &value).IsNotFound());
+  ASSERT_EQ(1, TestGetTickerCount(opts, GET_SKIP_FILE_BY_RANGE_DEL));
+}
+
+TEST_F(DBRangeDelTest, GetSkipsMapSstCoveredByNewerTombstone) {
+  Options opts = CurrentOptions();
+  opts.statistics = CreateDBStatistics();
+  opts.disable_auto_compactions = true;
+  opts.enable_lazy_compaction = true;
+  DestroyAndReopen(opts);
+
+  ASSERT_OK(db_->Put(WriteOptions(), "key1", "val1"));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+  ASSERT_OK(db_->Put(WriteOptions(), "key2", "val2"));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+  std::vector<LiveFileMetaData> level_files;
+  db_->GetLiveFilesMetaData(&level_files);
+  ASSERT_EQ(2, level_files.size());
+  ASSERT_OK(db_->CompactFiles(CompactionOptions(),
+                              {level_files[0].name, level_files[1].name}, 1));
+
+  auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(
+                 db_->DefaultColumnFamily())
+                 ->cfd();
+  auto& l1_files = cfd->current()->storage_info()->LevelFiles(1);
+  ASSERT_EQ(1, l1_files.size());
+  ASSERT_TRUE(l1_files[0]->prop.is_map_sst());
+
+  ASSERT_OK(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a", "z"));
+  std::string value;
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key1", &value).IsNotFound());
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key2", &value).IsNotFound());
+  ASSERT_EQ(2, TestGetTickerCount(opts, GET_SKIP_FILE_BY_RANGE_DEL));
+}
+
+TEST_F(DBRangeDelTest, GetMergeOperandOverSstCoveredByTombstone) {
+  Options opts = CurrentOptions();
+  opts.statistics = CreateDBStatistics();
+  opts.merge_operator = MergeOperators::CreateUInt64AddOperator();
+  DestroyAndReopen(opts);
+
+  std::string val;
+  for (int i = 1; i <= 2; ++i) {
+    val.clear();
+    PutFixed64(&val, i);
+    ASSERT_OK(db_->Put(WriteOptions(), "key", val));
+    ASSERT_OK(db_->Flush(FlushOptions()));
+  }
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "key",
+                             "key_"));
+  val.clear();
+  PutFixed64(&val, 5);
+  ASSERT_OK(db_->Merge(WriteOptions(), "key", val));
+  ASSERT_OK(db_->Flush(FlushOptions()));
+
+  // The operand is applied to no base value once the covered files are hit
+  std::string expected, actual;
+  ASSERT_OK(db_->Get(ReadOptions(), "key", &actual));
+  PutFixed64(&expected, 5);
+  ASSERT_EQ(expected, actual);
+  ASSERT_EQ(1, TestGetTickerCount(opts, GET_SKIP_FILE_BY_RANGE_DEL));
+}
+
 TEST_F(DBRangeDelTest, GetCoveredMergeOperandFromMemtable) {
   const int kNumMergeOps = 10;
   Options opts = CurrentOptions();
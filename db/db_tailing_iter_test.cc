@@ -530,6 +530,172 @@ TEST_F(DBTestTailingIterator, SeekToFirstWithUpperBoundBug) {
   ASSERT_EQ(iter->key().ToString(), "aa");
 }
 
+TEST_F(DBTestTailingIterator, TailingIteratorKeepsMemtablesOnCompaction) {
+  ReadOptions read_options;
+  read_options.tailing = true;
+
+  ASSERT_OK(db_->Put(WriteOptions(), "a", "1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->Put(WriteOptions(), "b", "2"));
+  ASSERT_OK(Flush());
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  iter->Seek("a");
+  ASSERT_TRUE(iter->Valid());
+
+  int num_kept = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ForwardIterator::RenewIterators:KeepMemtables",
+      [&](void* /*arg*/) { ++num_kept; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->Put(WriteOptions(), "c", "3"));
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+
+  iter->Seek("a");
+  ASSERT_EQ(1, num_kept);
+  for (auto key : {"a", "b", "c"}) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key, iter->key().ToString());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+namespace {
+class CountingNewDataCallback : public NewDataCallback {
+ public:
+  void OnNewData(const Status& s, SequenceNumber seq) override {
+    status = s;
+    last_seq = seq;
+    ++count;
+  }
+
+  Status status;
+  SequenceNumber last_seq = 0;
+  int count = 0;
+};
+}  // namespace
+
+TEST_F(DBTestTailingIterator, NewDataCallbackRange) {
+  CountingNewDataCallback callback;
+  Slice begin("b");
+  Slice end("d");
+  SequenceNumber seq = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(), seq,
+                                         &begin, &end, &callback));
+  ASSERT_TRUE(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(), seq,
+                                           &begin, &end, &callback)
+                  .IsInvalidArgument());
+
+  // Outside of [b, d)
+  ASSERT_OK(Put("a", "1"));
+  ASSERT_OK(Put("d", "1"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "b"));
+  ASSERT_EQ(0, callback.count);
+
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("e", "1"));
+  ASSERT_OK(batch.Put("c", "1"));
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(1, callback.count);
+  ASSERT_OK(callback.status);
+  ASSERT_EQ(db_->GetLatestSequenceNumber(), callback.last_seq);
+  ASSERT_FALSE(db_->UnregisterNewDataCallback(&callback));
+
+  // A range deletion that overlaps
+  seq = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(), seq,
+                                         &begin, &end, &callback));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "c"));
+  ASSERT_EQ(2, callback.count);
+
+  // Behind the DB already, called right away
+  ASSERT_OK(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(), seq,
+                                         nullptr, nullptr, &callback));
+  ASSERT_EQ(3, callback.count);
+
+  // Unregistered callbacks are not called
+  seq = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(), seq,
+                                         nullptr, nullptr, &callback));
+  ASSERT_TRUE(db_->UnregisterNewDataCallback(&callback));
+  ASSERT_OK(Put("c", "2"));
+  ASSERT_EQ(3, callback.count);
+
+  // Closing the DB calls the rest
+  ASSERT_OK(db_->RegisterNewDataCallback(db_->DefaultColumnFamily(),
+                                         db_->GetLatestSequenceNumber(),
+                                         nullptr, nullptr, &callback));
+  Close();
+  ASSERT_EQ(4, callback.count);
+  ASSERT_TRUE(callback.status.IsShutdownInProgress());
+}
+
+TEST_F(DBTestTailingIterator, NewDataCallbackColumnFamily) {
+  CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
+  CountingNewDataCallback callback;
+  ASSERT_OK(db_->RegisterNewDataCallback(handles_[1],
+                                         db_->GetLatestSequenceNumber(),
+                                         nullptr, nullptr, &callback));
+  ASSERT_OK(Put(0, "a", "1"));
+  ASSERT_EQ(0, callback.count);
+  ASSERT_OK(Put(1, "a", "1"));
+  ASSERT_EQ(1, callback.count);
+}
+
+TEST_F(DBTestTailingIterator, WaitForNewData) {
+  ReadOptions read_options;
+  read_options.tailing = true;
+  Slice begin("k");
+  Slice end("l");
+
+  ASSERT_TRUE(db_->WaitForNewData(db_->DefaultColumnFamily(),
+                                  db_->GetLatestSequenceNumber(), &begin, &end,
+                                  1000 /* timeout_micros */)
+                  .IsTimedOut());
+
+  // A consumer tails [k, l) while keys are written in and around it
+  const size_t kNumKeys = 1000;
+  std::vector<std::string> seen;
+  port::Thread consumer([&]() {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    std::string next = begin.ToString();
+    while (seen.size() < kNumKeys) {
+      SequenceNumber seq = db_->GetLatestSequenceNumber();
+      for (iter->Seek(next); iter->Valid() && iter->key().compare(end) < 0;
+           iter->Next()) {
+        seen.push_back(iter->key().ToString());
+        next = seen.back() + '\0';
+      }
+      ASSERT_OK(iter->status());
+      if (seen.size() < kNumKeys) {
+        ASSERT_OK(db_->WaitForNewData(db_->DefaultColumnFamily(), seq, &begin,
+                                      &end));
+      }
+    }
+  });
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%06d", static_cast<int>(i));
+    ASSERT_OK(Put(std::string("j") + buf, "v"));
+    ASSERT_OK(Put(std::string("k") + buf, "v"));
+    ASSERT_OK(Put(std::string("l") + buf, "v"));
+    if (i % 300 == 0) {
+      ASSERT_OK(Flush());
+    }
+  }
+  consumer.join();
+  ASSERT_EQ(kNumKeys, seen.size());
+  ASSERT_EQ("k000000", seen.front());
+  ASSERT_EQ("k000999", seen.back());
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 #endif  // !defined(ROCKSDB_LITE)
@@ -14,10 +14,12 @@
 #include <inttypes.h>
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "db/version_edit.h"
+#include "port/port.h"
 #include "rocksdb/terark_namespace.h"
 #include "table/merging_iterator.h"
 #include "table/scoped_arena_iterator.h"
@@ -37,13 +39,13 @@ Status ExternalSstFileIngestionJob::Prepare(
   Status status;
 
   // Read the information of files we are ingesting
-  for (const std::string& file_path : external_files_paths) {
-    IngestedFileInfo file_to_ingest;
-    status = GetIngestedFileInfo(file_path, &file_to_ingest, sv);
-    if (!status.ok()) {
-      return status;
-    }
-    files_to_ingest_.push_back(file_to_ingest);
+  files_to_ingest_.resize(external_files_paths.size());
+  status = ParallelForEachFile(files_to_ingest_.size(), [&](size_t i) {
+    return GetIngestedFileInfo(external_files_paths[i], &files_to_ingest_[i],
+                               sv);
+  });
+  if (!status.ok()) {
+    return status;
   }
 
   for (const IngestedFileInfo& f : files_to_ingest_) {
@@ -90,38 +92,41 @@ Status ExternalSstFileIngestionJob::Prepare(
   // Copy/Move external files into DB
   for (IngestedFileInfo& f : files_to_ingest_) {
     f.fd = FileDescriptor(next_file_number++, 0, f.file_size);
-
+  }
+  status = ParallelForEachFile(files_to_ingest_.size(), [&](size_t i) {
+    IngestedFileInfo& f = files_to_ingest_[i];
     const std::string path_outside_db = f.external_file_path;
     const std::string path_inside_db = TableFileName(
         cfd_->ioptions()->cf_paths, f.fd.GetNumber(), f.fd.GetPathId());
 
+    Status s;
     if (ingestion_options_.move_files) {
-      status = env_->LinkFile(path_outside_db, path_inside_db);
-      if (status.IsNotSupported()) {
+      s = env_->LinkFile(path_outside_db, path_inside_db);
+      if (s.IsNotSupported()) {
         // Original file is on a different FS, use copy instead of hard linking
-        status = CopyFile(env_, path_outside_db, path_inside_db, 0,
-                          db_options_.use_fsync);
+        s = CopyFile(env_, path_outside_db, path_inside_db, 0,
+                     db_options_.use_fsync);
         f.copy_file = true;
       } else {
         f.copy_file = false;
       }
     } else {
-      status = CopyFile(env_, path_outside_db, path_inside_db, 0,
-                        db_options_.use_fsync);
+      s = CopyFile(env_, path_outside_db, path_inside_db, 0,
+                   db_options_.use_fsync);
       f.copy_file = true;
     }
     TEST_SYNC_POINT("ExternalSstFileIngestionJob::Prepare:FileAdded");
-    if (!status.ok()) {
-      break;
+    if (s.ok()) {
+      f.internal_file_path = path_inside_db;
     }
-    f.internal_file_path = path_inside_db;
-  }
+    return s;
+  });
 
   if (!status.ok()) {
     // We failed, remove all files that we copied into the db
     for (IngestedFileInfo& f : files_to_ingest_) {
       if (f.internal_file_path.empty()) {
-        break;
+        continue;
       }
       Status s = env_->DeleteFile(f.internal_file_path);
       if (!s.ok()) {
@@ -290,6 +295,75 @@ void ExternalSstFileIngestionJob::Cleanup(const Status& status) {
   }
 }
 
+void ExternalSstFileIngestionJob::WarmTableCache(SuperVersion* super_version) {
+  std::unordered_set<uint64_t> file_numbers;
+  std::unordered_set<int> levels;
+  for (const IngestedFileInfo& f : files_to_ingest_) {
+    file_numbers.insert(f.fd.GetNumber());
+    levels.insert(f.picked_level);
+  }
+  auto* vstorage = super_version->current->storage_info();
+  std::vector<std::pair<FileMetaData*, int>> files_meta;
+  for (int level : levels) {
+    for (auto* file_meta : vstorage->LevelFiles(level)) {
+      if (file_numbers.count(file_meta->fd.GetNumber()) > 0) {
+        files_meta.emplace_back(file_meta, level);
+      }
+    }
+  }
+  ParallelForEachFile(files_meta.size(), [&](size_t i) {
+    auto* file_meta = files_meta[i].first;
+    int level = files_meta[i].second;
+    Cache::Handle* handle = nullptr;
+    Status s = cfd_->table_cache()->FindTable(
+        env_options_, cfd_->internal_comparator(), file_meta->fd, &handle,
+        super_version->mutable_cf_options.prefix_extractor.get(),
+        false /* no_io */, true /* record_read_stats */,
+        cfd_->internal_stats()->GetFileReadHist(level),
+        false /* skip_filters */, level);
+    if (handle != nullptr) {
+      cfd_->table_cache()->ReleaseHandle(handle);
+    }
+    return s;
+  });
+}
+
+Status ExternalSstFileIngestionJob::ParallelForEachFile(
+    size_t count, const std::function<Status(size_t)>& func) {
+  std::vector<Status> statuses(count);
+  std::atomic<size_t> next_idx(0);
+  std::atomic<bool> failed(false);
+  std::function<void()> work([&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      size_t idx = next_idx.fetch_add(1);
+      if (idx >= count) {
+        break;
+      }
+      statuses[idx] = func(idx);
+      if (!statuses[idx].ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  std::vector<port::Thread> threads;
+  size_t max_threads =
+      std::min<size_t>(std::max(ingestion_options_.max_threads, 1), count);
+  for (size_t i = 1; i < max_threads; i++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& s : statuses) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
     const std::string& external_file, IngestedFileInfo* file_to_ingest,
     SuperVersion* sv) {
@@ -345,6 +419,17 @@ Status ExternalSstFileIngestionJob::GetIngestedFileInfo(
     return status;
   }
 
+  if (ingestion_options_.verify_checksums_before_ingest) {
+    status = table_reader->VerifyChecksum();
+    // Table formats without block checksums have nothing to verify
+    if (status.IsNotSupported()) {
+      status = Status::OK();
+    }
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   // Get the external file properties
   auto props = table_reader->GetTableProperties();
   const auto& uprops = props->user_collected_properties;
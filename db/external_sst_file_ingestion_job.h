@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #pragma once
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -110,6 +111,12 @@ class ExternalSstFileIngestionJob {
   // Cleanup after successful/failed job
   void Cleanup(const Status& status);
 
+  // Load the table readers of the ingested files into the table cache.
+  // @param super_version A referenced SuperVersion that includes the
+  //    ingested files.
+  // REQUIRES: Mutex not held, job installed successfully
+  void WarmTableCache(SuperVersion* super_version);
+
   VersionEdit* edit() { return &edit_; }
 
   const autovector<IngestedFileInfo>& files_to_ingest() const {
@@ -142,6 +149,11 @@ class ExternalSstFileIngestionJob {
   Status AssignGlobalSeqnoForIngestedFile(IngestedFileInfo* file_to_ingest,
                                           SequenceNumber seqno);
 
+  // Run `func` for [0, count) on up to ingestion_options_.max_threads threads,
+  // no new index is started once one failed. Returns the first error by index.
+  Status ParallelForEachFile(size_t count,
+                             const std::function<Status(size_t)>& func);
+
   // Check if `file_to_ingest` can fit in level `level`
   // REQUIRES: Mutex held
   bool IngestedFileFitInLevel(const IngestedFileInfo* file_to_ingest,
@@ -2214,6 +2214,120 @@ TEST_F(ExternalSSTFileTest, SkipBloomFilter) {
   }
 }
 
+TEST_F(ExternalSSTFileTest, BulkLoader) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+
+  SstFileBulkLoaderOptions bulk_load_options;
+  bulk_load_options.path = sst_files_dir_;
+  bulk_load_options.num_threads = 3;
+  bulk_load_options.target_file_size = 4 << 10;
+  bulk_load_options.max_pending_files = 2;
+
+  const int kNumKeys = 10000;
+  std::vector<ExternalSstFileInfo> file_info;
+  {
+    SstFileBulkLoader loader(EnvOptions(), options, bulk_load_options);
+    for (int k = 0; k < kNumKeys; k++) {
+      if (k % 100 == 99) {
+        ASSERT_OK(loader.Delete(Key(k)));
+      } else {
+        ASSERT_OK(loader.Put(Key(k), Key(k) + "_val"));
+      }
+    }
+    // Keys must be added in order
+    ASSERT_TRUE(loader.Put(Key(0), "bad_val").IsInvalidArgument());
+    ASSERT_OK(loader.Finish(&file_info));
+    ASSERT_TRUE(loader.Put(Key(kNumKeys), "bad_val").IsInvalidArgument());
+  }
+  ASSERT_GT(file_info.size(), bulk_load_options.num_threads);
+
+  std::vector<std::string> files;
+  uint64_t num_entries = 0;
+  for (size_t i = 0; i < file_info.size(); i++) {
+    if (i > 0) {
+      ASSERT_LT(file_info[i - 1].largest_key, file_info[i].smallest_key);
+    }
+    num_entries += file_info[i].num_entries;
+    files.push_back(file_info[i].file_path);
+  }
+  ASSERT_EQ(kNumKeys, num_entries);
+
+  ASSERT_OK(db_->IngestExternalFile(files, IngestExternalFileOptions()));
+  ASSERT_EQ(static_cast<int>(files.size()),
+            NumTableFilesAtLevel(options.num_levels - 1));
+  for (int k = 0; k < kNumKeys; k++) {
+    ASSERT_EQ(k % 100 == 99 ? "NOT_FOUND" : Key(k) + "_val", Get(Key(k)));
+  }
+
+  // Files are removed when the load is abandoned
+  bulk_load_options.file_prefix = "abandoned_";
+  {
+    SstFileBulkLoader loader(EnvOptions(), options, bulk_load_options);
+    for (int k = 0; k < kNumKeys; k++) {
+      ASSERT_OK(loader.Put(Key(k), Key(k) + "_val"));
+    }
+  }
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(sst_files_dir_, &children));
+  for (auto& child : children) {
+    ASSERT_NE(0, child.compare(0, 10, "abandoned_")) << child;
+  }
+}
+
+TEST_F(ExternalSSTFileTest, ParallelIngestAndWarmTableCache) {
+  Options options = CurrentOptions();
+  options.table_factory.reset(NewBlockBasedTableFactory());
+  options.statistics = TERARKDB_NAMESPACE::CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  const int kNumFiles = 20;
+  const int kKeysPerFile = 50;
+  std::vector<std::string> files;
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  for (int i = 0; i < kNumFiles; i++) {
+    files.push_back(sst_files_dir_ + ToString(i) + ".sst");
+    ASSERT_OK(sst_file_writer.Open(files.back()));
+    for (int k = i * kKeysPerFile; k < (i + 1) * kKeysPerFile; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), Key(k) + "_val"));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+  }
+
+  // A corrupted block fails the whole batch when checksums are verified
+  std::string corrupted_file = sst_files_dir_ + "corrupted.sst";
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, files[7], &contents));
+  contents[20] ^= 0x55;
+  ASSERT_OK(WriteStringToFile(env_, contents, corrupted_file));
+  std::vector<std::string> corrupted_files = files;
+  corrupted_files[7] = corrupted_file;
+
+  IngestExternalFileOptions ifo;
+  ifo.move_files = true;
+  ifo.verify_checksums_before_ingest = true;
+  ifo.max_threads = 4;
+  ifo.warm_table_cache = true;
+  ASSERT_TRUE(db_->IngestExternalFile(corrupted_files, ifo).IsCorruption());
+  for (auto& file : files) {
+    ASSERT_OK(env_->FileExists(file));
+  }
+
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+  // Moved files are linked into the DB, the originals are removed
+  for (auto& file : files) {
+    ASSERT_TRUE(env_->FileExists(file).IsNotFound());
+  }
+  // Every ingested file was opened once when warming the table cache
+  ASSERT_EQ(kNumFiles,
+            options.statistics->getTickerCount(Tickers::NO_FILE_OPENS));
+  for (int k = 0; k < kNumFiles * kKeysPerFile; k++) {
+    ASSERT_EQ(Key(k) + "_val", Get(Key(k)));
+  }
+  ASSERT_EQ(kNumFiles,
+            options.statistics->getTickerCount(Tickers::NO_FILE_OPENS));
+}
+
 TEST_P(ExternalSSTFileTest, DeltaEncodingWhileGlobalSeqnoPresents) {
   Options options = CurrentOptions();
   DestroyAndReopen(options);
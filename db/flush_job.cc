@@ -102,7 +102,8 @@ FlushJob::FlushJob(
     LogBuffer* log_buffer, Directory* db_directory,
     Directory* output_file_directory, CompressionType output_compression,
     Statistics* stats, EventLogger* event_logger, bool measure_io_stats,
-    bool sync_output_directory, bool write_manifest, double flush_load)
+    bool sync_output_directory, bool write_manifest, double flush_load,
+    PerfSampler* perf_sampler)
     : dbname_(dbname),
       cfd_(cfd),
       db_options_(db_options),
@@ -126,6 +127,7 @@ FlushJob::FlushJob(
       sync_output_directory_(sync_output_directory),
       write_manifest_(write_manifest),
       flush_load_(flush_load),
+      perf_sampler_(perf_sampler),
       edit_(nullptr),
       base_(nullptr),
       pick_memtable_called_(false),
@@ -319,125 +321,139 @@ Status FlushJob::WriteLevel0Table() {
   {
     auto write_hint = cfd_->CalculateSSTWriteHint(0);
     db_mutex_->Unlock();
-    if (log_buffer_) {
-      log_buffer_->FlushBufferToLog();
-    }
-    // memtables and range_del_iters store internal iterators over each data
-    // memtable and its associated range deletion memtable, respectively, at
-    // corresponding indexes.
-    ReadOptions ro;
-    ro.total_order_seek = true;
-    Arena arena;
-    uint64_t total_num_entries = 0, total_num_deletes = 0;
-    size_t total_memory_usage = 0;
-    for (MemTable* m : mems_) {
-      ROCKS_LOG_INFO(
-          db_options_.info_log,
-          "[%s] [JOB %d] Flushing memtable with next log file: %" PRIu64 "\n",
-          cfd_->GetName().c_str(), job_context_->job_id, m->GetNextLogNumber());
-      total_num_entries += m->num_entries();
-      total_num_deletes += m->num_deletes();
-      total_memory_usage += m->ApproximateMemoryUsage();
-    }
-
-    event_logger_->Log() << "job" << job_context_->job_id << "event"
-                         << "flush_started"
-                         << "num_memtables" << mems_.size() << "num_entries"
-                         << total_num_entries << "num_deletes"
-                         << total_num_deletes << "memory_usage"
-                         << total_memory_usage << "flush_reason"
-                         << GetFlushReasonString(cfd_->GetFlushReason());
-
+    // Sampled only while the mutex is released, listeners may be notified
     {
-      ROCKS_LOG_INFO(db_options_.info_log,
-                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
-                     cfd_->GetName().c_str(), job_context_->job_id,
-                     meta_[0].fd.GetNumber());
-
-      TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
-                               &output_compression_);
-      int64_t _current_time = 0;
-      auto status = db_options_.env->GetCurrentTime(&_current_time);
-      // Safe to proceed even if GetCurrentTime fails. So, log and proceed.
-      if (!status.ok()) {
-        ROCKS_LOG_WARN(
+      PerfSampleGuard perf_sample(perf_sampler_,
+                                  PerfSampleOperation::kFlush);
+      if (log_buffer_) {
+        log_buffer_->FlushBufferToLog();
+      }
+      // memtables and range_del_iters store internal iterators over each data
+      // memtable and its associated range deletion memtable, respectively, at
+      // corresponding indexes.
+      ReadOptions ro;
+      ro.total_order_seek = true;
+      Arena arena;
+      uint64_t total_num_entries = 0, total_num_deletes = 0;
+      size_t total_memory_usage = 0;
+      for (MemTable* m : mems_) {
+        ROCKS_LOG_INFO(
             db_options_.info_log,
-            "Failed to get current time to populate creation_time property. "
-            "Status: %s",
-            status.ToString().c_str());
+            "[%s] [JOB %d] Flushing memtable with next log file: %" PRIu64 "\n",
+            cfd_->GetName().c_str(), job_context_->job_id,
+            m->GetNextLogNumber());
+        total_num_entries += m->num_entries();
+        total_num_deletes += m->num_deletes();
+        total_memory_usage += m->ApproximateMemoryUsage();
       }
-      const uint64_t current_time = static_cast<uint64_t>(_current_time);
 
-      uint64_t oldest_key_time = mems_.front()->ApproximateOldestKeyTime();
+      event_logger_->Log() << "job" << job_context_->job_id << "event"
+                           << "flush_started"
+                           << "num_memtables" << mems_.size() << "num_entries"
+                           << total_num_entries << "num_deletes"
+                           << total_num_deletes << "memory_usage"
+                           << total_memory_usage << "flush_reason"
+                           << GetFlushReasonString(cfd_->GetFlushReason());
 
-      auto get_arena_input_iter = [&](Arena& arena) {
-        auto memtables =
-            new (arena.AllocateAligned(sizeof(std::vector<InternalIterator*>)))
-                std::vector<InternalIterator*>();
-        for (MemTable* m : mems_) {
-          memtables->push_back(m->NewIterator(ro, &arena));
+      {
+        ROCKS_LOG_INFO(
+            db_options_.info_log,
+            "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
+            cfd_->GetName().c_str(), job_context_->job_id,
+            meta_[0].fd.GetNumber());
+
+        TEST_SYNC_POINT_CALLBACK(
+            "FlushJob::WriteLevel0Table:output_compression",
+            &output_compression_);
+        int64_t _current_time = 0;
+        auto status = db_options_.env->GetCurrentTime(&_current_time);
+        // Safe to proceed even if GetCurrentTime fails. So, log and proceed.
+        if (!status.ok()) {
+          ROCKS_LOG_WARN(
+              db_options_.info_log,
+              "Failed to get current time to populate creation_time property. "
+              "Status: %s",
+              status.ToString().c_str());
         }
-        auto input =
-            NewMergingIterator(&cfd_->internal_comparator(), memtables->data(),
-                               static_cast<int>(memtables->size()), &arena);
-        input->RegisterCleanup(
-            [](void* arg1, void* /*arg2*/) {
-              auto ptr =
-                  reinterpret_cast<std::vector<InternalIterator*>*>(arg1);
-              ptr->~vector();
-            },
-            memtables, nullptr);
-        return input;
-      };
-      auto get_range_del_iters = [&] {
-        std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
-            range_del_iters;
-        for (MemTable* m : mems_) {
-          auto* range_del_iter =
-              m->NewRangeTombstoneIterator(ro, kMaxSequenceNumber);
-          if (range_del_iter != nullptr) {
-            range_del_iters.emplace_back(range_del_iter);
+        const uint64_t current_time = static_cast<uint64_t>(_current_time);
+
+        uint64_t oldest_key_time = mems_.front()->ApproximateOldestKeyTime();
+
+        auto get_arena_input_iter = [&](Arena& arena) {
+          auto memtables = new (
+              arena.AllocateAligned(sizeof(std::vector<InternalIterator*>)))
+              std::vector<InternalIterator*>();
+          for (MemTable* m : mems_) {
+            memtables->push_back(m->NewIterator(ro, &arena));
+          }
+          auto input = NewMergingIterator(
+              &cfd_->internal_comparator(), memtables->data(),
+              static_cast<int>(memtables->size()), &arena,
+              false /* prefix_seek_mode */,
+              cfd_->ioptions()->use_loser_tree_merging_iterator);
+          input->RegisterCleanup(
+              [](void* arg1, void* /*arg2*/) {
+                auto ptr =
+                    reinterpret_cast<std::vector<InternalIterator*>*>(arg1);
+                ptr->~vector();
+              },
+              memtables, nullptr);
+          return input;
+        };
+        auto get_range_del_iters = [&] {
+          std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
+              range_del_iters;
+          for (MemTable* m : mems_) {
+            auto* range_del_iter =
+                m->NewRangeTombstoneIterator(ro, kMaxSequenceNumber);
+            if (range_del_iter != nullptr) {
+              range_del_iters.emplace_back(range_del_iter);
+            }
           }
+          return range_del_iters;
+        };
+        s = BuildTable(
+            dbname_, versions_, db_options_.env, *cfd_->ioptions(),
+            mutable_cf_options_, env_options_, cfd_->table_cache(),
+            c_style_callback(get_arena_input_iter), &get_arena_input_iter,
+            c_style_callback(get_range_del_iters), &get_range_del_iters, &meta_,
+            cfd_->internal_comparator(),
+            cfd_->int_tbl_prop_collector_factories(mutable_cf_options_),
+            cfd_->int_tbl_prop_collector_factories_for_blob(
+                mutable_cf_options_),
+            cfd_->GetID(), cfd_->GetName(), existing_snapshots_,
+            earliest_write_conflict_snapshot_, snapshot_checker_,
+            output_compression_, cfd_->ioptions()->compression_opts,
+            mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
+            TableFileCreationReason::kFlush, event_logger_,
+            job_context_->job_id, Env::IO_HIGH, &table_properties_,
+            0 /* level */, flush_load_, current_time, oldest_key_time,
+            write_hint);
+        if (s.ok() && cfd_->ioptions()->ttl_extractor_factory != nullptr) {
+          ROCKS_LOG_INFO(db_options_.info_log,
+                         "FlushOutput earliest_time_begin_compact = %" PRIu64
+                         ", latest_time_end_compact = %" PRIu64,
+                         meta_[0].prop.earliest_time_begin_compact,
+                         meta_[0].prop.latest_time_end_compact);
         }
-        return range_del_iters;
-      };
-      s = BuildTable(
-          dbname_, versions_, db_options_.env, *cfd_->ioptions(),
-          mutable_cf_options_, env_options_, cfd_->table_cache(),
-          c_style_callback(get_arena_input_iter), &get_arena_input_iter,
-          c_style_callback(get_range_del_iters), &get_range_del_iters, &meta_,
-          cfd_->internal_comparator(),
-          cfd_->int_tbl_prop_collector_factories(mutable_cf_options_),
-          cfd_->int_tbl_prop_collector_factories_for_blob(mutable_cf_options_),
-          cfd_->GetID(), cfd_->GetName(), existing_snapshots_,
-          earliest_write_conflict_snapshot_, snapshot_checker_,
-          output_compression_, cfd_->ioptions()->compression_opts,
-          mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
-          TableFileCreationReason::kFlush, event_logger_, job_context_->job_id,
-          Env::IO_HIGH, &table_properties_, 0 /* level */, flush_load_,
-          current_time, oldest_key_time, write_hint);
-      if (s.ok() && cfd_->ioptions()->ttl_extractor_factory != nullptr) {
-        ROCKS_LOG_INFO(db_options_.info_log,
-                       "FlushOutput earliest_time_begin_compact = %" PRIu64
-                       ", latest_time_end_compact = %" PRIu64,
-                       meta_[0].prop.earliest_time_begin_compact,
-                       meta_[0].prop.latest_time_end_compact);
-      }
 
-      LogFlush(db_options_.info_log);
-    }
-    ROCKS_LOG_INFO_IF_OK(
-        s, db_options_.info_log,
-        "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
-        " bytes %s%s",
-        cfd_->GetName().c_str(), job_context_->job_id, meta_[0].fd.GetNumber(),
-        meta_[0].fd.GetFileSize(), s.ToString().c_str(),
-        meta_[0].marked_for_compaction ? " (needs compaction)" : "");
-
-    if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
-      s = output_file_directory_->Fsync();
+        LogFlush(db_options_.info_log);
+      }
+      ROCKS_LOG_INFO_IF_OK(
+          s, db_options_.info_log,
+          "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+          " bytes %s%s",
+          cfd_->GetName().c_str(), job_context_->job_id,
+          meta_[0].fd.GetNumber(), meta_[0].fd.GetFileSize(),
+          s.ToString().c_str(),
+          meta_[0].marked_for_compaction ? " (needs compaction)" : "");
+
+      if (s.ok() && output_file_directory_ != nullptr &&
+          sync_output_directory_) {
+        s = output_file_directory_->Fsync();
+      }
+      TEST_SYNC_POINT("FlushJob::WriteLevel0Table");
     }
-    TEST_SYNC_POINT("FlushJob::WriteLevel0Table");
     db_mutex_->Lock();
   }
   base_->Unref();
@@ -29,6 +29,7 @@
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "monitoring/instrumented_mutex.h"
+#include "monitoring/perf_sampler.h"
 #include "options/db_options.h"
 #include "port/port.h"
 #include "rocksdb/db.h"
@@ -69,7 +70,8 @@ class FlushJob {
            LogBuffer* log_buffer, Directory* db_directory,
            Directory* output_file_directory, CompressionType output_compression,
            Statistics* stats, EventLogger* event_logger, bool measure_io_stats,
-           bool sync_output_directory, bool write_manifest, double flush_load);
+           bool sync_output_directory, bool write_manifest, double flush_load,
+           PerfSampler* perf_sampler = nullptr);
 
   ~FlushJob();
 
@@ -137,6 +139,7 @@ class FlushJob {
 
   //
   const double flush_load_;
+  PerfSampler* perf_sampler_;
 
   // Variables below are set by PickMemTable():
   std::vector<FileMetaData> meta_;
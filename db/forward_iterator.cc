@@ -581,16 +581,24 @@ void ForwardIterator::RenewIterators() {
   assert(sv_);
   svnew = cfd_->GetReferencedSuperVersion(db_);
 
-  if (mutable_iter_ != nullptr) {
-    DeleteIterator(mutable_iter_, true /* is_arena */);
-  }
-  for (auto* m : imm_iters_) {
-    DeleteIterator(m, true /* is_arena */);
-  }
-  imm_iters_.clear();
+  // A compaction installs a new SuperVersion with the same memtables, their
+  // iterators see new writes anyway and are kept. They live in arena_, so
+  // this also keeps a long running tailing iterator from growing it.
+  if (svnew->mem != sv_->mem || svnew->imm != sv_->imm) {
+    if (mutable_iter_ != nullptr) {
+      DeleteIterator(mutable_iter_, true /* is_arena */);
+    }
+    for (auto* m : imm_iters_) {
+      DeleteIterator(m, true /* is_arena */);
+    }
+    imm_iters_.clear();
 
-  mutable_iter_ = svnew->mem->NewIterator(read_options_, &arena_);
-  svnew->imm->AddIterators(read_options_, &imm_iters_, &arena_);
+    mutable_iter_ = svnew->mem->NewIterator(read_options_, &arena_);
+    svnew->imm->AddIterators(read_options_, &imm_iters_, &arena_);
+  } else {
+    TEST_SYNC_POINT_CALLBACK("ForwardIterator::RenewIterators:KeepMemtables",
+                             this);
+  }
   ReadRangeDelAggregator range_del_agg(&cfd_->internal_comparator(),
                                        kMaxSequenceNumber /* upper_bound */);
   if (!read_options_.ignore_range_deletions) {
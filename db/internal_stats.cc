@@ -255,6 +255,7 @@ static const std::string total_sst_files_size = "total-sst-files-size";
 static const std::string live_sst_files_size = "live-sst-files-size";
 static const std::string estimate_pending_comp_bytes =
     "estimate-pending-compaction-bytes";
+static const std::string blob_garbage_ratio = "blob-garbage-ratio";
 static const std::string aggregated_table_properties =
     "aggregated-table-properties";
 static const std::string aggregated_table_properties_at_level =
@@ -268,6 +269,12 @@ static const std::string block_cache_capacity = "block-cache-capacity";
 static const std::string block_cache_usage = "block-cache-usage";
 static const std::string block_cache_pinned_usage = "block-cache-pinned-usage";
 static const std::string options_statistics = "options-statistics";
+static const std::string perf_samples = "perf-samples";
+static const std::string background_scheduler_stats =
+    "background-scheduler-stats";
+static const std::string estimated_write_debt_bytes =
+    "estimated-write-debt-bytes";
+static const std::string write_controller_stats = "write-controller-stats";
 
 const std::string DB::Properties::kNumFilesAtLevelPrefix =
     rocksdb_prefix + num_files_at_level_prefix;
@@ -337,6 +344,8 @@ const std::string DB::Properties::kLiveSstFilesSize =
 const std::string DB::Properties::kBaseLevel = rocksdb_prefix + base_level_str;
 const std::string DB::Properties::kEstimatePendingCompactionBytes =
     rocksdb_prefix + estimate_pending_comp_bytes;
+const std::string DB::Properties::kBlobGarbageRatio =
+    rocksdb_prefix + blob_garbage_ratio;
 const std::string DB::Properties::kAggregatedTableProperties =
     rocksdb_prefix + aggregated_table_properties;
 const std::string DB::Properties::kAggregatedTablePropertiesAtLevel =
@@ -353,6 +362,13 @@ const std::string DB::Properties::kBlockCachePinnedUsage =
     rocksdb_prefix + block_cache_pinned_usage;
 const std::string DB::Properties::kOptionsStatistics =
     rocksdb_prefix + options_statistics;
+const std::string DB::Properties::kPerfSamples = rocksdb_prefix + perf_samples;
+const std::string DB::Properties::kBackgroundSchedulerStats =
+    rocksdb_prefix + background_scheduler_stats;
+const std::string DB::Properties::kEstimatedWriteDebtBytes =
+    rocksdb_prefix + estimated_write_debt_bytes;
+const std::string DB::Properties::kWriteControllerStats =
+    rocksdb_prefix + write_controller_stats;
 
 const std::unordered_map<std::string, DBPropertyInfo>
     InternalStats::ppt_name_to_info = {
@@ -379,6 +395,9 @@ const std::unordered_map<std::string, DBPropertyInfo>
          {false, &InternalStats::HandleDBStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kSSTables,
          {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
+        {DB::Properties::kBlobGarbageRatio,
+         {false, &InternalStats::HandleBlobGarbageRatio, nullptr, nullptr,
+          nullptr}},
         {DB::Properties::kAggregatedTableProperties,
          {false, &InternalStats::HandleAggregatedTableProperties, nullptr,
           nullptr, nullptr}},
@@ -486,6 +505,18 @@ const std::unordered_map<std::string, DBPropertyInfo>
         {DB::Properties::kOptionsStatistics,
          {false, nullptr, nullptr, nullptr,
           &DBImpl::GetPropertyHandleOptionsStatistics}},
+        {DB::Properties::kPerfSamples,
+         {false, nullptr, nullptr, nullptr,
+          &DBImpl::GetPropertyHandlePerfSamples}},
+        {DB::Properties::kBackgroundSchedulerStats,
+         {false, nullptr, nullptr, nullptr,
+          &DBImpl::GetPropertyHandleBackgroundSchedulerStats}},
+        {DB::Properties::kEstimatedWriteDebtBytes,
+         {false, nullptr, &InternalStats::HandleEstimatedWriteDebtBytes,
+          nullptr, nullptr}},
+        {DB::Properties::kWriteControllerStats,
+         {false, nullptr, nullptr, nullptr,
+          &DBImpl::GetPropertyHandleWriteControllerStats}},
 };
 
 const DBPropertyInfo* GetPropertyInfo(const Slice& property) {
@@ -561,6 +592,13 @@ bool InternalStats::HandleCompressionRatioAtLevelPrefix(std::string* value,
   return true;
 }
 
+bool InternalStats::HandleBlobGarbageRatio(std::string* value,
+                                           Slice /*suffix*/) {
+  const auto* vstorage = cfd_->current()->storage_info();
+  *value = ToString(vstorage->total_garbage_ratio());
+  return true;
+}
+
 bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   char buf[1000];
   const auto* vstorage = cfd_->current()->storage_info();
@@ -864,6 +902,13 @@ bool InternalStats::HandleActualDelayedWriteRate(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleEstimatedWriteDebtBytes(uint64_t* value,
+                                                  DBImpl* db,
+                                                  Version* /*version*/) {
+  *value = db->write_controller().TotalWriteDebt().total_bytes();
+  return true;
+}
+
 bool InternalStats::HandleIsWriteStopped(uint64_t* value, DBImpl* db,
                                          Version* /*version*/) {
   *value = db->write_controller().IsStopped() ? 1 : 0;
@@ -101,7 +101,9 @@ struct IteratorCacheContext {
     read_options.verify_checksums = true;
     read_options.fill_cache = false;
     read_options.total_order_seek = true;
-    MergeIteratorBuilder builder(&ctx->cfd->internal_comparator(), arena);
+    MergeIteratorBuilder builder(
+        &ctx->cfd->internal_comparator(), arena, false /* prefix_seek_mode */,
+        ctx->cfd->ioptions()->use_loser_tree_merging_iterator);
     ctx->version->AddIterators(read_options, *ctx->env_options, &builder,
                                nullptr /* range_del_agg */);
     return builder.Finish();
@@ -179,7 +179,7 @@ Status MergeHelper::MergeUntil(const Slice& user_key,
       // hit an entry that's visible by the previous snapshot, can't touch that
       break;
     }
-    LazyBuffer val = iter->value(user_key, nullptr);
+    LazyBuffer val = iter->value(user_key, &value_meta_);
 
     // At this point we are guaranteed that we need to process this key.
 
@@ -258,7 +258,8 @@ Status MergeHelper::MergeUntil(const Slice& user_key,
         // write it out, no matter what compaction filter says
       } else if (filter == CompactionFilter::Decision::kKeep) {
         // 2) it's not filtered by a compaction filter
-        filter = FilterMerge(orig_ikey.user_key, val);
+        filter = FilterMerge(orig_ikey.user_key, val, value_meta_,
+                             ikey.type == kTypeMergeIndex);
       }
       if (filter == CompactionFilter::Decision::kKeep ||
           filter == CompactionFilter::Decision::kChangeValue) {
@@ -390,8 +391,15 @@ void MergeOutputIterator::Next() {
   ++it_values_;
 }
 
+const LazyBuffer& MergeHelper::MetaOnlyFilterValue() {
+  static const LazyBuffer value(
+      Status::NotSupported("Value not read for a meta only compaction filter"));
+  return value;
+}
+
 CompactionFilter::Decision MergeHelper::FilterMerge(
-    const Slice& user_key, const LazyBuffer& value_slice) {
+    const Slice& user_key, const LazyBuffer& value_slice,
+    const Slice& value_meta, bool is_index) {
   if (compaction_filter_ == nullptr) {
     return CompactionFilter::Decision::kKeep;
   }
@@ -401,9 +409,11 @@ CompactionFilter::Decision MergeHelper::FilterMerge(
   compaction_filter_value_.clear();
   compaction_filter_skip_until_.Clear();
   auto ret = compaction_filter_->FilterV2(
-      level_, user_key, CompactionFilter::ValueType::kMergeOperand, Slice(),
-      value_slice, &compaction_filter_value_,
-      compaction_filter_skip_until_.rep());
+      level_, user_key, CompactionFilter::ValueType::kMergeOperand, value_meta,
+      is_index && compaction_filter_->IsValueMetaOnly()
+          ? MetaOnlyFilterValue()
+          : value_slice,
+      &compaction_filter_value_, compaction_filter_skip_until_.rep());
   if (ret == CompactionFilter::Decision::kRemoveAndSkipUntil) {
     if (user_comparator_->Compare(*compaction_filter_skip_until_.rep(),
                                   user_key) <= 0) {
@@ -84,12 +84,18 @@ class MergeHelper {
                     const SequenceNumber stop_before = 0,
                     const bool at_bottom = false);
 
+  // Passed to a compaction filter whose IsValueMetaOnly() is true in place of
+  // a separated value, so the blob is never read
+  static const LazyBuffer& MetaOnlyFilterValue();
+
   // Filters a merge operand using the compaction filter specified
   // in the constructor. Returns the decision that the filter made.
   // Uses compaction_filter_value_ and compaction_filter_skip_until_ for the
   // optional outputs of compaction filter.
   CompactionFilter::Decision FilterMerge(const Slice& user_key,
-                                         const LazyBuffer& value);
+                                         const LazyBuffer& value,
+                                         const Slice& value_meta,
+                                         bool is_index);
 
   // Query the merge result
   // These are valid until the next MergeUntil call
@@ -171,6 +177,8 @@ class MergeHelper {
 
   bool has_compaction_filter_skip_until_ = false;
   LazyBuffer compaction_filter_value_;
+  // Meta of the current operand if it is separated
+  std::string value_meta_;
   InternalKey compaction_filter_skip_until_;
 
   bool IsShuttingDown() {
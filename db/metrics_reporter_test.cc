@@ -1,6 +1,7 @@
 #include "rocksdb/metrics_reporter.h"
 
 #include <atomic>
+#include <cmath>
 
 #include "port/stack_trace.h"
 #include "rocksdb/env.h"
@@ -8,6 +9,7 @@
 #include "util/logging.h"
 #include "util/mock_time_env.h"
 #include "util/testharness.h"
+#include "utilities/trace/hdr_metrics_reporter.h"
 
 namespace TERARKDB_NAMESPACE {
 
@@ -71,6 +73,39 @@ TEST_F(MockMetricsReporterTest, Basic) {
   }
   ASSERT_EQ(handler_.LoggerCount(), 1);
 }
+
+TEST(HdrMetricsReporterTest, Basic) {
+  HdrMetricsReporterFactory factory;
+  int log_count = 0;
+  TestLogger logger(&log_count);
+  Env* env = Env::Default();
+
+  auto* hist = factory.BuildHistReporter("latency", "db=1", &logger, env);
+  auto* count = factory.BuildCountReporter("qps", "db=1", &logger, env);
+  // same name and tags share one handle
+  ASSERT_EQ(hist, factory.BuildHistReporter("latency", "db=1", &logger, env));
+  ASSERT_EQ(count, factory.BuildCountReporter("qps", "db=1", &logger, env));
+  ASSERT_NE(hist, factory.BuildHistReporter("latency", "db=2", &logger, env));
+
+  for (size_t i = 1; i <= 10000; ++i) {
+    hist->AddRecord(i);
+    count->AddCount(2);
+  }
+  auto* hdr_hist = factory.GetHistReporter("latency", "db=1");
+  ASSERT_EQ(hdr_hist, hist);
+  HistogramData data;
+  hdr_hist->GetHistogram().Data(&data);
+  ASSERT_EQ(data.count, 10000);
+  ASSERT_EQ(data.max, 10000);
+  ASSERT_LE(std::abs(data.percentile99 - 9900) / 9900, 1.0 / 32);
+  ASSERT_LE(std::abs(data.percentile999 - 9990) / 9990, 1.0 / 32);
+  ASSERT_EQ(factory.GetCountReporter("qps", "db=1")->GetCount(), 20000);
+  ASSERT_EQ(factory.GetHistReporter("latency", "db=3"), nullptr);
+
+  std::string dump = factory.ToString();
+  ASSERT_NE(dump.find("latency [db=1] COUNT : 10000"), std::string::npos);
+  ASSERT_NE(dump.find("qps [db=1] COUNT : 20000"), std::string::npos);
+}
 }  // namespace TERARKDB_NAMESPACE
 int main(int argc, char** argv) {
   TERARKDB_NAMESPACE::port::InstallStackTraceHandler();
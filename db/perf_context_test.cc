@@ -6,13 +6,16 @@
 #include "rocksdb/perf_context.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <vector>
 
 #include "monitoring/histogram.h"
 #include "monitoring/instrumented_mutex.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_sampler.h"
 #include "monitoring/thread_status_util.h"
 #include "port/port.h"
 #include "rocksdb/db.h"
@@ -727,6 +730,82 @@ TEST_F(PerfContextTest, PerfContextByLevelGetSet) {
   ASSERT_NE(std::string::npos,
             zero_excluded.find("bloom_filter_full_true_positive = 1@level2"));
 }
+#ifndef ROCKSDB_LITE
+class PerfSampleListener : public EventListener {
+ public:
+  void OnPerfContextSampled(const PerfSampleInfo& info) override {
+    ASSERT_NE(nullptr, info.perf_context);
+    ASSERT_EQ(nullptr, info.perf_context->level_to_perf_context);
+    ++count[static_cast<size_t>(info.operation)];
+  }
+
+  std::atomic<int> count[static_cast<size_t>(
+      PerfSampleOperation::kNumOperations)] = {};
+};
+
+TEST_F(PerfContextTest, PerfSampling) {
+  DestroyDB(kDbName, Options());
+  auto listener = std::make_shared<PerfSampleListener>();
+  Options options;
+  options.create_if_missing = true;
+  options.perf_sampling_interval = 1;
+  options.listeners.emplace_back(listener);
+  DB* db;
+  ASSERT_OK(DB::Open(options, kDbName, &db));
+
+  SetPerfLevel(kDisable);
+  std::string value;
+  for (int i = 0; i < FLAGS_total_keys; ++i) {
+    ASSERT_OK(db->Put(WriteOptions(), "k" + ToString(i), "v" + ToString(i)));
+    ASSERT_OK(db->Get(ReadOptions(), "k" + ToString(i), &value));
+  }
+  // The caller's perf level is left untouched
+  ASSERT_EQ(kDisable, GetPerfLevel());
+  std::unique_ptr<Iterator> iter(db->NewIterator(ReadOptions()));
+  iter->Seek("k1");
+  ASSERT_TRUE(iter->Valid());
+  iter.reset();
+  ASSERT_OK(db->Flush(FlushOptions()));
+  SetPerfLevel(kEnableCount);
+
+  auto count = [&](PerfSampleOperation op) {
+    return listener->count[static_cast<size_t>(op)].load();
+  };
+  ASSERT_EQ(FLAGS_total_keys, count(PerfSampleOperation::kGet));
+  ASSERT_EQ(FLAGS_total_keys, count(PerfSampleOperation::kWrite));
+  ASSERT_EQ(1, count(PerfSampleOperation::kSeek));
+  ASSERT_EQ(1, count(PerfSampleOperation::kFlush));
+
+  std::string samples;
+  ASSERT_TRUE(db->GetProperty(DB::Properties::kPerfSamples, &samples));
+  ASSERT_NE(std::string::npos, samples.find("Get"));
+  ASSERT_NE(std::string::npos, samples.find("Write"));
+  ASSERT_NE(std::string::npos, samples.find("get_from_memtable_time"));
+
+  // Disable sampling
+  ASSERT_OK(db->SetDBOptions({{"perf_sampling_interval", "0"}}));
+  ASSERT_OK(db->Get(ReadOptions(), "k0", &value));
+  ASSERT_EQ(FLAGS_total_keys, count(PerfSampleOperation::kGet));
+
+  delete db;
+}
+
+TEST_F(PerfContextTest, PerfSamplerIndependentCountdown) {
+  // Two DBs used from one thread must not steal each other's samples
+  const uint32_t kInterval = 4;
+  PerfSampler a(Env::Default(), kInterval, {});
+  PerfSampler b(Env::Default(), kInterval, {});
+  int sampled_a = 0;
+  int sampled_b = 0;
+  for (uint32_t i = 0; i < kInterval * 100; ++i) {
+    sampled_a += a.ShouldSample();
+    sampled_a += a.ShouldSample();
+    sampled_b += b.ShouldSample();
+  }
+  ASSERT_EQ(200, sampled_a);
+  ASSERT_EQ(100, sampled_b);
+}
+#endif  // ROCKSDB_LITE
 }  // namespace TERARKDB_NAMESPACE
 
 int main(int argc, char** argv) {
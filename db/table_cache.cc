@@ -85,6 +85,23 @@ static bool InheritanceMismatch(const FileMetaData& sst_meta,
   return true;
 }
 
+// No entry of the sst has a ttl time point within the read's time range. Map
+// ssts carry no ttl range, their dependences are checked one by one
+static bool OutOfTtlTimeRange(const ReadOptions& options,
+                              const FileMetaData& file_meta) {
+  if (options.ttl_time_lower_bound == 0 &&
+      options.ttl_time_upper_bound == port::kMaxUint64) {
+    return false;
+  }
+  const TablePropertyCache& prop = file_meta.prop;
+  if (prop.is_map_sst() || prop.num_deletions > 0 ||
+      prop.has_range_deletions()) {
+    return false;
+  }
+  return prop.latest_time_expire < options.ttl_time_lower_bound ||
+         prop.earliest_time_expire > options.ttl_time_upper_bound;
+}
+
 // Store params for create depend table iterator in future
 class LazyCreateIterator : public Snapshot {
   TableCache* table_cache_;
@@ -305,6 +322,10 @@ InternalIterator* TableCache::NewIterator(
   if (table_reader_ptr != nullptr) {
     *table_reader_ptr = nullptr;
   }
+  if (!for_compaction && OutOfTtlTimeRange(options, file_meta)) {
+    RecordTick(ioptions_.statistics, READ_SKIP_FILE_BY_TTL_TIME);
+    return NewEmptyInternalIterator<LazyBuffer>(arena);
+  }
   size_t readahead = 0;
   bool record_stats = !for_compaction;
   if (file_meta.prop.is_map_sst()) {
@@ -474,6 +495,15 @@ Status TableCache::Get(const ReadOptions& options,
       return Status::OK();
     }
   }
+  if (get_context->IsCoveredByRangeDeletion(file_meta.fd.largest_seqno)) {
+    RecordTick(ioptions_.statistics, GET_SKIP_FILE_BY_RANGE_DEL);
+    get_context->MarkCoveredByRangeDeletion();
+    return Status::OK();
+  }
+  if (OutOfTtlTimeRange(options, file_meta)) {
+    RecordTick(ioptions_.statistics, READ_SKIP_FILE_BY_TTL_TIME);
+    return Status::OK();
+  }
   auto& fd = file_meta.fd;
   IterKey key_buffer;
   Status s;
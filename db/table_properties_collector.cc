@@ -74,6 +74,11 @@ class TtlIntTblPropCollector : public IntTblPropCollector {
   std::string name_;
   uint64_t total_entries_ = 0;
   uint64_t ttl_entries_ = 0;
+  // Max ttl time point of all values, kMaxUint64 once a value without ttl
+  // has been seen
+  uint64_t latest_time_expire_ = 0;
+  // Min ttl time point of all values, values without ttl never expire
+  uint64_t earliest_time_expire_ = port::kMaxUint64;
 
   uint64_t min_scan_cap_ttl_ = port::kMaxUint64;
 
@@ -144,6 +149,12 @@ class TtlIntTblPropCollector : public IntTblPropCollector {
       PushItem(properties, TablePropertiesNames::kLatestTimeEndCompact,
                min_scan_cap_ttl_);
     }
+    if (ttl_entries_ > 0 && latest_time_expire_ < port::kMaxUint64) {
+      PushItem(properties, TablePropertiesNames::kLatestTimeExpire,
+               latest_time_expire_);
+    }
+    PushItem(properties, TablePropertiesNames::kEarliestTimeExpire,
+             earliest_time_expire_);
     return Status::OK();
   }
 
@@ -176,7 +187,11 @@ class TtlIntTblPropCollector : public IntTblPropCollector {
         uint64_t ttl_duration = std::max(ttl_time_point, now_) - now_;
         histogram_.Add(ttl_duration);
         AddTtlToSliceWindow(ttl_time_point);
+        latest_time_expire_ = std::max(latest_time_expire_, ttl_time_point);
+        earliest_time_expire_ =
+            std::min(earliest_time_expire_, ttl_time_point);
       } else {
+        latest_time_expire_ = port::kMaxUint64;
         ttl_slice_window_.clear();
         slice_window_ttl_index_.clear();
         slice_index_ = 0;
@@ -271,6 +286,20 @@ void GetCompactionTimePoint(const UserCollectedProperties& props,
   }
 }
 
+uint64_t GetLatestTimeExpire(const UserCollectedProperties& props) {
+  bool property_present;
+  uint64_t latest_time_expire = GetUint64Property(
+      props, TablePropertiesNames::kLatestTimeExpire, &property_present);
+  return property_present ? latest_time_expire : port::kMaxUint64;
+}
+
+uint64_t GetEarliestTimeExpire(const UserCollectedProperties& props) {
+  bool property_present;
+  uint64_t earliest_time_expire = GetUint64Property(
+      props, TablePropertiesNames::kEarliestTimeExpire, &property_present);
+  return property_present ? earliest_time_expire : 0;
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 TERARK_FACTORY_INSTANTIATE_GNS(
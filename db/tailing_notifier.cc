@@ -0,0 +1,181 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/tailing_notifier.h"
+
+#include "rocksdb/terark_namespace.h"
+#include "rocksdb/write_batch.h"
+#include "util/mutexlock.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Calls the callbacks whose range contains a key of the batch
+class TailingNotifier::MatchHandler : public WriteBatch::Handler {
+ public:
+  MatchHandler(TailingNotifier* notifier, SequenceNumber last_seq)
+      : notifier_(notifier), last_seq_(last_seq) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& /*value*/) override {
+    return MatchKey(column_family_id, key);
+  }
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return MatchKey(column_family_id, key);
+  }
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return MatchKey(column_family_id, key);
+  }
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& begin_key,
+                       const Slice& end_key) override {
+    auto& waiters = notifier_->waiters_;
+    for (size_t i = 0; i < waiters.size();) {
+      if (waiters[i].column_family_id == column_family_id &&
+          waiters[i].seq < last_seq_ &&
+          waiters[i].Overlaps(begin_key, end_key)) {
+        notifier_->Fire(i, Status::OK(), last_seq_);
+      } else {
+        ++i;
+      }
+    }
+    return Status::OK();
+  }
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& /*value*/) override {
+    return MatchKey(column_family_id, key);
+  }
+  // Writes of 2PC transactions are matched as well, a spurious call is
+  // harmless
+  Status MarkBeginPrepare(bool) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+  Status MarkNoop(bool) override { return Status::OK(); }
+  Status MarkRollback(const Slice&) override { return Status::OK(); }
+  Status MarkCommit(const Slice&) override { return Status::OK(); }
+
+  bool Continue() override { return !notifier_->waiters_.empty(); }
+
+ private:
+  Status MatchKey(uint32_t column_family_id, const Slice& key) {
+    auto& waiters = notifier_->waiters_;
+    for (size_t i = 0; i < waiters.size();) {
+      if (waiters[i].column_family_id == column_family_id &&
+          waiters[i].seq < last_seq_ && waiters[i].Contains(key)) {
+        notifier_->Fire(i, Status::OK(), last_seq_);
+      } else {
+        ++i;
+      }
+    }
+    return Status::OK();
+  }
+
+  TailingNotifier* notifier_;
+  SequenceNumber last_seq_;
+};
+
+Status TailingNotifier::Register(uint32_t column_family_id,
+                                 const Comparator* ucmp, SequenceNumber seq,
+                                 const Slice* begin, const Slice* end,
+                                 NewDataCallback* callback) {
+  assert(callback != nullptr);
+  MutexLock l(&mutex_);
+  if (shutdown_) {
+    return Status::ShutdownInProgress();
+  }
+  for (auto& w : waiters_) {
+    if (w.callback == callback) {
+      return Status::InvalidArgument("Callback is already registered");
+    }
+  }
+  Waiter w;
+  w.column_family_id = column_family_id;
+  w.ucmp = ucmp;
+  w.seq = seq;
+  w.has_begin = begin != nullptr;
+  w.has_end = end != nullptr;
+  if (begin != nullptr) {
+    w.begin = begin->ToString();
+  }
+  if (end != nullptr) {
+    w.end = end->ToString();
+  }
+  w.callback = callback;
+  waiters_.emplace_back(std::move(w));
+  num_waiters_.store(waiters_.size(), std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return Status::OK();
+}
+
+bool TailingNotifier::Unregister(NewDataCallback* callback) {
+  MutexLock l(&mutex_);
+  for (size_t i = 0; i < waiters_.size(); ++i) {
+    if (waiters_[i].callback == callback) {
+      waiters_[i] = std::move(waiters_.back());
+      waiters_.pop_back();
+      num_waiters_.store(waiters_.size(), std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void TailingNotifier::NotifyWrite(const WriteThread::WriteGroup& write_group,
+                                  SequenceNumber last_seq) {
+  MutexLock l(&mutex_);
+  MatchHandler handler(this, last_seq);
+  for (auto* writer : write_group) {
+    if (waiters_.empty()) {
+      break;
+    }
+    if (writer->CallbackFailed() || !writer->ShouldWriteToMemtable()) {
+      continue;
+    }
+    writer->batch->Iterate(&handler);
+  }
+}
+
+void TailingNotifier::NotifyColumnFamily(uint32_t column_family_id,
+                                         SequenceNumber last_seq) {
+  MutexLock l(&mutex_);
+  for (size_t i = 0; i < waiters_.size();) {
+    if (waiters_[i].column_family_id == column_family_id &&
+        waiters_[i].seq < last_seq) {
+      Fire(i, Status::OK(), last_seq);
+    } else {
+      ++i;
+    }
+  }
+}
+
+void TailingNotifier::NotifyIfBehind(NewDataCallback* callback,
+                                     SequenceNumber last_seq) {
+  MutexLock l(&mutex_);
+  for (size_t i = 0; i < waiters_.size(); ++i) {
+    if (waiters_[i].callback == callback) {
+      if (waiters_[i].seq < last_seq) {
+        Fire(i, Status::OK(), last_seq);
+      }
+      return;
+    }
+  }
+}
+
+void TailingNotifier::Shutdown() {
+  MutexLock l(&mutex_);
+  shutdown_ = true;
+  while (!waiters_.empty()) {
+    Fire(waiters_.size() - 1, Status::ShutdownInProgress(), 0);
+  }
+}
+
+void TailingNotifier::Fire(size_t i, const Status& status,
+                           SequenceNumber seq) {
+  mutex_.AssertHeld();
+  NewDataCallback* callback = waiters_[i].callback;
+  waiters_[i] = std::move(waiters_.back());
+  waiters_.pop_back();
+  num_waiters_.store(waiters_.size(), std::memory_order_relaxed);
+  callback->OnNewData(status, seq);
+}
+
+}  // namespace TERARKDB_NAMESPACE
@@ -0,0 +1,96 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/write_thread.h"
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/db.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/terark_namespace.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Keeps the NewDataCallbacks registered with DB::RegisterNewDataCallback()
+// and calls them when a write commits to their column family and key range.
+// While nobody is registered, a write only pays for one atomic load.
+//
+// A writer publishes its sequence number before it checks HasWaiters() and
+// a registration is added before its sequence number is compared with the
+// last one of the DB, so either the writer sees the registration or the
+// registration sees the write.
+class TailingNotifier {
+ public:
+  TailingNotifier() : num_waiters_(0), shutdown_(false) {}
+  ~TailingNotifier() { assert(waiters_.empty()); }
+
+  // Returns ShutdownInProgress once Shutdown() was called
+  Status Register(uint32_t column_family_id, const Comparator* ucmp,
+                  SequenceNumber seq, const Slice* begin, const Slice* end,
+                  NewDataCallback* callback);
+
+  bool Unregister(NewDataCallback* callback);
+
+  bool HasWaiters() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return num_waiters_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // Calls the callbacks whose range overlaps the keys written by the
+  // memtable writers of write_group
+  void NotifyWrite(const WriteThread::WriteGroup& write_group,
+                   SequenceNumber last_seq);
+
+  // Calls the callbacks of a column family that got new data by other means
+  // than a write batch, such as file ingestion, regardless of their range
+  void NotifyColumnFamily(uint32_t column_family_id, SequenceNumber last_seq);
+
+  // Calls `callback` if it is still registered with a sequence number before
+  // last_seq
+  void NotifyIfBehind(NewDataCallback* callback, SequenceNumber last_seq);
+
+  // Calls all callbacks with ShutdownInProgress, no new ones are accepted
+  void Shutdown();
+
+ private:
+  struct Waiter {
+    uint32_t column_family_id;
+    const Comparator* ucmp;
+    SequenceNumber seq;
+    bool has_begin;
+    bool has_end;
+    std::string begin;
+    std::string end;
+    NewDataCallback* callback;
+
+    bool Contains(const Slice& key) const {
+      return (!has_begin || ucmp->Compare(key, begin) >= 0) &&
+             (!has_end || ucmp->Compare(key, end) < 0);
+    }
+    // Overlaps with the range deletion [range_begin, range_end)
+    bool Overlaps(const Slice& range_begin, const Slice& range_end) const {
+      return (!has_begin || ucmp->Compare(range_end, begin) > 0) &&
+             (!has_end || ucmp->Compare(range_begin, end) < 0);
+    }
+  };
+  class MatchHandler;
+
+  // Requires mutex_
+  void Fire(size_t i, const Status& status, SequenceNumber seq);
+
+  port::Mutex mutex_;
+  std::vector<Waiter> waiters_;
+  std::atomic<size_t> num_waiters_;
+  bool shutdown_;
+};
+
+}  // namespace TERARKDB_NAMESPACE
@@ -98,6 +98,8 @@ struct TablePropertyCache {
   std::vector<uint64_t> inheritance;   // inheritance set
   uint64_t earliest_time_begin_compact = port::kMaxUint64;
   uint64_t latest_time_end_compact = port::kMaxUint64;
+  uint64_t latest_time_expire = port::kMaxUint64;
+  uint64_t earliest_time_expire = 0;  // zero if unknown
 
   bool is_map_sst() const { return purpose == kMapSst; }
   bool has_range_deletions() const { return (flags & kNoRangeDeletions) == 0; }
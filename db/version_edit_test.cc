@@ -181,6 +181,34 @@ TEST_F(VersionEditTest, NewFile4NotSupportedField) {
   ASSERT_NOK(s);
 }
 
+TEST_F(VersionEditTest, EncodeDecodeTtlProperties) {
+  VersionEdit edit;
+  TablePropertyCache expired = GetPropCache(0, {}, {});
+  expired.earliest_time_begin_compact = 100;
+  expired.latest_time_end_compact = 150;
+  expired.latest_time_expire = 200;
+  expired.earliest_time_expire = 120;
+  edit.AddFile(0, 300, 0, 100, InternalKey("foo", 500, kTypeValue),
+               InternalKey("zoo", 600, kTypeValue), 500, 600, false, expired);
+  edit.AddFile(0, 301, 0, 100, InternalKey("foo", 501, kTypeValue),
+               InternalKey("zoo", 601, kTypeValue), 501, 601, false,
+               GetPropCache(0, {}, {}));
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  Status s = parsed.DecodeFrom(encoded);
+  ASSERT_TRUE(s.ok()) << s.ToString();
+  auto& new_files = parsed.GetNewFiles();
+  ASSERT_EQ(100U, new_files[0].second.prop.earliest_time_begin_compact);
+  ASSERT_EQ(150U, new_files[0].second.prop.latest_time_end_compact);
+  ASSERT_EQ(200U, new_files[0].second.prop.latest_time_expire);
+  ASSERT_EQ(120U, new_files[0].second.prop.earliest_time_expire);
+  ASSERT_EQ(port::kMaxUint64, new_files[1].second.prop.latest_time_expire);
+  ASSERT_EQ(0U, new_files[1].second.prop.earliest_time_expire);
+}
+
 TEST_F(VersionEditTest, EncodeEmptyFile) {
   VersionEdit edit;
   edit.AddFile(0, 0, 0, 0, InternalKey(), InternalKey(), 0, 0, false,
@@ -555,6 +555,7 @@ class LevelIterator final : public InternalIterator, public Snapshot {
  private:
   void SkipEmptyFileForward();
   void SkipEmptyFileBackward();
+  size_t FindFileForSeek(const Slice& target);
   void SetFileIterator(InternalIterator* iter);
   void InitFileIterator(size_t new_file_index);
 
@@ -604,7 +605,7 @@ class LevelIterator final : public InternalIterator, public Snapshot {
 };
 
 void LevelIterator::Seek(const Slice& target) {
-  size_t new_file_index = FindFile(icomparator_, *flevel_, target);
+  size_t new_file_index = FindFileForSeek(target);
 
   InitFileIterator(new_file_index);
   if (file_iter_.iter() != nullptr) {
@@ -691,6 +692,26 @@ void LevelIterator::SkipEmptyFileBackward() {
   }
 }
 
+// Same as FindFile(), but a seek that moves forward usually stays in the
+// current file or moves to the next one, so try them before a binary search
+size_t LevelIterator::FindFileForSeek(const Slice& target) {
+  size_t num_files = flevel_->num_files;
+  size_t i = file_index_;
+  if (i >= num_files ||
+      (i > 0 &&
+       icomparator_.Compare(flevel_->files[i - 1].largest_key, target) >= 0)) {
+    return FindFile(icomparator_, *flevel_, target);
+  }
+  for (size_t end = std::min(i + 2, num_files); i < end; ++i) {
+    if (icomparator_.Compare(flevel_->files[i].largest_key, target) >= 0) {
+      return i;
+    }
+  }
+  return FindFileInRange(icomparator_, *flevel_, target,
+                         static_cast<uint32_t>(i),
+                         static_cast<uint32_t>(num_files));
+}
+
 void LevelIterator::SetFileIterator(InternalIterator* iter) {
   delete file_iter_.Set(iter);
 }
@@ -1308,6 +1329,12 @@ Status Version::fetch_buffer(LazyBuffer* buffer) const {
 
 LazyBuffer Version::TransToCombined(const Slice& user_key, uint64_t sequence,
                                     const LazyBuffer& value) const {
+  return TransToCombined(user_key, sequence, value, this);
+}
+
+LazyBuffer Version::TransToCombined(const Slice& user_key, uint64_t sequence,
+                                    const LazyBuffer& value,
+                                    const LazyBufferState* state) const {
   auto s = value.fetch();
   if (!s.ok()) {
     return LazyBuffer(std::move(s));
@@ -1319,7 +1346,7 @@ LazyBuffer Version::TransToCombined(const Slice& user_key, uint64_t sequence,
     return LazyBuffer(Status::Corruption("Separate value dependence missing"));
   } else {
     return LazyBuffer(
-        this,
+        state,
         {reinterpret_cast<uint64_t>(user_key.data()), user_key.size(), sequence,
          reinterpret_cast<uint64_t>(&*find)},
         Slice::Invalid(), find->second->fd.GetNumber());
@@ -4360,6 +4387,12 @@ void VersionSet::MarkMinLogNumberToKeep2PC(uint64_t number) {
 }
 
 Status VersionSet::WriteSnapshot(log::Writer* log) {
+  return WriteSnapshot(
+      [log](const std::string& record) { return log->AddRecord(record); });
+}
+
+Status VersionSet::WriteSnapshot(
+    const std::function<Status(const std::string& record)>& add_record) {
   // TODO: Break up into multiple records to reduce memory usage on recovery?
 
   // WARNING: This method doesn't hold a mutex!!
@@ -4388,7 +4421,7 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
         return Status::Corruption("Unable to Encode VersionEdit:" +
                                   edit.DebugString(true));
       }
-      Status s = log->AddRecord(record);
+      Status s = add_record(record);
       if (!s.ok()) {
         return s;
       }
@@ -4414,7 +4447,7 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
         return Status::Corruption("Unable to Encode VersionEdit:" +
                                   edit.DebugString(true));
       }
-      Status s = log->AddRecord(record);
+      Status s = add_record(record);
       if (!s.ok()) {
         return s;
       }
@@ -4424,6 +4457,37 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
   return Status::OK();
 }
 
+Status VersionSet::GetCurrentStateSnapshot(
+    std::vector<std::string>* records, std::vector<FileDescriptor>* live_list) {
+  Status s = WriteSnapshot([records](const std::string& record) {
+    records->push_back(record);
+    return Status::OK();
+  });
+  if (!s.ok()) {
+    return s;
+  }
+  // What LogAndApply() would append to the snapshot of a new MANIFEST
+  VersionEdit edit;
+  edit.SetNextFile(next_file_number_.load());
+  edit.SetLastSequence(LastSequence());
+  edit.SetPrevLogNumber(prev_log_number_);
+  edit.SetMaxColumnFamily(column_family_set_->GetMaxColumnFamily());
+  std::string record;
+  if (!edit.EncodeTo(&record)) {
+    return Status::Corruption("Unable to Encode VersionEdit:" +
+                              edit.DebugString(true));
+  }
+  records->push_back(std::move(record));
+
+  for (auto cfd : *column_family_set_) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    cfd->current()->AddLiveFiles(live_list);
+  }
+  return Status::OK();
+}
+
 // TODO(aekmekji): in CompactionJob::GenSubcompactionBoundaries(), this
 // function is called repeatedly with consecutive pairs of slices. For example
 // if the slice list is [a, b, c, d] this function is called with arguments
@@ -4667,9 +4731,10 @@ InternalIterator* VersionSet::MakeInputIterator(
     }
   }
   assert(num <= space);
-  InternalIterator* result =
-      NewMergingIterator(&c->column_family_data()->internal_comparator(), list,
-                         static_cast<int>(num));
+  InternalIterator* result = NewMergingIterator(
+      &c->column_family_data()->internal_comparator(), list,
+      static_cast<int>(num), nullptr /* arena */, false /* prefix_seek_mode */,
+      c->immutable_cf_options()->use_loser_tree_merging_iterator);
   delete[] list;
   return result;
 }
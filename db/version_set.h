@@ -20,6 +20,7 @@
 #pragma once
 #include <atomic>
 #include <deque>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
@@ -682,6 +683,16 @@ class Version : public SeparateHelper, private LazyBufferState {
               ValueType* type, SequenceNumber* seq, LazyBuffer* value,
               const FileMetaData& blob);
 
+  // Same as TransToCombined, but the returned buffer is owned by `state`,
+  // which reads the separated value back through FetchCombined
+  LazyBuffer TransToCombined(const Slice& user_key, uint64_t sequence,
+                             const LazyBuffer& value,
+                             const LazyBufferState* state) const;
+
+  Status FetchCombined(LazyBuffer* buffer) const {
+    return fetch_buffer(buffer);
+  }
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options);
@@ -1072,6 +1083,13 @@ class VersionSet {
   // Add all files listed in any live version to *live.
   void AddLiveFiles(std::vector<FileDescriptor>* live_list);
 
+  // Encode the records of a MANIFEST that describes the current version of
+  // every column family and nothing else, and add the files of those
+  // versions, blob and dependence files included, to *live_list.
+  // REQUIRES: DB mutex held
+  Status GetCurrentStateSnapshot(std::vector<std::string>* records,
+                                 std::vector<FileDescriptor>* live_list);
+
   // Return the approximate size of data to be scanned for range [start, end)
   // in levels [start_level, end_level). If end_level == 0 it will search
   // through all non-empty levels
@@ -1137,6 +1155,8 @@ class VersionSet {
 
   // Save current contents to *log
   Status WriteSnapshot(log::Writer* log);
+  Status WriteSnapshot(
+      const std::function<Status(const std::string& record)>& add_record);
 
   void AppendVersion(ColumnFamilyData* column_family_data, Version* v);
 
@@ -5,8 +5,11 @@
 
 #include "db/write_controller.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
 #include <ratio>
 
 #include "rocksdb/env.h"
@@ -108,6 +111,106 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
   return sleep_amount;
 }
 
+constexpr double WriteController::kTargetPressure;
+constexpr double WriteController::kProportionalGain;
+constexpr double WriteController::kIntegralGain;
+constexpr double WriteController::kDerivativeGain;
+constexpr double WriteController::kMaxRateIncrease;
+constexpr double WriteController::kMaxRateDecrease;
+const uint64_t WriteController::kMinFeedbackWriteRate;
+
+uint64_t WriteController::UpdateWriteDebt(uint32_t column_family_id,
+                                          const WriteDebt& debt,
+                                          uint64_t now_micros) {
+  // Intervals are capped so that a long quiet period doesn't blow up the
+  // integral term
+  const double kMaxIntervalSeconds = 10;
+  const double kMaxIntegral = 2;
+  // Weight of the latest sample in the pressure growth average
+  const double kRateAlpha = 0.5;
+
+  write_debts_[column_family_id] = debt;
+  double pressure = TotalWriteDebt().pressure;
+  if (last_feedback_micros_ != 0 && now_micros > last_feedback_micros_) {
+    double dt = std::min(
+        static_cast<double>(now_micros - last_feedback_micros_) / 1000000,
+        kMaxIntervalSeconds);
+    double rate = (pressure - pressure_) / dt;
+    pressure_rate_ = pressure_rate_ * (1 - kRateAlpha) + rate * kRateAlpha;
+    pressure_integral_ += (pressure - kTargetPressure) * dt;
+    pressure_integral_ =
+        std::min(std::max(pressure_integral_, 0.0), kMaxIntegral);
+  }
+  pressure_ = pressure;
+  if (last_feedback_micros_ < now_micros) {
+    last_feedback_micros_ = now_micros;
+  }
+
+  uint64_t max_rate = max_delayed_write_rate_;
+  double output = kProportionalGain * (pressure - kTargetPressure) +
+                  kIntegralGain * pressure_integral_ +
+                  kDerivativeGain * pressure_rate_;
+  double factor = std::min(std::max(1 - output, 0.0), 1.0);
+  uint64_t target = std::max(static_cast<uint64_t>(max_rate * factor),
+                             std::min(kMinFeedbackWriteRate, max_rate));
+  uint64_t last = feedback_write_rate_ == 0 ? max_rate : feedback_write_rate_;
+  uint64_t write_rate = std::min(
+      std::max(target, static_cast<uint64_t>(last * kMaxRateDecrease)),
+      static_cast<uint64_t>(last * kMaxRateIncrease));
+  write_rate = std::min(std::max<uint64_t>(write_rate, 1), max_rate);
+  feedback_write_rate_ = write_rate;
+  return write_rate;
+}
+
+void WriteController::RemoveWriteDebt(uint32_t column_family_id) {
+  write_debts_.erase(column_family_id);
+}
+
+WriteDebt WriteController::TotalWriteDebt() const {
+  WriteDebt total;
+  for (auto& pair : write_debts_) {
+    const WriteDebt& debt = pair.second;
+    total.flush_bytes += debt.flush_bytes;
+    total.compaction_bytes += debt.compaction_bytes;
+    total.gc_bytes += debt.gc_bytes;
+    total.pressure = std::max(total.pressure, debt.pressure);
+  }
+  return total;
+}
+
+double WriteController::PredictedSecondsToStop() const {
+  if (pressure_ >= 1) {
+    return 0;
+  }
+  if (pressure_rate_ <= 0) {
+    return -1;
+  }
+  return (1 - pressure_) / pressure_rate_;
+}
+
+std::string WriteController::FeedbackToString() const {
+  WriteDebt total = TotalWriteDebt();
+  char buf[512];
+  snprintf(buf, sizeof(buf),
+           "Feedback control: %s\n"
+           "Pressure: %.3f (target %.2f)\n"
+           "Pressure growth: %.4f/s\n"
+           "Pressure integral: %.3f\n"
+           "Predicted seconds to stop: %.1f\n"
+           "Debt bytes: %" PRIu64 " (flush %" PRIu64 ", compaction %" PRIu64
+           ", gc %" PRIu64 ")\n"
+           "Write rate: %" PRIu64 " (max %" PRIu64 ")\n"
+           "Stopped: %d, delayed: %d\n",
+           feedback_control_ ? "enabled" : "disabled", pressure_,
+           kTargetPressure, pressure_rate_, pressure_integral_,
+           PredictedSecondsToStop(), total.total_bytes(), total.flush_bytes,
+           total.compaction_bytes, total.gc_bytes,
+           NeedsDelay() ? delayed_write_rate_ : max_delayed_write_rate_,
+           max_delayed_write_rate_, total_stopped_.load(),
+           total_delayed_.load());
+  return buf;
+}
+
 uint64_t WriteController::NowMicrosMonotonic(Env* env) {
   return env->NowNanos() / std::milli::den;
 }
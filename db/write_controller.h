@@ -9,6 +9,8 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 #include "rocksdb/rate_limiter.h"
 #include "rocksdb/terark_namespace.h"
@@ -18,6 +20,23 @@ namespace TERARKDB_NAMESPACE {
 class Env;
 class WriteControllerToken;
 
+// Background work a column family has to catch up with, see
+// ColumnFamilyData::EstimateWriteDebt()
+struct WriteDebt {
+  // Immutable memtables waiting for flush
+  uint64_t flush_bytes = 0;
+  uint64_t compaction_bytes = 0;
+  // Garbage in the blob files that are due for garbage collection
+  uint64_t gc_bytes = 0;
+  // 0 up to the thresholds at which compactions are sped up, 1 at the first
+  // threshold at which writes stop
+  double pressure = 0;
+
+  uint64_t total_bytes() const {
+    return flush_bytes + compaction_bytes + gc_bytes;
+  }
+};
+
 // WriteController is controlling write stalls in our write code-path. Write
 // stalls happen when compaction can't keep up with write rate.
 // All of the methods here (including WriteControllerToken's destructors) need
@@ -31,6 +50,12 @@ class WriteController {
         total_compaction_pressure_(0),
         bytes_left_(0),
         last_refill_time_(0),
+        feedback_control_(false),
+        pressure_(0),
+        pressure_rate_(0),
+        pressure_integral_(0),
+        last_feedback_micros_(0),
+        feedback_write_rate_(0),
         low_pri_rate_limiter_(
             NewGenericRateLimiter(low_pri_rate_bytes_per_sec)) {
     set_max_delayed_write_rate(_delayed_write_rate);
@@ -86,6 +111,41 @@ class WriteController {
 
   RateLimiter* low_pri_rate_limiter() { return low_pri_rate_limiter_.get(); }
 
+  // With feedback control, column families report their debt with
+  // UpdateWriteDebt() and are delayed to the rate it returns instead of
+  // stepping the delayed write rate up and down
+  void set_feedback_control(bool enabled) { feedback_control_ = enabled; }
+  bool feedback_control() const { return feedback_control_; }
+
+  // Records the debt of a column family and returns the rate writes should
+  // be delayed to, max_delayed_write_rate() if they need no delay.
+  // The highest pressure of all column families drives a PID loop that keeps
+  // it around kTargetPressure: the rate is lowered in proportion to the
+  // pressure above the target, to how long it stayed above and to how fast it
+  // grows, and it changes by a bounded ratio per update.
+  uint64_t UpdateWriteDebt(uint32_t column_family_id, const WriteDebt& debt,
+                           uint64_t now_micros);
+  void RemoveWriteDebt(uint32_t column_family_id);
+
+  // Debt of all column families, with the highest pressure
+  WriteDebt TotalWriteDebt() const;
+
+  // Seconds until the pressure reaches 1 if it keeps growing at its current
+  // rate, a negative value if it does not grow
+  double PredictedSecondsToStop() const;
+
+  std::string FeedbackToString() const;
+
+  static constexpr double kTargetPressure = 0.3;
+  static constexpr double kProportionalGain = 1.2;
+  // Per second above the target
+  static constexpr double kIntegralGain = 0.2;
+  // Seconds of pressure growth
+  static constexpr double kDerivativeGain = 2.0;
+  static constexpr double kMaxRateIncrease = 1.25;
+  static constexpr double kMaxRateDecrease = 0.5;
+  static const uint64_t kMinFeedbackWriteRate = 16 * 1024;
+
  private:
   uint64_t NowMicrosMonotonic(Env* env);
 
@@ -104,6 +164,17 @@ class WriteController {
   // current write rate
   uint64_t delayed_write_rate_;
 
+  bool feedback_control_;
+  std::unordered_map<uint32_t, WriteDebt> write_debts_;
+  double pressure_;
+  // Pressure change per second, averaged
+  double pressure_rate_;
+  // Seconds times pressure above the target, never negative
+  double pressure_integral_;
+  uint64_t last_feedback_micros_;
+  // 0 until the first update
+  uint64_t feedback_write_rate_;
+
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
 };
 
@@ -128,6 +128,105 @@ TEST_F(WriteControllerTest, SanityTest) {
   ASSERT_FALSE(controller.IsStopped());
 }
 
+namespace {
+WriteDebt MakeDebt(double pressure, uint64_t flush_bytes = 0,
+                   uint64_t compaction_bytes = 0, uint64_t gc_bytes = 0) {
+  WriteDebt debt;
+  debt.pressure = pressure;
+  debt.flush_bytes = flush_bytes;
+  debt.compaction_bytes = compaction_bytes;
+  debt.gc_bytes = gc_bytes;
+  return debt;
+}
+}  // namespace
+
+TEST_F(WriteControllerTest, FeedbackBelowTarget) {
+  WriteController controller(10000000u);
+  uint64_t now = 1000000;
+  for (int i = 0; i < 10; ++i) {
+    now += 100000;
+    ASSERT_EQ(10000000u, controller.UpdateWriteDebt(0, MakeDebt(0.1), now));
+  }
+  ASSERT_LT(controller.PredictedSecondsToStop(), 0);
+}
+
+TEST_F(WriteControllerTest, FeedbackSmoothSlowdown) {
+  WriteController controller(10000000u);
+  uint64_t now = 1000000;
+  uint64_t last = controller.UpdateWriteDebt(0, MakeDebt(0), now);
+  ASSERT_EQ(10000000u, last);
+  // Pressure jumps to the stop threshold, the rate never drops by more than
+  // half per update
+  for (int i = 0; i < 5; ++i) {
+    now += 100000;
+    uint64_t rate = controller.UpdateWriteDebt(0, MakeDebt(0.9), now);
+    ASSERT_LE(rate, last);
+    ASSERT_GE(rate, last / 2);
+    last = rate;
+  }
+  ASSERT_LT(last, 10000000u);
+  ASSERT_GE(last, WriteController::kMinFeedbackWriteRate);
+}
+
+TEST_F(WriteControllerTest, FeedbackPredictsStop) {
+  WriteController controller(10000000u);
+  uint64_t now = 1000000;
+  controller.UpdateWriteDebt(0, MakeDebt(0), now);
+  // Still below the target, but growing fast
+  now += 1000000;
+  uint64_t rate = controller.UpdateWriteDebt(0, MakeDebt(0.25), now);
+  ASSERT_LT(rate, 10000000u);
+  ASSERT_GT(controller.PredictedSecondsToStop(), 0);
+}
+
+TEST_F(WriteControllerTest, FeedbackIntegralAndRecovery) {
+  WriteController controller(10000000u);
+  uint64_t now = 1000000;
+  controller.UpdateWriteDebt(0, MakeDebt(0.5), now);
+  // Constant pressure above the target keeps lowering the rate
+  uint64_t last = 0;
+  for (int i = 0; i < 5; ++i) {
+    now += 1000000;
+    uint64_t rate = controller.UpdateWriteDebt(0, MakeDebt(0.5), now);
+    if (i > 0) {
+      ASSERT_LT(rate, last);
+    }
+    last = rate;
+  }
+  // Once the debt is paid the rate recovers by a bounded ratio per update
+  for (int i = 0; i < 50 && last < 10000000u; ++i) {
+    now += 1000000;
+    uint64_t rate = controller.UpdateWriteDebt(0, MakeDebt(0), now);
+    ASSERT_GE(rate, last);
+    ASSERT_LE(rate, static_cast<uint64_t>(
+                        last * WriteController::kMaxRateIncrease) + 1);
+    last = rate;
+  }
+  ASSERT_EQ(10000000u, last);
+}
+
+TEST_F(WriteControllerTest, FeedbackColumnFamilies) {
+  WriteController controller(10000000u);
+  uint64_t now = 1000000;
+  controller.UpdateWriteDebt(1, MakeDebt(0.2, 100, 1000, 10), now);
+  controller.UpdateWriteDebt(2, MakeDebt(0.8, 200, 2000, 20), now);
+  WriteDebt total = controller.TotalWriteDebt();
+  ASSERT_EQ(300u, total.flush_bytes);
+  ASSERT_EQ(3000u, total.compaction_bytes);
+  ASSERT_EQ(30u, total.gc_bytes);
+  ASSERT_EQ(3330u, total.total_bytes());
+  ASSERT_DOUBLE_EQ(0.8, total.pressure);
+
+  // The most indebted column family drives the rate of all
+  now += 100000;
+  ASSERT_LT(controller.UpdateWriteDebt(1, MakeDebt(0.2), now), 10000000u);
+
+  controller.RemoveWriteDebt(2);
+  total = controller.TotalWriteDebt();
+  ASSERT_EQ(0u, total.total_bytes());
+  ASSERT_DOUBLE_EQ(0.2, total.pressure);
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 int main(int argc, char** argv) {
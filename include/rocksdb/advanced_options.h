@@ -648,6 +648,16 @@ struct AdvancedColumnFamilyOptions {
   // Default: false
   bool force_consistency_checks = false;
 
+  // Merge the sorted runs of reads, flushes and compactions with a tournament
+  // (loser) tree instead of a binary heap. Each step of the merge takes
+  // ceil(log2(N)) key comparisons instead of up to 2*log2(N), and a single one
+  // while the same input keeps producing the smallest key, which is the
+  // common case when one level covers most of a range or many map SSTs are
+  // merged.
+  //
+  // Default: false
+  bool use_loser_tree_merging_iterator = false;
+
   // Measure IO stats in compactions and flushes, if true.
   //
   // Default: false
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -273,6 +274,30 @@ class Cache {
   // Prerequisite: no entry is referenced.
   virtual void EraseUnRefEntries() = 0;
 
+  // Called with every entry the cache evicts because it is over capacity
+  // (to make room for a new entry, after SetCapacity() or when an entry is
+  // released while the cache is full), after the entry has left the cache and
+  // before its deleter is called. Entries removed by Erase() or replaced by
+  // Insert() are not reported. The callback runs on the thread that caused
+  // the eviction without any cache lock held, so it may not access the cache.
+  using EvictionCallback =
+      std::function<void(const Slice& key, void* value, size_t charge,
+                         void (*deleter)(const Slice& key, void* value))>;
+
+  // Registers `callback` under `tag`, every registered callback is called
+  // for each evicted entry. Adding a tag that is already registered only
+  // takes another reference to it and keeps its first callback. Returns
+  // NotSupported if the implementation can't report evictions (currently
+  // only the LRU and LIRS caches can).
+  virtual Status AddEvictionCallback(const void* /*tag*/,
+                                     EvictionCallback /*callback*/) {
+    return Status::NotSupported();
+  }
+
+  // Drops one reference to `tag`, the callback is unregistered with the last
+  // one. It is destroyed once no eviction in progress can still call it.
+  virtual void RemoveEvictionCallback(const void* /*tag*/) {}
+
   virtual std::string GetPrintableOptions() const { return ""; }
 
   // Mark the last inserted object as being a raw data block. This will be used
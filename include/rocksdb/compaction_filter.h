@@ -202,6 +202,15 @@ class CompactionFilter
   // Default as false, which means stability of outcome is not promised.
   virtual bool IsStableChangeValue() const { return false; }
 
+  // Return true if FilterV2 decides on existing_value_meta alone, as
+  // extracted by the column family's value_meta_extractor_factory. Then
+  // compaction never reads a value separated into a blob file on behalf of
+  // the filter: for such values FilterV2 gets an existing_value holding a
+  // NotSupported status instead. Values stored inline are passed as usual.
+  // Blobs are still read when a kept value has to be merged, rebuilt or
+  // combined; CompactionJobStats::num_blob_fetches counts those reads.
+  virtual bool IsValueMetaOnly() const { return false; }
+
   // Returns a name that identifies this compaction filter.
   // The name will be printed to LOG file on start up for diagnosis.
   virtual const char* Name() const = 0;
@@ -90,5 +90,11 @@ struct CompactionJobStats {
 
   // number of single-deletes which meet something other than a put
   uint64_t num_single_del_mismatch;
+
+  // number of separated values read back from blob files, e.g. for a
+  // compaction filter, a merge or a blob rebuild
+  uint64_t num_blob_fetches;
+  // the total size of those values in bytes
+  uint64_t total_blob_fetch_bytes;
 };
 }  // namespace TERARKDB_NAMESPACE
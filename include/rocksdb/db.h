@@ -149,6 +149,18 @@ struct RangePtr {
 typedef std::unordered_map<std::string, std::shared_ptr<const TableProperties>>
     TablePropertiesCollection;
 
+// Callback for DB::RegisterNewDataCallback()
+class NewDataCallback {
+ public:
+  virtual ~NewDataCallback() {}
+
+  // Called once per registration, with OK and the last sequence number of
+  // the write that committed the new data, or with ShutdownInProgress when
+  // the DB is closed first. Runs on the writing thread under an internal
+  // mutex, so it has to be quick and must not call into the DB.
+  virtual void OnNewData(const Status& status, SequenceNumber seq) = 0;
+};
+
 // A DB is a persistent ordered map from keys to values.
 // A DB is safe for concurrent access from multiple threads without
 // any external synchronization.
@@ -678,6 +690,11 @@ class DB {
     //      based.
     static const std::string kEstimatePendingCompactionBytes;
 
+    //  "rocksdb.blob-garbage-ratio" - returns the fraction of the entries in
+    //      the blob files garbage collection may pick that are no longer
+    //      referenced.
+    static const std::string kBlobGarbageRatio;
+
     //  "rocksdb.aggregated-table-properties" - returns a string representation
     //      of the aggregated table properties of the target column family.
     static const std::string kAggregatedTableProperties;
@@ -708,6 +725,26 @@ class DB {
     // "rocksdb.options-statistics" - returns multi-line string
     //      of options.statistics
     static const std::string kOptionsStatistics;
+
+    //  "rocksdb.perf-samples" - returns multi-line string summarizing the
+    //      operations sampled by DBOptions::perf_sampling_interval, with the
+    //      PerfContext breakdown of the slowest ones.
+    static const std::string kPerfSamples;
+
+    //  "rocksdb.background-scheduler-stats" - returns multi-line string with
+    //      the queue depth, wait times and stolen jobs of each class of
+    //      background work, see DBOptions::adaptive_background_scheduling.
+    static const std::string kBackgroundSchedulerStats;
+
+    //  "rocksdb.estimated-write-debt-bytes" - returns the bytes of flush,
+    //      compaction and garbage collection work that the write controller
+    //      last saw pending, see DBOptions::adaptive_write_throttling.
+    static const std::string kEstimatedWriteDebtBytes;
+
+    //  "rocksdb.write-controller-stats" - returns multi-line string with the
+    //      pressure, the write debt and the delayed write rate picked by the
+    //      write controller.
+    static const std::string kWriteControllerStats;
   };
 #endif /* ROCKSDB_LITE */
 
@@ -763,6 +800,7 @@ class DB {
   //  "rocksdb.block-cache-capacity"
   //  "rocksdb.block-cache-usage"
   //  "rocksdb.block-cache-pinned-usage"
+  //  "rocksdb.estimated-write-debt-bytes"
   virtual bool GetIntProperty(ColumnFamilyHandle* column_family,
                               const Slice& property, uint64_t* value) = 0;
   virtual bool GetIntProperty(const Slice& property, uint64_t* value) {
@@ -1016,6 +1054,38 @@ class DB {
   // The sequence number of the most recent transaction.
   virtual SequenceNumber GetLatestSequenceNumber() const = 0;
 
+  // Calls `callback` once data newer than `seq` may have been committed to
+  // the user keys [*begin, *end) of `column_family`, nullptr standing for an
+  // unbounded side. Only committed writes are tracked, not which keys they
+  // touched, so if the DB is already past `seq` the callback is called
+  // right away. A consumer of a tailing iterator reads until Valid() turns
+  // false, registers with the sequence number it read
+  // GetLatestSequenceNumber() before, and continues when it is called back.
+  // `callback` must stay alive until it was called or unregistered.
+  virtual Status RegisterNewDataCallback(ColumnFamilyHandle* /*column_family*/,
+                                         SequenceNumber /*seq*/,
+                                         const Slice* /*begin*/,
+                                         const Slice* /*end*/,
+                                         NewDataCallback* /*callback*/) {
+    return Status::NotSupported("RegisterNewDataCallback not implemented");
+  }
+
+  // Returns true if `callback` was registered and had not been called yet,
+  // it is not called after this returns.
+  virtual bool UnregisterNewDataCallback(NewDataCallback* /*callback*/) {
+    return false;
+  }
+
+  // Blocking version of RegisterNewDataCallback(). Returns OK once data newer
+  // than `seq` may have been committed to [*begin, *end), TimedOut after
+  // `timeout_micros` (0 waits forever) or ShutdownInProgress.
+  virtual Status WaitForNewData(ColumnFamilyHandle* /*column_family*/,
+                                SequenceNumber /*seq*/, const Slice* /*begin*/,
+                                const Slice* /*end*/,
+                                uint64_t /*timeout_micros*/ = 0) {
+    return Status::NotSupported("WaitForNewData not implemented");
+  }
+
   // Instructs DB to preserve deletes with sequence numbers >= passed seqnum.
   // Has no effect if DBOptions.preserve_deletes is set to false.
   // This function assumes that user calls this function with monotonically
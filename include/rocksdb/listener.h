@@ -52,6 +52,7 @@ class DB;
 class ColumnFamilyHandle;
 class Status;
 struct CompactionJobStats;
+struct PerfContext;
 enum CompressionType : unsigned char;
 
 enum class TableFileCreationReason {
@@ -180,6 +181,18 @@ struct WriteStallInfo {
   } condition;
 };
 
+enum class PerfSampleOperation : unsigned char {
+  kGet,
+  kMultiGet,
+  kSeek,
+  kWrite,
+  kFlush,
+  kCompaction,
+  kNumOperations,
+};
+
+extern const char* GetPerfSampleOperationName(PerfSampleOperation op);
+
 #ifndef ROCKSDB_LITE
 
 struct TableFileDeletionInfo {
@@ -208,6 +221,20 @@ struct FileOperationInfo {
       : path(_path), start_timestamp(start), finish_timestamp(finish) {}
 };
 
+struct PerfSampleInfo {
+  // the sampled operation
+  PerfSampleOperation operation;
+  // id of the thread which ran the operation
+  uint64_t thread_id;
+  // the time the operation started, in microseconds since epoch
+  uint64_t start_micros;
+  // wall time of the operation
+  uint64_t elapsed_nanos;
+  // counters accumulated by this operation only, collected with
+  // PerfLevel::kEnableTimeExceptForMutex. Only valid during the callback.
+  const PerfContext* perf_context;
+};
+
 struct FlushJobInfo {
   // the name of the column family
   std::string cf_name;
@@ -515,6 +542,15 @@ class EventListener {
   // initiate any further recovery actions needed
   virtual void OnErrorRecoveryCompleted(Status /* old_bg_error */) {}
 
+  // A callback function for RocksDB which will be called after an operation
+  // picked by DBOptions::perf_sampling_interval finishes, on the thread which
+  // ran the operation.
+  //
+  // Note that this function must be implemented in a way such that
+  // it should not run for an extended period of time before the function
+  // returns.  Otherwise, the sampled operation will be blocked.
+  virtual void OnPerfContextSampled(const PerfSampleInfo& /*info*/) {}
+
   virtual ~EventListener() {}
 };
 
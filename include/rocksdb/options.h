@@ -364,6 +364,18 @@ struct ColumnFamilyOptions : public AdvancedColumnFamilyOptions {
   // Default: 0
   size_t ttl_max_scan_gap = 0;
 
+  // If true, an SST whose every value carries a ttl that has passed is
+  // dropped by a metadata-only edit instead of being marked for compaction.
+  // Only files with nothing older beneath their key range, no range
+  // deletions and no snapshot that can see them are dropped. Enable it only
+  // when expired values are meant to be removed, e.g. by a compaction filter
+  // that uses the same ttl. A map sst is dropped when all the ssts it
+  // references are. Blob files go away once no remaining sst references
+  // them; an expired blob value still referenced by a live key sst is only
+  // reclaimed by compaction or blob gc.
+  // Default: false
+  bool ttl_drop_expired_files = false;
+
   // Create ColumnFamilyOptions with default values for all fields
   ColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -635,6 +647,19 @@ struct DBOptions {
   // Default: -1
   int max_background_flushes = -1;
 
+  // If true, flush, compaction, garbage collection and bottom compaction jobs
+  // of this DB may run on a thread of another priority pool when their own
+  // pool is busy and the other one has idle threads, one HIGH priority thread
+  // being always kept for flushes. While writes are slowed down for pending
+  // compactions, the number of concurrent compactions is also adjusted to the
+  // throughput measured at each concurrency level, so that compactions stop
+  // being added once the device is saturated.
+  // Jobs are queued per class and picked by priority (flush, compaction,
+  // garbage collection, bottom compaction) in either case, with jobs that
+  // waited too long going first. See DB::Properties::kBackgroundSchedulerStats.
+  // Default: false
+  bool adaptive_background_scheduling = false;
+
   // Specify the maximal size of the info log file. If the log file
   // is larger than `max_log_file_size`, a new info log file will
   // be created.
@@ -768,6 +793,17 @@ struct DBOptions {
   // Default: 1MB
   size_t stats_history_buffer_size = 1024 * 1024;
 
+  // If not zero, one in every perf_sampling_interval Get, MultiGet, Seek,
+  // Write, flush and compaction of each thread is run with
+  // PerfLevel::kEnableTimeExceptForMutex, and its PerfContext is kept in an
+  // in-memory ring buffer. The slowest samples can be queried with
+  // DB::GetProperty("rocksdb.perf-samples"), and every sample is reported to
+  // EventListener::OnPerfContextSampled.
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  uint32_t perf_sampling_interval = 0;
+
   // If set true, will hint the underlying file system that the file
   // access pattern is random, when a sst file is opened.
   // Default: true
@@ -930,6 +966,16 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint64_t delayed_write_rate = 0;
 
+  // If true, writes are not slowed down in steps once a slowdown threshold is
+  // hit. Instead the pending flush, compaction and blob garbage collection
+  // bytes and the read amplification of map SSTs are turned into a pressure
+  // that reaches 1 at the first stop threshold, and a feedback loop lowers
+  // the write rate as the pressure grows and raises it as it falls, starting
+  // below the slowdown thresholds. Stop thresholds still stop writes.
+  // See DB::Properties::kWriteControllerStats.
+  // Default: false
+  bool adaptive_write_throttling = false;
+
   // By default, a single write thread queue is maintained. The thread gets
   // to the head of the queue becomes write batch group leader and responsible
   // for writing to WAL and memtable for the batch group.
@@ -1255,6 +1301,27 @@ struct ReadOptions {
   // Default: empty (every table will be scanned)
   std::function<bool(const TableProperties&)> table_filter;
 
+  // Restrict reads to entries whose ttl time point, as given by the column
+  // family's ttl_extractor_factory, lies within [ttl_time_lower_bound,
+  // ttl_time_upper_bound]. SSTs whose recorded ttl time range lies outside
+  // the bounds are skipped by both Get and iterators without being opened.
+  // This is a pruning hint: entries outside the range are still returned
+  // from memtables and from files that are not skipped, and a skipped file
+  // may hold a newer version of a key found in an older file. Files with
+  // point or range deletions are never skipped. Meant for time series
+  // column families whose keys are written once.
+  // Default: 0 and UINT64_MAX (no time predicate)
+  uint64_t ttl_time_lower_bound;
+  uint64_t ttl_time_upper_bound;
+
+  // Projection for column families using a ColumnarTable. Bit i selects
+  // value column i, the bit after the last column selects the trailing
+  // bytes. Columns left out are not read and come back as zero bytes, or
+  // empty for variable length columns, so values keep their layout. Values
+  // stored whole and other table formats ignore it.
+  // Default: all columns
+  uint64_t column_mask;
+
   // Needed to support differential snapshots. Has 2 effects:
   // 1) Iterator will skip all internal keys with seqnum < iter_start_seqnum
   // 2) if this param > 0 iterator will return INTERNAL keys instead of
@@ -1451,6 +1518,14 @@ struct IngestExternalFileOptions {
   bool write_global_seqno = true;
   // Mark all files need compaction
   bool marked_for_compaction = false;
+  // Verify the block checksums of every file before it is ingested.
+  bool verify_checksums_before_ingest = false;
+  // Number of threads opening, verifying and copying or linking the files
+  // before ingestion, and warming their table readers afterwards.
+  int max_threads = 1;
+  // Open the table readers of the ingested files through the table cache once
+  // they are installed, so the first reads of them do not have to.
+  bool warm_table_cache = false;
 };
 
 // TraceOptions is used for StartTrace
@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
@@ -135,6 +136,57 @@ class SstFileWriter {
   struct Rep;
   std::unique_ptr<Rep> rep_;
 };
+
+struct SstFileBulkLoaderOptions {
+  // Directory the sst files are written to, file names are
+  // "<file_prefix><index>.sst". The directory must exist.
+  std::string path;
+  std::string file_prefix = "bulk_load_";
+  // Number of threads building files concurrently.
+  size_t num_threads = 4;
+  // The sorted stream is cut into a new file once this many key/value bytes
+  // were buffered for the current one.
+  uint64_t target_file_size = 64 << 20;
+  // Upper bound of files buffered but not yet built, the memory used by the
+  // loader is about (max_pending_files + num_threads) * target_file_size.
+  // Zero means num_threads.
+  size_t max_pending_files = 0;
+};
+
+// SstFileBulkLoader accepts a sorted stream of keys and cuts it into key
+// ranges, building one sst file per range on a pool of threads. Files are
+// non-overlapping and ordered, so passing the paths of all of them to a
+// single DB::IngestExternalFile() call commits them atomically with one
+// VersionEdit, into the bottommost level that has no overlapping data.
+// Table builders that budget their working memory (e.g. TerarkZipTable)
+// share that budget across the concurrent builds.
+class SstFileBulkLoader {
+ public:
+  SstFileBulkLoader(const EnvOptions& env_options, const Options& options,
+                    const SstFileBulkLoaderOptions& bulk_load_options,
+                    ColumnFamilyHandle* column_family = nullptr);
+
+  // Waits for the pending builds, files not returned by Finish() are deleted.
+  ~SstFileBulkLoader();
+
+  // REQUIRES: key is after any previously added key according to comparator.
+  Status Put(const Slice& user_key, const Slice& value);
+
+  // REQUIRES: key is after any previously added key according to comparator.
+  Status Merge(const Slice& user_key, const Slice& value);
+
+  // REQUIRES: key is after any previously added key according to comparator.
+  Status Delete(const Slice& user_key);
+
+  // Build the remaining files and wait for all of them. On success
+  // `file_info` holds the files in key order. Once an error happened, every
+  // call returns it and the files built so far are deleted.
+  Status Finish(std::vector<ExternalSstFileInfo>* file_info);
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
 }  // namespace TERARKDB_NAMESPACE
 
 #endif  // !ROCKSDB_LITE
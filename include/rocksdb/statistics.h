@@ -258,6 +258,12 @@ enum Tickers : uint32_t {
   GC_TOUCH_FILES,
   GC_SKIP_GET_BY_SEQ,
   GC_SKIP_GET_BY_FILE,
+
+  // # of files skipped by Get because a newer range deletion covers the key
+  GET_SKIP_FILE_BY_RANGE_DEL,
+  // # of files skipped by reads because their ttl time range lies outside
+  // ReadOptions::ttl_time_lower_bound/ttl_time_upper_bound
+  READ_SKIP_FILE_BY_TTL_TIME,
   TICKER_ENUM_MAX
 };
 
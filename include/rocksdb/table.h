@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "rocksdb/cache.h"
 #include "rocksdb/env.h"
@@ -100,6 +101,11 @@ struct BlockBasedTableOptions {
 
     // A two-level index implementation. Both levels are binary search indexes.
     kTwoLevelIndexSearch,
+
+    // A prefix stripped array of separators with fixed width offsets. With
+    // the bytewise comparator, a piecewise linear model of the key positions
+    // narrows the binary search of a lookup to a few entries.
+    kCompactIndexSearch,
   };
 
   IndexType index_type = kBinarySearch;
@@ -138,6 +144,21 @@ struct BlockBasedTableOptions {
   // IF NULL, no page cache is used
   std::shared_ptr<PersistentCache> persistent_cache = nullptr;
 
+  // If true, persistent_cache is filled with the uncompressed blocks evicted
+  // from block_cache instead of with every block read from the file, so it
+  // acts as a second tier of block_cache. Blocks found in persistent_cache
+  // are promoted back to block_cache. Requires an LRU or LIRS block_cache
+  // and a persistent_cache which is not compressed, ignored otherwise. The
+  // evicting thread only copies the block, a background thread writes it
+  // into persistent_cache; up to 16MB of blocks wait for it, more are
+  // dropped.
+  //
+  // The factory registers with block_cache while it lives. Factories that
+  // share block_cache but not persistent_cache each receive every evicted
+  // block. Blobs are stored in SSTs built by this factory too, so blob value
+  // reads share the same tiers.
+  bool persistent_cache_admit_evicted = false;
+
   // If non-NULL use the specified cache for compressed blocks.
   // If NULL, rocksdb will not use a compressed block cache.
   // Note: though it looks similar to `block_cache`, RocksDB doesn't put the
@@ -429,6 +450,71 @@ struct CuckooTableOptions {
 extern TableFactory* NewCuckooTableFactory(
     const CuckooTableOptions& table_options = CuckooTableOptions());
 
+struct ColumnarTablePropertyNames {
+  // Encoded column declarations of the values in the file
+  static const std::string kColumns;
+};
+
+// A column of the fixed-schema values stored in a ColumnarTable.
+struct ColumnarTableColumn {
+  enum Type : unsigned char {
+    // `size` bytes, at most 8, read as an integer to apply `encoding` to
+    kFixedLength,
+    // `size` bytes stored as they are
+    kLongFixedLength,
+    // One byte length k followed by k bytes
+    kVariableLength,
+    // 8 byte chunks, each followed by a mark byte: 0xFF if another chunk
+    // follows, otherwise 0xF7 plus the number of used bytes in the chunk.
+    // Unused bytes of the last chunk must be zero.
+    kVariableChunk,
+  };
+  enum Encoding : unsigned char {
+    kPlain,
+    kRle,
+    kVarint,
+    kRleVarint,
+    kDeltaVarint,
+    kRleDeltaVarint,
+    kDict,
+    kRleDict,
+  };
+
+  Type type = kLongFixedLength;
+  // Encoding of a kFixedLength column, a kVariableChunk column supports
+  // kPlain and kDict, other types are always kPlain.
+  Encoding encoding = kPlain;
+  // Size of kFixedLength and kLongFixedLength columns
+  size_t size = 0;
+  // Whether a kFixedLength integer is big endian
+  bool big_endian = false;
+  // Block compression of this column
+  CompressionType compression = kNoCompression;
+};
+
+struct ColumnarTableOptions {
+  // The columns a value is made of, in order. The bytes after the last
+  // column are kept as one more column. Values that do not parse into these
+  // columns, and entries that are not plain values, are stored whole.
+  std::vector<ColumnarTableColumn> columns;
+  // Number of entries per block. Each column of a block is compressed and
+  // read separately.
+  size_t block_rows = 4096;
+  // Compression of the keys, the trailing bytes and the whole values
+  CompressionType compression = kNoCompression;
+};
+
+// Columnar Table Factory for SST files storing fixed-schema values column by
+// column, so scans selecting a few columns through ReadOptions::column_mask
+// only read and decode those columns.
+//
+// Some assumptions:
+// - Does not support range deletions.
+// - Does not support prefix bloom filters.
+// - Meant for scans, a point lookup decodes a whole block.
+extern TableFactory* NewColumnarTableFactory(
+    const ColumnarTableOptions& table_options = ColumnarTableOptions());
+
 #endif  // ROCKSDB_LITE
 
 class RandomAccessFileReader;
@@ -71,6 +71,8 @@ struct TablePropertiesNames {
   static const std::string kInheritanceTree;
   static const std::string kEarliestTimeBeginCompact;
   static const std::string kLatestTimeEndCompact;
+  static const std::string kLatestTimeExpire;
+  static const std::string kEarliestTimeExpire;
 };
 
 extern const std::string kPropertiesBlock;
@@ -287,5 +289,11 @@ extern uint64_t GetMergeOperands(const UserCollectedProperties& props,
 extern void GetCompactionTimePoint(const UserCollectedProperties& props,
                                    uint64_t* earliest_time_begin_compact,
                                    uint64_t* latest_time_end_compact);
+// Returns the time point at which every entry of the table has expired, or
+// port::kMaxUint64 if some entry never expires
+extern uint64_t GetLatestTimeExpire(const UserCollectedProperties& props);
+// Returns the earliest ttl time point among the entries of the table,
+// port::kMaxUint64 if no entry has a ttl, or 0 if unknown
+extern uint64_t GetEarliestTimeExpire(const UserCollectedProperties& props);
 
 }  // namespace TERARKDB_NAMESPACE
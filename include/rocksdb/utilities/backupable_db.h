@@ -99,6 +99,16 @@ struct BackupableDBOptions {
   // *turn it on only if you know what you're doing*
   bool share_files_with_checksum;
 
+  // Only used if share_table_files is set to true. If true, a live table file
+  // that a previous backup already holds in the shared directory with the
+  // same name and size is reused together with the checksum recorded by that
+  // backup, instead of being read again to compute its checksum. Table and
+  // blob files never change once written, so successive backups of the same
+  // DB only read and copy the physical files that are new since the last one,
+  // however large the blob files they keep referencing are.
+  // Default: false
+  bool reuse_shared_file_checksums;
+
   // Up to this many background threads will copy files for CreateNewBackup()
   // and RestoreDBFromBackup()
   // Default: 1
@@ -140,6 +150,7 @@ struct BackupableDBOptions {
         backup_rate_limit(_backup_rate_limit),
         restore_rate_limit(_restore_rate_limit),
         share_files_with_checksum(false),
+        reuse_shared_file_checksums(false),
         max_background_operations(_max_background_operations),
         callback_trigger_interval_size(_callback_trigger_interval_size),
         max_valid_backups_to_open(_max_valid_backups_to_open) {
@@ -155,8 +166,18 @@ struct RestoreOptions {
   // Default: false
   bool keep_log_files;
 
-  explicit RestoreOptions(bool _keep_log_files = false)
-      : keep_log_files(_keep_log_files) {}
+  // If true, files in the shared directories of the backup are hard linked
+  // into db_dir instead of being copied, falling back to a copy when the link
+  // fails (e.g. backup and DB are on different file systems). Linked files
+  // are not read back, so their checksums are not verified; use
+  // VerifyBackup(backup_id, true) first if that matters.
+  // Default: false
+  bool link_shared_files;
+
+  explicit RestoreOptions(bool _keep_log_files = false,
+                          bool _link_shared_files = false)
+      : keep_log_files(_keep_log_files),
+        link_shared_files(_link_shared_files) {}
 };
 
 typedef uint32_t BackupID;
@@ -240,7 +261,9 @@ class BackupEngineReadOnly {
       const RestoreOptions& restore_options = RestoreOptions()) = 0;
 
   // checks that each file exists and that the size of the file matches our
-  // expectations. it does not check file checksum.
+  // expectations. if verify_with_checksum is true, it also reads every file
+  // of the backup on the background threads and compares its crc32c against
+  // the one recorded in the backup meta.
   //
   // If this BackupEngine created the backup, it compares the files' current
   // sizes against the number of bytes written to them during creation.
@@ -248,7 +271,8 @@ class BackupEngineReadOnly {
   // the BackupEngine was opened.
   //
   // Returns Status::OK() if all checks are good
-  virtual Status VerifyBackup(BackupID backup_id) = 0;
+  virtual Status VerifyBackup(BackupID backup_id,
+                              bool verify_with_checksum = false) = 0;
 };
 
 // A backup engine for creating new backups.
@@ -320,9 +344,11 @@ class BackupEngine {
       const RestoreOptions& restore_options = RestoreOptions()) = 0;
 
   // checks that each file exists and that the size of the file matches our
-  // expectations. it does not check file checksum.
+  // expectations. if verify_with_checksum is true, it also checks the crc32c
+  // of every file.
   // Returns Status::OK() if all checks are good
-  virtual Status VerifyBackup(BackupID backup_id) = 0;
+  virtual Status VerifyBackup(BackupID backup_id,
+                              bool verify_with_checksum = false) = 0;
 
   // Will delete all the files we don't need anymore
   // It will do the full scan of the files/ directory and delete all the
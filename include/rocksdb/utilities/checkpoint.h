@@ -38,6 +38,16 @@ class Checkpoint {
   virtual Status CreateCheckpoint(const std::string& checkpoint_dir,
                                   uint64_t log_size_for_flush = 0);
 
+  // Builds an openable snapshot like CreateCheckpoint(), for DBs with many
+  // files. Only the files of the current version of each column family,
+  // blob and dependence files included, are linked, by up to max_threads
+  // threads, and instead of copying the MANIFEST with its whole history a new
+  // one describing the current version alone is written, after file
+  // deletions are enabled again. Memtables are always flushed first.
+  // Not supported with 2PC.
+  virtual Status CreateCompactCheckpoint(const std::string& checkpoint_dir,
+                                         int max_threads = 1);
+
   virtual ~Checkpoint() {}
 };
 
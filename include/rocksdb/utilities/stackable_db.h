@@ -306,6 +306,25 @@ class StackableDB : public DB {
     return db_->GetLatestSequenceNumber();
   }
 
+  virtual Status RegisterNewDataCallback(ColumnFamilyHandle* column_family,
+                                         SequenceNumber seq, const Slice* begin,
+                                         const Slice* end,
+                                         NewDataCallback* callback) override {
+    return db_->RegisterNewDataCallback(column_family, seq, begin, end,
+                                        callback);
+  }
+
+  virtual bool UnregisterNewDataCallback(NewDataCallback* callback) override {
+    return db_->UnregisterNewDataCallback(callback);
+  }
+
+  virtual Status WaitForNewData(ColumnFamilyHandle* column_family,
+                                SequenceNumber seq, const Slice* begin,
+                                const Slice* end,
+                                uint64_t timeout_micros = 0) override {
+    return db_->WaitForNewData(column_family, seq, begin, end, timeout_micros);
+  }
+
   virtual bool SetPreserveDeletesSequenceNumber(
       SequenceNumber seqnum) override {
     return db_->SetPreserveDeletesSequenceNumber(seqnum);
@@ -492,7 +492,18 @@ public enum TickerType {
 
     SKIP_GC_GET_BY_FILE((byte) 0x64),
 
-    TICKER_ENUM_MAX((byte) 0x65);
+    /**
+     * # of files skipped by Get because a newer range deletion covers the key.
+     */
+    GET_SKIP_FILE_BY_RANGE_DEL((byte) 0x65),
+
+    /**
+     * # of files skipped by reads because their ttl time range lies outside
+     * the ttl time bounds of the read options.
+     */
+    READ_SKIP_FILE_BY_TTL_TIME((byte) 0x66),
+
+    TICKER_ENUM_MAX((byte) 0x67);
 
 
     private final byte value;
@@ -0,0 +1,270 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include "monitoring/hdr_histogram.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "rocksdb/terark_namespace.h"
+#include "util/cast_util.h"
+
+namespace TERARKDB_NAMESPACE {
+
+uint64_t HdrHistogramStat::BucketLowerBound(size_t index) {
+  assert(index < kBucketCount);
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  size_t i = index - kSubBucketCount;
+  size_t shift = i / kSubBucketHalf + 1;
+  uint64_t sub = i % kSubBucketHalf + kSubBucketHalf;
+  return sub << shift;
+}
+
+uint64_t HdrHistogramStat::BucketUpperBound(size_t index) {
+  assert(index < kBucketCount);
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  size_t shift = (index - kSubBucketCount) / kSubBucketHalf + 1;
+  return BucketLowerBound(index) + ((uint64_t(1) << shift) - 1);
+}
+
+void HdrHistogramStat::Clear() {
+  min_.store(port::kMaxUint64, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  num_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  sum_squares_.store(0, std::memory_order_relaxed);
+  for (auto& b : buckets_) {
+    b.store(0, std::memory_order_relaxed);
+  }
+}
+
+void HdrHistogramStat::Merge(const HdrHistogramStat& other) {
+  uint64_t old_min = min();
+  uint64_t other_min = other.min();
+  while (other_min < old_min &&
+         !min_.compare_exchange_weak(old_min, other_min)) {
+  }
+
+  uint64_t old_max = max();
+  uint64_t other_max = other.max();
+  while (other_max > old_max &&
+         !max_.compare_exchange_weak(old_max, other_max)) {
+  }
+
+  num_.fetch_add(other.num(), std::memory_order_relaxed);
+  sum_.fetch_add(other.sum(), std::memory_order_relaxed);
+  sum_squares_.fetch_add(other.sum_squares(), std::memory_order_relaxed);
+  for (size_t b = 0; b < kBucketCount; ++b) {
+    uint64_t count = other.bucket_at(b);
+    if (count != 0) {
+      buckets_[b].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+}
+
+double HdrHistogramStat::Percentile(double p) const {
+  uint64_t cur_num = num();
+  if (cur_num == 0) {
+    return 0;
+  }
+  double threshold = cur_num * (p / 100.0);
+  uint64_t cumulative_sum = 0;
+  for (size_t b = 0; b < kBucketCount; ++b) {
+    uint64_t bucket_value = bucket_at(b);
+    if (bucket_value == 0) {
+      continue;
+    }
+    cumulative_sum += bucket_value;
+    if (cumulative_sum >= threshold) {
+      // Scale linearly within this bucket, which covers (left, right]
+      double left_point = static_cast<double>(BucketLowerBound(b)) - 1;
+      double right_point = static_cast<double>(BucketUpperBound(b));
+      uint64_t left_sum = cumulative_sum - bucket_value;
+      double pos = (threshold - left_sum) / bucket_value;
+      double r = left_point + (right_point - left_point) * pos;
+      uint64_t cur_min = min();
+      uint64_t cur_max = max();
+      if (r < cur_min) r = static_cast<double>(cur_min);
+      if (r > cur_max) r = static_cast<double>(cur_max);
+      return r;
+    }
+  }
+  return static_cast<double>(max());
+}
+
+double HdrHistogramStat::Average() const {
+  uint64_t cur_num = num();
+  uint64_t cur_sum = sum();
+  if (cur_num == 0) return 0;
+  return static_cast<double>(cur_sum) / static_cast<double>(cur_num);
+}
+
+double HdrHistogramStat::StandardDeviation() const {
+  uint64_t cur_num = num();
+  uint64_t cur_sum = sum();
+  uint64_t cur_sum_squares = sum_squares();
+  if (cur_num == 0) return 0;
+  double variance =
+      static_cast<double>(cur_sum_squares * cur_num - cur_sum * cur_sum) /
+      static_cast<double>(cur_num * cur_num);
+  return sqrt(variance);
+}
+
+void HdrHistogramStat::Data(HistogramData* const data) const {
+  assert(data);
+  data->median = Median();
+  data->percentile95 = Percentile(95);
+  data->percentile99 = Percentile(99);
+  data->percentile999 = Percentile(99.9);
+  data->max = static_cast<double>(max());
+  data->average = Average();
+  data->standard_deviation = StandardDeviation();
+  data->count = num();
+  data->sum = sum();
+}
+
+std::string HdrHistogramStat::ToString() const {
+  uint64_t cur_num = num();
+  std::string r;
+  char buf[1650];
+  snprintf(buf, sizeof(buf), "Count: %" PRIu64 " Average: %.4f  StdDev: %.2f\n",
+           cur_num, Average(), StandardDeviation());
+  r.append(buf);
+  snprintf(buf, sizeof(buf),
+           "Min: %" PRIu64 "  Median: %.4f  Max: %" PRIu64 "\n",
+           (cur_num == 0 ? 0 : min()), Median(), (cur_num == 0 ? 0 : max()));
+  r.append(buf);
+  snprintf(buf, sizeof(buf),
+           "Percentiles: "
+           "P50: %.2f P75: %.2f P99: %.2f P99.9: %.2f P99.99: %.2f\n",
+           Percentile(50), Percentile(75), Percentile(99), Percentile(99.9),
+           Percentile(99.99));
+  r.append(buf);
+  r.append("------------------------------------------------------\n");
+  if (cur_num == 0) return r;  // all buckets are empty
+  const double mult = 100.0 / cur_num;
+  uint64_t cumulative_sum = 0;
+  for (size_t b = 0; b < kBucketCount; ++b) {
+    uint64_t bucket_value = bucket_at(b);
+    if (bucket_value == 0) continue;
+    cumulative_sum += bucket_value;
+    snprintf(buf, sizeof(buf),
+             "[ %7" PRIu64 ", %7" PRIu64 " ] %8" PRIu64 " %7.3f%% %7.3f%% ",
+             BucketLowerBound(b),       // left
+             BucketUpperBound(b),       // right
+             bucket_value,              // count
+             (mult * bucket_value),     // percentage
+             (mult * cumulative_sum));  // cumulative percentage
+    r.append(buf);
+
+    // Add hash marks based on percentage; 20 marks for 100%.
+    size_t marks = static_cast<size_t>(mult * bucket_value / 5 + 0.5);
+    r.append(marks, '#');
+    r.push_back('\n');
+  }
+  return r;
+}
+
+void HdrHistogramImpl::Clear() {
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    per_core_stats_.AccessAtCore(i)->Clear();
+  }
+}
+
+void HdrHistogramImpl::Merge(const Histogram& other) {
+  if (strcmp(Name(), other.Name()) == 0) {
+    Merge(*static_cast_with_check<const HdrHistogramImpl, const Histogram>(
+        &other));
+  }
+}
+
+void HdrHistogramImpl::Merge(const HdrHistogramImpl& other) {
+  auto* stat = per_core_stats_.Access();
+  for (size_t i = 0; i < other.per_core_stats_.Size(); ++i) {
+    stat->Merge(*other.per_core_stats_.AccessAtCore(i));
+  }
+}
+
+void HdrHistogramImpl::Snapshot(HdrHistogramStat* snapshot) const {
+  assert(snapshot->Empty());
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    snapshot->Merge(*per_core_stats_.AccessAtCore(i));
+  }
+}
+
+uint64_t HdrHistogramImpl::min() const {
+  uint64_t res = port::kMaxUint64;
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    res = std::min(res, per_core_stats_.AccessAtCore(i)->min());
+  }
+  return res;
+}
+
+uint64_t HdrHistogramImpl::max() const {
+  uint64_t res = 0;
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    res = std::max(res, per_core_stats_.AccessAtCore(i)->max());
+  }
+  return res;
+}
+
+uint64_t HdrHistogramImpl::num() const {
+  uint64_t res = 0;
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    res += per_core_stats_.AccessAtCore(i)->num();
+  }
+  return res;
+}
+
+double HdrHistogramImpl::Percentile(double p) const {
+  std::unique_ptr<HdrHistogramStat> snapshot(new HdrHistogramStat);
+  Snapshot(snapshot.get());
+  return snapshot->Percentile(p);
+}
+
+double HdrHistogramImpl::Average() const {
+  uint64_t cur_num = 0;
+  uint64_t cur_sum = 0;
+  for (size_t i = 0; i < per_core_stats_.Size(); ++i) {
+    auto* stat = per_core_stats_.AccessAtCore(i);
+    cur_num += stat->num();
+    cur_sum += stat->sum();
+  }
+  if (cur_num == 0) return 0;
+  return static_cast<double>(cur_sum) / static_cast<double>(cur_num);
+}
+
+double HdrHistogramImpl::StandardDeviation() const {
+  std::unique_ptr<HdrHistogramStat> snapshot(new HdrHistogramStat);
+  Snapshot(snapshot.get());
+  return snapshot->StandardDeviation();
+}
+
+std::string HdrHistogramImpl::ToString() const {
+  std::unique_ptr<HdrHistogramStat> snapshot(new HdrHistogramStat);
+  Snapshot(snapshot.get());
+  return snapshot->ToString();
+}
+
+void HdrHistogramImpl::Data(HistogramData* const data) const {
+  std::unique_ptr<HdrHistogramStat> snapshot(new HdrHistogramStat);
+  Snapshot(snapshot.get());
+  snapshot->Data(data);
+}
+
+}  // namespace TERARKDB_NAMESPACE
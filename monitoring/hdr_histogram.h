@@ -0,0 +1,164 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <string>
+
+#include "monitoring/histogram.h"
+#include "port/port.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/core_local.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Log-linear ("HDR style") histogram. Values below kSubBucketCount get one
+// bucket each, every following power of two is split into kSubBucketHalf
+// equal-width buckets. The bucket of a value is computed with a single
+// count-leading-zeros, and the width of any bucket is at most 1/32 of its
+// lower bound, so tail percentiles such as P99.9 and P99.99 keep their
+// precision no matter how large the values are.
+//
+// Add() only performs relaxed loads and stores; concurrent writers must be
+// sharded (see HdrHistogramImpl) if exact counts are required.
+//
+// Memory: kBucketCount (1920) 8-byte buckets plus five counters, about 15 KB
+// per instance.
+struct ALIGN_AS(CACHE_LINE_SIZE) HdrHistogramStat {
+  enum : uint64_t {
+    kSubBucketBits = 6,
+    kSubBucketCount = 1ull << kSubBucketBits,
+    kSubBucketHalf = kSubBucketCount / 2,
+    kBucketCount = kSubBucketCount + (64 - kSubBucketBits) * kSubBucketHalf,
+  };
+
+  HdrHistogramStat() { Clear(); }
+
+  HdrHistogramStat(const HdrHistogramStat&) = delete;
+  HdrHistogramStat& operator=(const HdrHistogramStat&) = delete;
+
+  static size_t IndexForValue(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+    // msb >= kSubBucketBits, so shift >= 1
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - (kSubBucketBits - 1);
+    uint64_t sub = value >> shift;  // in [kSubBucketHalf, kSubBucketCount)
+    return static_cast<size_t>(kSubBucketCount +
+                               (shift - 1) * kSubBucketHalf +
+                               (sub - kSubBucketHalf));
+  }
+  // Smallest value that falls into bucket `index`
+  static uint64_t BucketLowerBound(size_t index);
+  // Largest value that falls into bucket `index`
+  static uint64_t BucketUpperBound(size_t index);
+
+  void Clear();
+  bool Empty() const { return num() == 0; }
+
+  void Add(uint64_t value) {
+    auto& bucket = buckets_[IndexForValue(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    if (value < min_.load(std::memory_order_relaxed)) {
+      min_.store(value, std::memory_order_relaxed);
+    }
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+    num_.store(num_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+    sum_squares_.store(
+        sum_squares_.load(std::memory_order_relaxed) + value * value,
+        std::memory_order_relaxed);
+  }
+  // Unlike Add(), Merge() uses atomic RMW so it may race with Add()
+  void Merge(const HdrHistogramStat& other);
+
+  uint64_t min() const { return min_.load(std::memory_order_relaxed); }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+  uint64_t num() const { return num_.load(std::memory_order_relaxed); }
+  uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t sum_squares() const {
+    return sum_squares_.load(std::memory_order_relaxed);
+  }
+  uint64_t bucket_at(size_t b) const {
+    return buckets_[b].load(std::memory_order_relaxed);
+  }
+
+  double Median() const { return Percentile(50.0); }
+  double Percentile(double p) const;
+  double Average() const;
+  double StandardDeviation() const;
+  void Data(HistogramData* const data) const;
+  std::string ToString() const;
+
+  void* operator new(size_t s) { return port::cacheline_aligned_alloc(s); }
+  void* operator new[](size_t s) { return port::cacheline_aligned_alloc(s); }
+  void operator delete(void* p) { port::cacheline_aligned_free(p); }
+  void operator delete[](void* p) { port::cacheline_aligned_free(p); }
+
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+  std::atomic<uint64_t> num_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> sum_squares_;
+  std::atomic<uint64_t> buckets_[kBucketCount];
+};
+
+// A HdrHistogramStat per core. Add() touches only the current core's shard,
+// readers merge all shards into a temporary snapshot, so the hot path never
+// takes a lock nor issues an atomic read-modify-write.
+//
+// An update is lost only when a writer is preempted (or migrates) between
+// the load and the store of a counter while another writer adds to the same
+// shard, i.e. at most one lost sample per such context switch. Writers that
+// each own a core never lose updates.
+//
+// Memory: one 15 KB HdrHistogramStat per shard, and there are as many shards
+// as cpus rounded up to a power of two, at least 8 (120 KB on up to 8 cpus,
+// 960 KB on 64). Each Percentile(), Median(), StandardDeviation(), ToString()
+// and Data() call builds a 15 KB heap snapshot, so prefer one Data() call
+// over several getters; min(), max(), num() and Average() read the shards.
+class HdrHistogramImpl : public Histogram {
+ public:
+  HdrHistogramImpl() = default;
+
+  HdrHistogramImpl(const HdrHistogramImpl&) = delete;
+  HdrHistogramImpl& operator=(const HdrHistogramImpl&) = delete;
+
+  virtual void Clear() override;
+  virtual bool Empty() const override { return num() == 0; }
+  virtual void Add(uint64_t value) override {
+    per_core_stats_.Access()->Add(value);
+  }
+  virtual void Merge(const Histogram& other) override;
+  void Merge(const HdrHistogramImpl& other);
+
+  virtual std::string ToString() const override;
+  virtual const char* Name() const override { return "HdrHistogramImpl"; }
+  virtual uint64_t min() const override;
+  virtual uint64_t max() const override;
+  virtual uint64_t num() const override;
+  virtual double Median() const override { return Percentile(50.0); }
+  virtual double Percentile(double p) const override;
+  virtual double Average() const override;
+  virtual double StandardDeviation() const override;
+  virtual void Data(HistogramData* const data) const override;
+
+  // Merge all per core shards into `snapshot`, which should be empty
+  void Snapshot(HdrHistogramStat* snapshot) const;
+
+  virtual ~HdrHistogramImpl() {}
+
+ private:
+  CoreLocalArray<HdrHistogramStat> per_core_stats_;
+};
+
+}  // namespace TERARKDB_NAMESPACE
@@ -17,6 +17,7 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include "port/port.h"
@@ -29,7 +30,6 @@ HistogramBucketMapper::HistogramBucketMapper() {
   // If you change this, you also need to change
   // size of array buckets_ in HistogramImpl
   bucketValues_ = {1, 2};
-  valueIndexMap_ = {{1, 0}, {2, 1}};
   double bucket_val = static_cast<double>(bucketValues_.back());
   while ((bucket_val = 1.5 * bucket_val) <=
          static_cast<double>(port::kMaxUint64)) {
@@ -42,7 +42,6 @@ HistogramBucketMapper::HistogramBucketMapper() {
       pow_of_ten *= 10;
     }
     bucketValues_.back() *= pow_of_ten;
-    valueIndexMap_[bucketValues_.back()] = bucketValues_.size() - 1;
   }
   maxBucketValue_ = bucketValues_.back();
   minBucketValue_ = bucketValues_.front();
@@ -52,13 +51,11 @@ size_t HistogramBucketMapper::IndexForValue(const uint64_t value) const {
   if (value >= maxBucketValue_) {
     return bucketValues_.size() - 1;
   } else if (value >= minBucketValue_) {
-    std::map<uint64_t, uint64_t>::const_iterator lowerBound =
-        valueIndexMap_.lower_bound(value);
-    if (lowerBound != valueIndexMap_.end()) {
-      return static_cast<size_t>(lowerBound->second);
-    } else {
-      return 0;
-    }
+    // bucketValues_ is sorted and contiguous, which makes a binary search far
+    // cheaper than walking a std::map on this hot path
+    return static_cast<size_t>(
+        std::lower_bound(bucketValues_.begin(), bucketValues_.end(), value) -
+        bucketValues_.begin());
   } else {
     return 0;
   }
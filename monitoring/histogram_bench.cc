@@ -0,0 +1,135 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "monitoring/hdr_histogram.h"
+#include "monitoring/histogram.h"
+#include "monitoring/histogram_windowing.h"
+#include "monitoring/statistics.h"
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/gflags_compat.h"
+#include "util/random.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+
+DEFINE_int32(threads, 16, "Number of concurrent threads to run.");
+DEFINE_uint64(ops_per_thread, 10000000, "Number of samples per thread.");
+DEFINE_uint64(max_value, 100000, "Samples are uniform in [0, max_value).");
+DEFINE_string(benchmarks, "histogram,windowing,statistics,hdr",
+              "Comma-separated list of histogram implementations to run:\n"
+              "\thistogram  -- HistogramImpl shared by all threads\n"
+              "\twindowing  -- HistogramWindowingImpl shared by all threads\n"
+              "\tstatistics -- StatisticsImpl::measureTime\n"
+              "\thdr        -- per-core sharded HdrHistogramImpl");
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+template <class AddFunc>
+void RunBench(const char* name, AddFunc add, Histogram* result) {
+  Env* env = Env::Default();
+  std::vector<port::Thread> threads;
+  uint64_t start = env->NowNanos();
+  for (int t = 0; t < FLAGS_threads; ++t) {
+    threads.emplace_back([&add, t] {
+      Random64 rnd(301 + t);
+      for (uint64_t i = 0; i < FLAGS_ops_per_thread; ++i) {
+        add(rnd.Uniform(FLAGS_max_value));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  uint64_t elapsed = env->NowNanos() - start;
+  uint64_t total_ops = FLAGS_ops_per_thread * FLAGS_threads;
+  fprintf(stdout,
+          "%-12s : %8.3f ns/sample (wall, %d threads) %8.3f ns/sample "
+          "(per thread) count %" PRIu64 "/%" PRIu64 "\n",
+          name, static_cast<double>(elapsed) / total_ops, FLAGS_threads,
+          static_cast<double>(elapsed) / FLAGS_ops_per_thread,
+          result == nullptr ? total_ops : result->num(), total_ops);
+  if (result != nullptr) {
+    fprintf(stdout,
+            "%-12s   P50 %.2f P99 %.2f P99.9 %.2f P99.99 %.2f (expect %.2f "
+            "%.2f %.2f %.2f)\n",
+            "", result->Percentile(50), result->Percentile(99),
+            result->Percentile(99.9), result->Percentile(99.99),
+            FLAGS_max_value * 0.5, FLAGS_max_value * 0.99,
+            FLAGS_max_value * 0.999, FLAGS_max_value * 0.9999);
+  }
+}
+
+}  // namespace
+
+void Run() {
+  fprintf(stdout, "Threads          : %d\n", FLAGS_threads);
+  fprintf(stdout, "Ops per thread   : %" PRIu64 "\n", FLAGS_ops_per_thread);
+  fprintf(stdout, "Max value        : %" PRIu64 "\n", FLAGS_max_value);
+
+  std::string benchmarks = FLAGS_benchmarks;
+  size_t pos = 0;
+  while (pos <= benchmarks.size()) {
+    size_t next = benchmarks.find(',', pos);
+    if (next == std::string::npos) {
+      next = benchmarks.size();
+    }
+    std::string name = benchmarks.substr(pos, next - pos);
+    pos = next + 1;
+    if (name == "histogram") {
+      HistogramImpl hist;
+      RunBench(name.c_str(), [&hist](uint64_t v) { hist.Add(v); }, &hist);
+    } else if (name == "windowing") {
+      HistogramWindowingImpl hist;
+      RunBench(name.c_str(), [&hist](uint64_t v) { hist.Add(v); }, &hist);
+    } else if (name == "statistics") {
+      StatisticsImpl stats(nullptr);
+      RunBench(name.c_str(),
+               [&stats](uint64_t v) { stats.measureTime(DB_GET, v); },
+               nullptr);
+    } else if (name == "hdr") {
+      HdrHistogramImpl hist;
+      RunBench(name.c_str(), [&hist](uint64_t v) { hist.Add(v); }, &hist);
+    } else if (!name.empty()) {
+      fprintf(stderr, "unknown benchmark '%s'\n", name.c_str());
+    }
+  }
+}
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_threads <= 0 || FLAGS_max_value == 0) {
+    fprintf(stderr, "threads and max_value must be positive\n");
+    exit(1);
+  }
+
+  TERARKDB_NAMESPACE::Run();
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -5,8 +5,15 @@
 //
 #include "monitoring/histogram.h"
 
+#ifdef OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
 #include <cmath>
 
+#include "monitoring/hdr_histogram.h"
 #include "monitoring/histogram_windowing.h"
 #include "rocksdb/terark_namespace.h"
 #include "util/testharness.h"
@@ -85,6 +92,9 @@ TEST_F(HistogramTest, BasicOperation) {
 
   HistogramWindowingImpl histogramWindowing;
   BasicOperation(histogramWindowing);
+
+  HdrHistogramImpl histogramHdr;
+  BasicOperation(histogramHdr);
 }
 
 TEST_F(HistogramTest, BoundaryValue) {
@@ -124,6 +134,9 @@ TEST_F(HistogramTest, ClearHistogram) {
 
   HistogramWindowingImpl histogramWindowing;
   ClearHistogram(histogramWindowing);
+
+  HdrHistogramImpl histogramHdr;
+  ClearHistogram(histogramHdr);
 }
 
 TEST_F(HistogramTest, HistogramWindowingExpire) {
@@ -215,6 +228,146 @@ TEST_F(HistogramTest, HistogramWindowingMerge) {
   ASSERT_EQ(histogramWindowing.max(), 5);
 }
 
+TEST_F(HistogramTest, HdrBucketLayout) {
+  // every value lands in a bucket whose bounds contain it, and the bucket
+  // width never exceeds 1/32 of its lower bound
+  for (int shift = 0; shift < 64; ++shift) {
+    for (uint64_t delta : {0, 1, 2, 3}) {
+      uint64_t v = (uint64_t(1) << shift) + delta - 1;
+      size_t index = HdrHistogramStat::IndexForValue(v);
+      ASSERT_LT(index, HdrHistogramStat::kBucketCount);
+      uint64_t lower = HdrHistogramStat::BucketLowerBound(index);
+      uint64_t upper = HdrHistogramStat::BucketUpperBound(index);
+      ASSERT_LE(lower, v);
+      ASSERT_GE(upper, v);
+      ASSERT_LE(upper - lower, lower / 32);
+    }
+  }
+  ASSERT_EQ(HdrHistogramStat::IndexForValue(port::kMaxUint64),
+            HdrHistogramStat::kBucketCount - 1);
+  ASSERT_EQ(HdrHistogramStat::BucketUpperBound(HdrHistogramStat::kBucketCount -
+                                               1),
+            port::kMaxUint64);
+  for (size_t i = 1; i < HdrHistogramStat::kBucketCount; ++i) {
+    ASSERT_EQ(HdrHistogramStat::BucketUpperBound(i - 1) + 1,
+              HdrHistogramStat::BucketLowerBound(i));
+  }
+}
+
+TEST_F(HistogramTest, HdrEmptyHistogram) {
+  HdrHistogramImpl histogram;
+  ASSERT_TRUE(histogram.Empty());
+  ASSERT_EQ(histogram.max(), 0);
+  ASSERT_EQ(histogram.num(), 0);
+  ASSERT_EQ(histogram.Median(), 0.0);
+  ASSERT_EQ(histogram.Percentile(99.99), 0.0);
+  ASSERT_EQ(histogram.Average(), 0.0);
+  ASSERT_EQ(histogram.StandardDeviation(), 0.0);
+}
+
+TEST_F(HistogramTest, HdrMergeHistogram) {
+  HdrHistogramImpl histogram;
+  HdrHistogramImpl other;
+  PopulateHistogram(histogram, 1, 100);
+  PopulateHistogram(other, 101, 250);
+  histogram.Merge(other);
+
+  HistogramData data;
+  histogram.Data(&data);
+
+  // Above 64 buckets are wider than kIota, but never wider than 1/32
+  ASSERT_LE(fabs(histogram.Percentile(100.0) - 250.0), kIota);
+  ASSERT_LE(fabs(data.percentile99 - 247.5), 247.5 / 32);
+  ASSERT_LE(fabs(data.percentile95 - 237.5), 237.5 / 32);
+  ASSERT_LE(fabs(data.median - 125.0), 125.0 / 32);
+  ASSERT_EQ(data.average, 125.5);
+  ASSERT_EQ(histogram.min(), 1);
+  ASSERT_EQ(histogram.max(), 250);
+  ASSERT_EQ(histogram.num(), 250);
+}
+
+TEST_F(HistogramTest, HdrTailPercentile) {
+  HdrHistogramImpl histogram;
+  // 1% of samples are 1000x slower, they must show up precisely in the tail
+  const uint64_t kNum = 1000000;
+  for (uint64_t i = 0; i < kNum; ++i) {
+    histogram.Add(i % 100 == 0 ? 10000000 + i : 10000 + i % 1000);
+  }
+  ASSERT_EQ(histogram.num(), kNum);
+  ASSERT_EQ(histogram.min(), 10001);
+  ASSERT_EQ(histogram.max(), 10000000 + kNum - 100);
+  double p99 = histogram.Percentile(99.0);
+  ASSERT_LE(p99, 11000 * (1 + 1.0 / 32));
+  double p999 = histogram.Percentile(99.9);
+  double p9999 = histogram.Percentile(99.99);
+  ASSERT_LE(fabs(p999 - 10900000) / 10900000, 1.0 / 32);
+  ASSERT_LE(fabs(p9999 - 10990000) / 10990000, 1.0 / 32);
+}
+
+TEST_F(HistogramTest, HdrConcurrentAdd) {
+  // Add() is exact as long as no two writers share a shard, so pin every
+  // writer to its own cpu, CoreLocalArray then maps each to its own shard
+  std::vector<int> cpus;
+#ifdef OS_LINUX
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE && cpus.size() < 8; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    cpus.push_back(-1);  // a single unpinned writer
+  }
+  const uint64_t kThreads = cpus.size();
+  const uint64_t kNumPerThread = 100000;
+
+  HdrHistogramImpl histogram;
+  std::atomic<bool> done{false};
+  // Readers merge shards while they are being written
+  port::Thread reader([&histogram, &done, kThreads] {
+    while (!done.load(std::memory_order_relaxed)) {
+      HistogramData data;
+      histogram.Data(&data);
+      ASSERT_LE(data.count, kThreads * kNumPerThread);
+    }
+  });
+  std::vector<port::Thread> threads;
+  for (uint64_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&histogram, &cpus, t] {
+#ifdef OS_LINUX
+      if (cpus[t] >= 0) {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpus[t], &mask);
+        ASSERT_EQ(0, pthread_setaffinity_np(pthread_self(), sizeof(mask),
+                                            &mask));
+      }
+#endif
+      for (uint64_t i = 1; i <= kNumPerThread; ++i) {
+        histogram.Add(i + t);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  done = true;
+  reader.join();
+
+  ASSERT_EQ(kThreads * kNumPerThread, histogram.num());
+  ASSERT_EQ(1, histogram.min());
+  ASSERT_EQ(kNumPerThread + kThreads - 1, histogram.max());
+  // sum of (i + t) over all i and t
+  double expected_average = (kNumPerThread + 1) / 2.0 + (kThreads - 1) / 2.0;
+  ASSERT_DOUBLE_EQ(expected_average, histogram.Average());
+  ASSERT_LE(fabs(histogram.Median() - kNumPerThread / 2.0) / kNumPerThread,
+            1.0 / 32);
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -0,0 +1,248 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include "monitoring/perf_sampler.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "monitoring/perf_level_imp.h"
+#include "port/port.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/random.h"
+
+namespace TERARKDB_NAMESPACE {
+
+const size_t PerfContextCounters::kOffset =
+    offsetof(PerfContext, user_key_comparison_count);
+const size_t PerfContextCounters::kCount =
+    (offsetof(PerfContext, env_new_logger_nanos) -
+     offsetof(PerfContext, user_key_comparison_count)) /
+        sizeof(uint64_t) +
+    1;
+
+const char* GetPerfSampleOperationName(PerfSampleOperation op) {
+  switch (op) {
+    case PerfSampleOperation::kGet:
+      return "Get";
+    case PerfSampleOperation::kMultiGet:
+      return "MultiGet";
+    case PerfSampleOperation::kSeek:
+      return "Seek";
+    case PerfSampleOperation::kWrite:
+      return "Write";
+    case PerfSampleOperation::kFlush:
+      return "Flush";
+    case PerfSampleOperation::kCompaction:
+      return "Compaction";
+    default:
+      return "Unknown";
+  }
+}
+
+struct PerfSampler::Slot {
+  // Odd while the slot is being written
+  std::atomic<uint64_t> seq{0};
+  PerfSampleOperation operation = PerfSampleOperation::kGet;
+  uint64_t thread_id = 0;
+  uint64_t start_micros = 0;
+  uint64_t elapsed_nanos = 0;
+  std::unique_ptr<uint64_t[]> counters;
+};
+
+PerfSampler::PerfSampler(
+    Env* env, uint32_t interval,
+    const std::vector<std::shared_ptr<EventListener>>& listeners,
+    size_t capacity)
+    : env_(env),
+      interval_(interval),
+      listeners_(listeners),
+      capacity_(std::max<size_t>(capacity, 1)),
+      slots_(new Slot[capacity_]),
+      next_(0) {
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].counters.reset(new uint64_t[PerfContextCounters::kCount]());
+  }
+}
+
+PerfSampler::~PerfSampler() {}
+
+bool PerfSampler::ShouldSample() {
+  uint32_t interval = interval_.load(std::memory_order_relaxed);
+  if (interval == 0) {
+    return false;
+  }
+  // The countdown is stored in the thread local slot itself, so each sampler
+  // (i.e. each DB) keeps its own phase per thread without any allocation
+  uintptr_t countdown = reinterpret_cast<uintptr_t>(countdown_.Get());
+  // Start at a random phase so threads doing the same sequence of operations
+  // don't all sample the same one
+  if (countdown == 0 || countdown > interval) {
+    countdown = Random::GetTLSInstance()->Uniform(interval) + 1;
+  }
+  bool sample = --countdown == 0;
+  if (sample) {
+    countdown = interval;
+  }
+  countdown_.Reset(reinterpret_cast<void*>(countdown));
+  return sample;
+}
+
+void PerfSampler::Record(PerfSampleOperation op, uint64_t start_micros,
+                         uint64_t elapsed_nanos, const PerfContext& delta) {
+  uint64_t thread_id = env_->GetThreadID();
+  uint64_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[ticket % capacity_];
+  uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+  // Another writer lapped the ring and is still on this slot, drop the sample
+  // rather than wait
+  if ((seq & 1) != 0 ||
+      !slot.seq.compare_exchange_strong(seq, seq + 1,
+                                        std::memory_order_acquire)) {
+    return;
+  }
+  slot.operation = op;
+  slot.thread_id = thread_id;
+  slot.start_micros = start_micros;
+  slot.elapsed_nanos = elapsed_nanos;
+  memcpy(slot.counters.get(), PerfContextCounters::Get(delta),
+         PerfContextCounters::kCount * sizeof(uint64_t));
+  slot.seq.store(seq + 2, std::memory_order_release);
+
+#ifndef ROCKSDB_LITE
+  if (!listeners_.empty()) {
+    PerfSampleInfo info;
+    info.operation = op;
+    info.thread_id = thread_id;
+    info.start_micros = start_micros;
+    info.elapsed_nanos = elapsed_nanos;
+    info.perf_context = &delta;
+    for (auto& listener : listeners_) {
+      listener->OnPerfContextSampled(info);
+    }
+  }
+#endif  // ROCKSDB_LITE
+}
+
+void PerfSampler::GetSamples(std::vector<PerfSample>* samples) const {
+  samples->clear();
+  uint64_t end = next_.load(std::memory_order_acquire);
+  uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+  samples->reserve(static_cast<size_t>(end - begin));
+  for (uint64_t i = begin; i < end; ++i) {
+    const Slot& slot = slots_[i % capacity_];
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq == 0 || (seq & 1) != 0) {
+      continue;
+    }
+    samples->emplace_back();
+    PerfSample& sample = samples->back();
+    sample.operation = slot.operation;
+    sample.thread_id = slot.thread_id;
+    sample.start_micros = slot.start_micros;
+    sample.elapsed_nanos = slot.elapsed_nanos;
+    memcpy(PerfContextCounters::Get(&sample.perf_context),
+           slot.counters.get(), PerfContextCounters::kCount * sizeof(uint64_t));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      // Overwritten while copying
+      samples->pop_back();
+    }
+  }
+  std::sort(samples->begin(), samples->end(),
+            [](const PerfSample& a, const PerfSample& b) {
+              return a.start_micros < b.start_micros;
+            });
+}
+
+std::string PerfSampler::ToString(size_t top_n) const {
+  std::vector<PerfSample> samples;
+  GetSamples(&samples);
+
+  const size_t kNumOps =
+      static_cast<size_t>(PerfSampleOperation::kNumOperations);
+  uint64_t count[kNumOps] = {0};
+  uint64_t sum[kNumOps] = {0};
+  uint64_t max[kNumOps] = {0};
+  for (auto& s : samples) {
+    size_t op = static_cast<size_t>(s.operation);
+    ++count[op];
+    sum[op] += s.elapsed_nanos;
+    max[op] = std::max(max[op], s.elapsed_nanos);
+  }
+
+  std::string r;
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "sampling interval: %" PRIu32 " sampled: %" PRIu64
+           " retained: %" ROCKSDB_PRIszt "\n",
+           GetInterval(), NumSampled(), samples.size());
+  r.append(buf);
+  for (size_t op = 0; op < kNumOps; ++op) {
+    if (count[op] == 0) {
+      continue;
+    }
+    snprintf(buf, sizeof(buf),
+             "%-10s COUNT : %" PRIu64 " AVG : %.2f us MAX : %.2f us\n",
+             GetPerfSampleOperationName(static_cast<PerfSampleOperation>(op)),
+             count[op], sum[op] / 1000.0 / count[op], max[op] / 1000.0);
+    r.append(buf);
+  }
+
+  top_n = std::min(top_n, samples.size());
+  std::partial_sort(samples.begin(), samples.begin() + top_n, samples.end(),
+                    [](const PerfSample& a, const PerfSample& b) {
+                      return a.elapsed_nanos > b.elapsed_nanos;
+                    });
+  for (size_t i = 0; i < top_n; ++i) {
+    auto& s = samples[i];
+    snprintf(buf, sizeof(buf),
+             "#%" ROCKSDB_PRIszt " %s thread %" PRIu64 " at %" PRIu64
+             " took %.2f us\n  ",
+             i + 1, GetPerfSampleOperationName(s.operation), s.thread_id,
+             s.start_micros, s.elapsed_nanos / 1000.0);
+    r.append(buf);
+    r.append(s.perf_context.ToString(true));
+    r.push_back('\n');
+  }
+  return r;
+}
+
+void PerfSampleGuard::Start(PerfSampler* sampler, PerfSampleOperation op) {
+  sampler_ = sampler;
+  op_ = op;
+  saved_level_ = perf_level;
+  if (perf_level < PerfLevel::kEnableTimeExceptForMutex) {
+    perf_level = PerfLevel::kEnableTimeExceptForMutex;
+  }
+  start_counters_.reset(new uint64_t[PerfContextCounters::kCount]);
+  memcpy(start_counters_.get(), PerfContextCounters::Get(*get_perf_context()),
+         PerfContextCounters::kCount * sizeof(uint64_t));
+  Env* env = sampler_->env();
+  start_micros_ = env->NowMicros();
+  start_nanos_ = env->NowNanos();
+}
+
+void PerfSampleGuard::Finish() {
+  uint64_t elapsed_nanos = sampler_->env()->NowNanos() - start_nanos_;
+  perf_level = saved_level_;
+  PerfContext delta;
+  uint64_t* d = PerfContextCounters::Get(&delta);
+  const uint64_t* now = PerfContextCounters::Get(*get_perf_context());
+  for (size_t i = 0; i < PerfContextCounters::kCount; ++i) {
+    // The user may Reset() the context in the middle of an operation
+    d[i] = now[i] >= start_counters_[i] ? now[i] - start_counters_[i] : now[i];
+  }
+  sampler_->Record(op_, start_micros_, elapsed_nanos, delta);
+}
+
+}  // namespace TERARKDB_NAMESPACE
@@ -0,0 +1,135 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/env.h"
+#include "rocksdb/listener.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/thread_local.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// All plain uint64_t counters of PerfContext, from user_key_comparison_count
+// to env_new_logger_nanos, are laid out contiguously. The sampler treats them
+// as an array so a sample is a handful of memcpy and subtractions.
+struct PerfContextCounters {
+  static const size_t kOffset;
+  static const size_t kCount;
+
+  static const uint64_t* Get(const PerfContext& ctx) {
+    return reinterpret_cast<const uint64_t*>(
+        reinterpret_cast<const char*>(&ctx) + kOffset);
+  }
+  static uint64_t* Get(PerfContext* ctx) {
+    return reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(ctx) + kOffset);
+  }
+};
+
+struct PerfSample {
+  PerfSampleOperation operation;
+  uint64_t thread_id;
+  uint64_t start_micros;
+  uint64_t elapsed_nanos;
+  // counters of this operation only, level_to_perf_context is always nullptr
+  PerfContext perf_context;
+};
+
+// Picks one in every `interval` operations of each thread, and keeps the
+// PerfContext delta of the picked operations in a fixed-size ring buffer.
+// Writers claim a slot with a single fetch_add and publish it through a
+// per-slot sequence number, so recording never blocks and readers skip the
+// slots that are being overwritten.
+class PerfSampler {
+ public:
+  enum { kDefaultCapacity = 1024 };
+
+  PerfSampler(Env* env, uint32_t interval,
+              const std::vector<std::shared_ptr<EventListener>>& listeners,
+              size_t capacity = kDefaultCapacity);
+  ~PerfSampler();
+
+  PerfSampler(const PerfSampler&) = delete;
+  PerfSampler& operator=(const PerfSampler&) = delete;
+
+  void SetInterval(uint32_t interval) {
+    interval_.store(interval, std::memory_order_relaxed);
+  }
+  uint32_t GetInterval() const {
+    return interval_.load(std::memory_order_relaxed);
+  }
+
+  // Called once per operation, returns true if the operation is sampled
+  bool ShouldSample();
+
+  Env* env() const { return env_; }
+
+  void Record(PerfSampleOperation op, uint64_t start_micros,
+              uint64_t elapsed_nanos, const PerfContext& delta);
+
+  // Returns the samples currently in the ring buffer, oldest first
+  void GetSamples(std::vector<PerfSample>* samples) const;
+
+  // Per operation count/average/max, followed by the `top_n` slowest samples
+  // with their non-zero perf counters
+  std::string ToString(size_t top_n) const;
+
+  uint64_t NumSampled() const { return next_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Slot;
+
+  Env* env_;
+  std::atomic<uint32_t> interval_;
+  const std::vector<std::shared_ptr<EventListener>> listeners_;
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_;
+  // Operations left before the next sample, per thread
+  ThreadLocalPtr countdown_;
+};
+
+// Scoped sampling of one operation. If the operation is picked, the
+// thread's perf level is raised to kEnableTimeExceptForMutex for the
+// duration of the scope and the PerfContext delta is recorded when the
+// scope ends. The thread's own PerfContext keeps accumulating as usual.
+class PerfSampleGuard {
+ public:
+  PerfSampleGuard(PerfSampler* sampler, PerfSampleOperation op)
+      : sampler_(nullptr) {
+    if (sampler != nullptr && sampler->ShouldSample()) {
+      Start(sampler, op);
+    }
+  }
+
+  ~PerfSampleGuard() {
+    if (sampler_ != nullptr) {
+      Finish();
+    }
+  }
+
+  PerfSampleGuard(const PerfSampleGuard&) = delete;
+  PerfSampleGuard& operator=(const PerfSampleGuard&) = delete;
+
+ private:
+  void Start(PerfSampler* sampler, PerfSampleOperation op);
+  void Finish();
+
+  PerfSampler* sampler_;
+  PerfSampleOperation op_;
+  PerfLevel saved_level_;
+  uint64_t start_micros_;
+  uint64_t start_nanos_;
+  std::unique_ptr<uint64_t[]> start_counters_;
+};
+
+}  // namespace TERARKDB_NAMESPACE
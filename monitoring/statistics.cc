@@ -139,6 +139,8 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {GC_TOUCH_FILES, "rocksdb.num.gc.touch_files"},
     {GC_SKIP_GET_BY_SEQ, "rocksdb.num.gc.skip_by_seqno"},
     {GC_SKIP_GET_BY_FILE, "rocksdb.num.gc.skip_by_file_meta"},
+    {GET_SKIP_FILE_BY_RANGE_DEL, "rocksdb.get.skip.file.by.range.del"},
+    {READ_SKIP_FILE_BY_TTL_TIME, "rocksdb.read.skip.file.by.ttl.time"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
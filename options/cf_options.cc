@@ -78,6 +78,8 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
           db_options.new_table_reader_for_compaction_inputs),
       num_levels(cf_options.num_levels),
       force_consistency_checks(cf_options.force_consistency_checks),
+      use_loser_tree_merging_iterator(
+          cf_options.use_loser_tree_merging_iterator),
       allow_ingest_behind(db_options.allow_ingest_behind),
       preserve_deletes(db_options.preserve_deletes),
       listeners(db_options.listeners),
@@ -232,6 +234,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  ttl_gc_ratio);
   ROCKS_LOG_INFO(log, "                         ttl_max_scan_gap: %zd",
                  ttl_max_scan_gap);
+  ROCKS_LOG_INFO(log, "                   ttl_drop_expired_files: %d",
+                 ttl_drop_expired_files);
   std::string result;
   char buf[10];
   for (const auto m : max_bytes_for_level_multiplier_additional) {
@@ -323,7 +327,8 @@ MutableCFOptions::MutableCFOptions(const ColumnFamilyOptions& options, Env* env)
       optimize_range_deletion(options.optimize_range_deletion),
       compression(options.compression),
       ttl_gc_ratio(options.ttl_gc_ratio),
-      ttl_max_scan_gap(options.ttl_max_scan_gap) {
+      ttl_max_scan_gap(options.ttl_max_scan_gap),
+      ttl_drop_expired_files(options.ttl_drop_expired_files) {
   RefreshDerivedOptions(options.num_levels);
 
   int_tbl_prop_collector_factories = std::make_shared<
@@ -119,6 +119,8 @@ struct ImmutableCFOptions {
 
   bool force_consistency_checks;
 
+  bool use_loser_tree_merging_iterator;
+
   bool allow_ingest_behind;
 
   bool preserve_deletes;
@@ -180,7 +182,8 @@ struct MutableCFOptions {
         optimize_range_deletion(false),
         compression(Snappy_Supported() ? kSnappyCompression : kNoCompression),
         ttl_gc_ratio(1.000),
-        ttl_max_scan_gap(0) {}
+        ttl_max_scan_gap(0),
+        ttl_drop_expired_files(false) {}
 
   explicit MutableCFOptions(const Options& options);
 
@@ -252,6 +255,7 @@ struct MutableCFOptions {
 
   double ttl_gc_ratio;
   size_t ttl_max_scan_gap;
+  bool ttl_drop_expired_files;
 
   std::shared_ptr<std::vector<std::unique_ptr<IntTblPropCollectorFactory>>>
       int_tbl_prop_collector_factories;
@@ -41,6 +41,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       db_log_dir(options.db_log_dir),
       wal_dir(options.wal_dir),
       max_background_flushes(options.max_background_flushes),
+      adaptive_background_scheduling(options.adaptive_background_scheduling),
+      adaptive_write_throttling(options.adaptive_write_throttling),
       max_log_file_size(options.max_log_file_size),
       log_file_time_to_roll(options.log_file_time_to_roll),
       keep_log_file_num(options.keep_log_file_num),
@@ -159,6 +161,10 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    table_cache_numshardbits);
   ROCKS_LOG_HEADER(log, "                 Options.max_background_flushes: %d",
                    max_background_flushes);
+  ROCKS_LOG_HEADER(log, "         Options.adaptive_background_scheduling: %d",
+                   adaptive_background_scheduling);
+  ROCKS_LOG_HEADER(log, "              Options.adaptive_write_throttling: %d",
+                   adaptive_write_throttling);
   ROCKS_LOG_HEADER(log,
                    "                        Options.WAL_ttl_seconds: %" PRIu64,
                    wal_ttl_seconds);
@@ -266,6 +272,7 @@ MutableDBOptions::MutableDBOptions()
       stats_dump_period_sec(600),
       stats_persist_period_sec(600),
       stats_history_buffer_size(1024 * 1024),
+      perf_sampling_interval(0),
       max_open_files(-1),
       bytes_per_sync(0),
       wal_bytes_per_sync(0),
@@ -287,6 +294,7 @@ MutableDBOptions::MutableDBOptions(const DBOptions& options)
       stats_dump_period_sec(options.stats_dump_period_sec),
       stats_persist_period_sec(options.stats_persist_period_sec),
       stats_history_buffer_size(options.stats_history_buffer_size),
+      perf_sampling_interval(options.perf_sampling_interval),
       max_open_files(options.max_open_files),
       bytes_per_sync(options.bytes_per_sync),
       wal_bytes_per_sync(options.wal_bytes_per_sync),
@@ -322,6 +330,8 @@ void MutableDBOptions::Dump(Logger* log) const {
                    stats_persist_period_sec);
   ROCKS_LOG_HEADER(log, "              Options.stats_history_buffer_size: %zu",
                    stats_history_buffer_size);
+  ROCKS_LOG_HEADER(log, "                 Options.perf_sampling_interval: %u",
+                   perf_sampling_interval);
   ROCKS_LOG_HEADER(log, "                         Options.max_open_files: %d",
                    max_open_files);
   ROCKS_LOG_HEADER(log,
@@ -37,6 +37,8 @@ struct ImmutableDBOptions {
   std::string wal_dir;
   uint32_t max_subcompactions;
   int max_background_flushes;
+  bool adaptive_background_scheduling;
+  bool adaptive_write_throttling;
   size_t max_log_file_size;
   size_t log_file_time_to_roll;
   size_t keep_log_file_num;
@@ -110,6 +112,7 @@ struct MutableDBOptions {
   unsigned int stats_dump_period_sec;
   unsigned int stats_persist_period_sec;
   size_t stats_history_buffer_size;
+  uint32_t perf_sampling_interval;
   int max_open_files;
   uint64_t bytes_per_sync;
   uint64_t wal_bytes_per_sync;
@@ -102,6 +102,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       optimize_range_deletion(options.optimize_range_deletion),
       paranoid_file_checks(options.paranoid_file_checks),
       force_consistency_checks(options.force_consistency_checks),
+      use_loser_tree_merging_iterator(options.use_loser_tree_merging_iterator),
       report_bg_io_stats(options.report_bg_io_stats) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
@@ -283,6 +284,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    ttl_gc_ratio);
   ROCKS_LOG_HEADER(log, "                       Options.ttl_max_scan_gap: %zd",
                    ttl_max_scan_gap);
+  ROCKS_LOG_HEADER(log, "                 Options.ttl_drop_expired_files: %d",
+                   ttl_drop_expired_files);
 
   const auto& it_compaction_style =
       compaction_style_to_string.find(compaction_style);
@@ -370,6 +373,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    paranoid_file_checks);
   ROCKS_LOG_HEADER(log, "               Options.force_consistency_checks: %d",
                    force_consistency_checks);
+  ROCKS_LOG_HEADER(log, "        Options.use_loser_tree_merging_iterator: %d",
+                   use_loser_tree_merging_iterator);
   ROCKS_LOG_HEADER(log, "                     Options.report_bg_io_stats: %d",
                    report_bg_io_stats);
 }  // ColumnFamilyOptions::Dump
@@ -584,6 +589,9 @@ ReadOptions::ReadOptions()
       background_purge_on_iterator_cleanup(false),
       ignore_range_deletions(false),
       aio_concurrency(32),
+      ttl_time_lower_bound(0),
+      ttl_time_upper_bound(std::numeric_limits<uint64_t>::max()),
+      column_mask(std::numeric_limits<uint64_t>::max()),
       iter_start_seqnum(0) {}
 
 ReadOptions::ReadOptions(bool cksum, bool cache)
@@ -602,6 +610,9 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       background_purge_on_iterator_cleanup(false),
       ignore_range_deletions(false),
       aio_concurrency(32),
+      ttl_time_lower_bound(0),
+      ttl_time_upper_bound(std::numeric_limits<uint64_t>::max()),
+      column_mask(std::numeric_limits<uint64_t>::max()),
       iter_start_seqnum(0) {}
 
 }  // namespace TERARKDB_NAMESPACE
@@ -65,6 +65,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.bytes_per_sync = mutable_db_options.bytes_per_sync;
   options.wal_bytes_per_sync = mutable_db_options.wal_bytes_per_sync;
   options.max_background_flushes = immutable_db_options.max_background_flushes;
+  options.adaptive_background_scheduling =
+      immutable_db_options.adaptive_background_scheduling;
+  options.adaptive_write_throttling =
+      immutable_db_options.adaptive_write_throttling;
   options.max_log_file_size = immutable_db_options.max_log_file_size;
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
@@ -93,6 +97,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.persist_stats_to_disk = immutable_db_options.persist_stats_to_disk;
   options.stats_history_buffer_size =
       mutable_db_options.stats_history_buffer_size;
+  options.perf_sampling_interval = mutable_db_options.perf_sampling_interval;
   options.advise_random_on_open = immutable_db_options.advise_random_on_open;
   options.allow_mmap_populate = immutable_db_options.allow_mmap_populate;
   options.write_buffer_flush_pri = immutable_db_options.write_buffer_flush_pri;
@@ -198,6 +203,7 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.max_bytes_for_level_multiplier;
   cf_opts.ttl_gc_ratio = mutable_cf_options.ttl_gc_ratio;
   cf_opts.ttl_max_scan_gap = mutable_cf_options.ttl_max_scan_gap;
+  cf_opts.ttl_drop_expired_files = mutable_cf_options.ttl_drop_expired_files;
 
   cf_opts.max_bytes_for_level_multiplier_additional =
       mutable_cf_options.max_bytes_for_level_multiplier_additional;
@@ -1619,6 +1625,12 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_background_flushes",
          {offsetof(struct DBOptions, max_background_flushes), OptionType::kInt,
           OptionVerificationType::kNormal, false, 0}},
+        {"adaptive_background_scheduling",
+         {offsetof(struct DBOptions, adaptive_background_scheduling),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"adaptive_write_throttling",
+         {offsetof(struct DBOptions, adaptive_write_throttling),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"max_file_opening_threads",
          {offsetof(struct DBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
@@ -1712,6 +1724,10 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct DBOptions, stats_history_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal, true,
           offsetof(struct MutableDBOptions, stats_history_buffer_size)}},
+        {"perf_sampling_interval",
+         {offsetof(struct DBOptions, perf_sampling_interval),
+          OptionType::kUInt32T, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableDBOptions, perf_sampling_interval)}},
         {"fail_if_options_file_error",
          {offsetof(struct DBOptions, fail_if_options_file_error),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -1790,7 +1806,9 @@ std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kBinarySearch", BlockBasedTableOptions::IndexType::kBinarySearch},
         {"kHashSearch", BlockBasedTableOptions::IndexType::kHashSearch},
         {"kTwoLevelIndexSearch",
-         BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch}};
+         BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
+        {"kCompactIndexSearch",
+         BlockBasedTableOptions::IndexType::kCompactIndexSearch}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::DataBlockIndexType>
     OptionsHelper::block_base_table_data_block_index_type_string_map = {
@@ -1971,6 +1989,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"force_consistency_checks",
          {offset_of(&ColumnFamilyOptions::force_consistency_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"use_loser_tree_merging_iterator",
+         {offset_of(&ColumnFamilyOptions::use_loser_tree_merging_iterator),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"purge_redundant_kvs_while_flush",
          {offset_of(&ColumnFamilyOptions::purge_redundant_kvs_while_flush),
           OptionType::kBoolean, OptionVerificationType::kDeprecated, false, 0}},
@@ -2166,7 +2187,11 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"ttl_max_scan_gap",
          {offset_of(&ColumnFamilyOptions::ttl_max_scan_gap), OptionType::kSizeT,
           OptionVerificationType::kNormal, true,
-          offsetof(struct MutableCFOptions, ttl_max_scan_gap)}}};
+          offsetof(struct MutableCFOptions, ttl_max_scan_gap)}},
+        {"ttl_drop_expired_files",
+         {offset_of(&ColumnFamilyOptions::ttl_drop_expired_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions, ttl_drop_expired_files)}}};
 
 std::unordered_map<std::string, OptionTypeInfo>
     OptionsHelper::universal_compaction_options_type_info = {
@@ -146,6 +146,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "data_block_hash_table_util_ratio=0.75;"
       "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
+      "persistent_cache_admit_evicted=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
       "metadata_block_size=1024;"
@@ -268,15 +269,18 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "create_missing_column_families=true;"
                              "log_file_time_to_roll=3097;"
                              "max_background_flushes=35;"
+                             "adaptive_background_scheduling=true;"
                              "create_if_missing=false;"
                              "error_if_exists=true;"
                              "delayed_write_rate=4294976214;"
+                             "adaptive_write_throttling=true;"
                              "manifest_preallocation_size=1222;"
                              "allow_mmap_writes=false;"
                              "stats_dump_period_sec=70127;"
                              "stats_persist_period_sec=54321;"
                              "persist_stats_to_disk=true;"
                              "stats_history_buffer_size=14159;"
+                             "perf_sampling_interval=1000;"
                              "allow_fallocate=true;"
                              "allow_mmap_reads=false;"
                              "use_direct_reads=false;"
@@ -457,6 +461,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "memtable_insert_with_hint_prefix_extractor=rocksdb.CappedPrefix.13;"
       "paranoid_file_checks=true;"
       "force_consistency_checks=true;"
+      "use_loser_tree_merging_iterator=true;"
       "inplace_update_num_locks=7429;"
       "level_compaction_dynamic_level_bytes=false;"
       "enable_lazy_compaction=true;"
@@ -478,7 +483,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "optimize_range_deletion=false;"
       "report_bg_io_stats=true;"
       "ttl_gc_ratio=3.000;"
-      "ttl_max_scan_gap=1;",
+      "ttl_max_scan_gap=1;"
+      "ttl_drop_expired_files=true;",
       new_options));
 
   ASSERT_EQ(unset_bytes_base,
@@ -486,6 +492,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
                           kColumnFamilyOptionsBlacklist));
   EXPECT_EQ(new_options->ttl_gc_ratio, 3.000);
   EXPECT_EQ(new_options->ttl_max_scan_gap, 1);
+  EXPECT_TRUE(new_options->ttl_drop_expired_files);
   options->~ColumnFamilyOptions();
   new_options->~ColumnFamilyOptions();
 
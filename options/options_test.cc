@@ -136,6 +136,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"stats_persist_period_sec", "57"},
       {"persist_stats_to_disk", "false"},
       {"stats_history_buffer_size", "69"},
+      {"perf_sampling_interval", "1000"},
       {"advise_random_on_open", "true"},
       {"allow_mmap_populate", "true"},
       {"use_adaptive_mutex", "false"},
@@ -275,6 +276,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_db_opt.stats_persist_period_sec, 57U);
   ASSERT_EQ(new_db_opt.persist_stats_to_disk, false);
   ASSERT_EQ(new_db_opt.stats_history_buffer_size, 69U);
+  ASSERT_EQ(new_db_opt.perf_sampling_interval, 1000U);
   ASSERT_EQ(new_db_opt.advise_random_on_open, true);
   ASSERT_EQ(new_db_opt.allow_mmap_populate, true);
   ASSERT_EQ(new_db_opt.use_adaptive_mutex, false);
@@ -4,6 +4,7 @@ LIB_SOURCES =                                                   \
   cache/lirs_cache.cc                                           \
   cache/lru_cache.cc                                            \
   cache/sharded_cache.cc                                        \
+  db/background_scheduler.cc                                    \
   db/builder.cc                                                 \
   db/c.cc                                                       \
   db/column_family.cc                                           \
@@ -53,6 +54,7 @@ LIB_SOURCES =                                                   \
   db/snapshot_impl.cc                                           \
   db/table_cache.cc                                             \
   db/table_properties_collector.cc                              \
+  db/tailing_notifier.cc                                        \
   db/transaction_log_impl.cc                                    \
   db/version_builder.cc                                         \
   db/version_edit.cc                                            \
@@ -80,6 +82,7 @@ LIB_SOURCES =                                                   \
   memtable/terark_zip_memtable.cc                               \
   memtable/vectorrep.cc                                         \
   memtable/write_buffer_manager.cc                              \
+  monitoring/hdr_histogram.cc                                   \
   monitoring/histogram.cc                                       \
   monitoring/histogram_windowing.cc                             \
   monitoring/in_memory_stats_history.cc                         \
@@ -87,6 +90,7 @@ LIB_SOURCES =                                                   \
   monitoring/iostats_context.cc                                 \
   monitoring/perf_context.cc                                    \
   monitoring/perf_level.cc                                      \
+  monitoring/perf_sampler.cc                                    \
   monitoring/persistent_stats_history.cc                        \
   monitoring/statistics.cc                                      \
   monitoring/thread_status_impl.cc                              \
@@ -116,6 +120,10 @@ LIB_SOURCES =                                                   \
   table/block_fetcher.cc                                        \
   table/block_prefix_index.cc                                   \
   table/bloom_block.cc                                          \
+  table/columnar_table_builder.cc                               \
+  table/columnar_table_factory.cc                               \
+  table/columnar_table_reader.cc                                \
+  table/compact_index_block.cc                                  \
   table/cuckoo_table_builder.cc                                 \
   table/cuckoo_table_factory.cc                                 \
   table/cuckoo_table_reader.cc                                  \
@@ -226,6 +234,7 @@ LIB_SOURCES =                                                   \
   utilities/spatialdb/spatial_db.cc                             \
   utilities/table_properties_collectors/compact_on_deletion_collector.cc \
   utilities/trace/bytedance_metrics_reporter.cc                 \
+  utilities/trace/hdr_metrics_reporter.cc                       \
   utilities/trace/file_trace_reader_writer.cc                   \
   utilities/transactions/optimistic_transaction.cc              \
   utilities/transactions/optimistic_transaction_db_impl.cc      \
@@ -286,14 +295,17 @@ TEST_LIB_SOURCES = \
 MAIN_SOURCES =                                                          \
   cache/cache_bench.cc                                                  \
   cache/cache_test.cc                                                   \
+  db/background_scheduler_test.cc                                       \
   db/column_family_test.cc                                              \
   db/compact_files_test.cc                                              \
+  db/compaction_iterator_bench.cc                                       \
   db/compaction_iterator_test.cc                                        \
   db/compaction_job_stats_test.cc                                       \
   db/compaction_job_test.cc                                             \
   db/compaction_picker_test.cc                                          \
   db/comparator_db_test.cc                                              \
   db/corruption_test.cc                                                 \
+  db/columnar_table_db_test.cc                                          \
   db/cuckoo_table_db_test.cc                                            \
   db/db_basic_test.cc                                                   \
   db/db_block_cache_test.cc                                             \
@@ -376,6 +388,7 @@ MAIN_SOURCES =                                                          \
   memtable/terark_zip_entry_index.cc                                    \
   memtable/terark_zip_memtable.cc                                       \
   memtable/write_buffer_manager_test.cc                                 \
+  monitoring/histogram_bench.cc                                         \
   monitoring/histogram_test.cc                                          \
   monitoring/iostats_context_test.cc                                    \
   monitoring/statistics_test.cc                                         \
@@ -389,6 +402,7 @@ MAIN_SOURCES =                                                          \
   table/data_block_hash_index_test.cc                                   \
   table/full_filter_block_test.cc                                       \
   table/merger_test.cc                                                  \
+  table/merging_iterator_bench.cc                                       \
   table/sst_file_reader_test.cc                                         \
   table/table_reader_bench.cc                                           \
   table/table_test.cc                                                   \
@@ -414,6 +428,7 @@ MAIN_SOURCES =                                                          \
   util/event_logger_test.cc                                             \
   util/filelock_test.cc                                                 \
   util/log_write_bench.cc                                               \
+  util/loser_tree_test.cc                                               \
   util/rate_limiter_test.cc                                             \
   util/repeatable_thread_test.cc                                        \
   util/slice_transform_test.cc                                          \
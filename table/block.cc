@@ -210,8 +210,14 @@ void DataBlockIter::Seek(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  bool ok;
+  if (Valid() && Compare(key_, seek_key) < 0) {
+    // Moving forward, most likely by a short distance
+    ok = GallopSeek<DecodeKey>(seek_key, &index, comparator_);
+  } else {
+    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
+                               comparator_);
+  }
 
   if (!ok) {
     return;
@@ -356,6 +362,11 @@ void IndexBlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (Valid() && Compare(key_, seek_key) < 0) {
+    // Moving forward, most likely by a short distance
+    ok = value_delta_encoded_
+             ? GallopSeek<DecodeKeyV4>(seek_key, &index, comparator_)
+             : GallopSeek<DecodeKey>(seek_key, &index, comparator_);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index,
                                  comparator_);
@@ -645,6 +656,39 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t left,
   return true;
 }
 
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::GallopSeek(const Slice& target, uint32_t* index,
+                                   const Comparator* comp) {
+  assert(Valid());
+  // The key of the restart point of the current entry is before target
+  uint32_t left = restart_index_;
+  uint32_t right = num_restarts_ - 1;
+  uint32_t step = 1;
+  while (left + step <= right) {
+    uint32_t probe = left + step;
+    uint32_t shared, non_shared;
+    const char* key_ptr =
+        DecodeKeyFunc()(data_ + GetRestartPoint(probe), data_ + restarts_,
+                        &shared, &non_shared);
+    if (key_ptr == nullptr || (shared != 0)) {
+      CorruptionError();
+      return false;
+    }
+    int cmp = comp->Compare(Slice(key_ptr, non_shared), target);
+    if (cmp == 0) {
+      *index = probe;
+      return true;
+    } else if (cmp > 0) {
+      right = probe - 1;
+      break;
+    }
+    left = probe;
+    step *= 2;
+  }
+  return BinarySeek<DecodeKeyFunc>(target, left, right, index, comp);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -366,6 +366,15 @@ class BlockIter : public InternalIteratorBase<TValue> {
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                          uint32_t* index, const Comparator* comp);
+
+  // Same result as BinarySeek() over all restart points, for a target after
+  // the current entry. Probes restart points at exponentially growing
+  // distances from the current one first, so a seek that moves forward by a
+  // few entries takes a few comparisons instead of log(num_restarts_).
+  // REQUIRES: Valid() and the current key is before target
+  template <typename DecodeKeyFunc>
+  inline bool GallopSeek(const Slice& target, uint32_t* index,
+                         const Comparator* comp);
 };
 
 class DataBlockIter final : public BlockIter<Slice> {
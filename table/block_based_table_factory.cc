@@ -191,6 +191,30 @@ BlockBasedTableFactory::BlockBasedTableFactory(
     // We do not support partitioned filters without partitioning indexes
     table_options_.partition_filters = false;
   }
+  if (table_options_.persistent_cache_admit_evicted) {
+    // Factories sharing block_cache and persistent_cache share one callback,
+    // it is unregistered when the last of them is destroyed
+    if (table_options_.block_cache == nullptr ||
+        table_options_.persistent_cache == nullptr ||
+        table_options_.persistent_cache->IsCompressed() ||
+        !table_options_.block_cache
+             ->AddEvictionCallback(
+                 table_options_.persistent_cache.get(),
+                 BlockBasedTable::NewEvictedBlockAdmitter(
+                     table_options_.persistent_cache, kMaxPendingAdmitBytes))
+             .ok()) {
+      table_options_.persistent_cache_admit_evicted = false;
+    } else {
+      admit_evicted_block_cache_ = table_options_.block_cache;
+      admit_evicted_tag_ = table_options_.persistent_cache.get();
+    }
+  }
+}
+
+BlockBasedTableFactory::~BlockBasedTableFactory() {
+  if (admit_evicted_block_cache_ != nullptr) {
+    admit_evicted_block_cache_->RemoveEvictionCallback(admit_evicted_tag_);
+  }
 }
 
 Status BlockBasedTableFactory::NewTableReader(
@@ -332,6 +356,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
     ret.append(buffer);
     ret.append(table_options_.persistent_cache->GetPrintableOptions());
   }
+  snprintf(buffer, kBufferSize, "  persistent_cache_admit_evicted: %d\n",
+           table_options_.persistent_cache_admit_evicted);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size: %" ROCKSDB_PRIszt "\n",
            table_options_.block_size);
   ret.append(buffer);
@@ -48,7 +48,7 @@ class BlockBasedTableFactory : public TableFactory {
   explicit BlockBasedTableFactory(
       const BlockBasedTableOptions& table_options = BlockBasedTableOptions());
 
-  ~BlockBasedTableFactory() {}
+  ~BlockBasedTableFactory();
 
   const char* Name() const override { return kName.c_str(); }
 
@@ -79,9 +79,16 @@ class BlockBasedTableFactory : public TableFactory {
 
   static const std::string kName;
 
+  // Evicted blocks queued for persistent_cache beyond this are dropped
+  static const size_t kMaxPendingAdmitBytes = 16 << 20;
+
  private:
   BlockBasedTableOptions table_options_;
   mutable TailPrefetchStats tail_prefetch_stats_;
+  // The block cache this factory registered its eviction callback with,
+  // kept apart since table_options_ may be changed through GetOptions()
+  std::shared_ptr<Cache> admit_evicted_block_cache_;
+  const void* admit_evicted_tag_ = nullptr;
 };
 
 extern const std::string kHashIndexPrefixesBlock;
@@ -139,6 +146,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"no_block_cache",
          {offsetof(struct BlockBasedTableOptions, no_block_cache),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"persistent_cache_admit_evicted",
+         {offsetof(struct BlockBasedTableOptions,
+                   persistent_cache_admit_evicted),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"block_size",
          {offsetof(struct BlockBasedTableOptions, block_size),
           OptionType::kSizeT, OptionVerificationType::kNormal, false, 0}},
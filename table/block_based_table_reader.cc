@@ -32,6 +32,7 @@
 #include "table/block_based_table_factory.h"
 #include "table/block_fetcher.h"
 #include "table/block_prefix_index.h"
+#include "table/compact_index_block.h"
 #include "table/filter_block.h"
 #include "table/format.h"
 #include "table/full_filter_block.h"
@@ -463,6 +464,68 @@ class BinarySearchIndexReader : public IndexReader {
   const bool index_value_is_full_;
 };
 
+// Index over a CompactIndexBlock, see BlockBasedTableOptions::
+// kCompactIndexSearch. The block is read once and kept uncompressed.
+class CompactIndexReader : public IndexReader {
+ public:
+  static Status Create(RandomAccessFileReader* file,
+                       FilePrefetchBuffer* prefetch_buffer,
+                       const Footer& footer, const BlockHandle& index_handle,
+                       const ImmutableCFOptions& ioptions,
+                       const InternalKeyComparator* icomparator,
+                       IndexReader** index_reader,
+                       const PersistentCacheOptions& cache_options) {
+    BlockContents contents;
+    auto s = ReadBlockContents(file, prefetch_buffer, footer, ReadOptions(),
+                               index_handle, &contents, ioptions,
+                               true /* decompress */,
+                               Slice() /*compression dict*/, cache_options);
+    if (!s.ok()) {
+      return s;
+    }
+    CompactIndexBlock* index_block = nullptr;
+    s = CompactIndexBlock::Create(contents.data, &index_block);
+    if (s.ok()) {
+      *index_reader = new CompactIndexReader(icomparator, std::move(contents),
+                                             index_block, ioptions.statistics);
+    }
+    return s;
+  }
+
+  virtual InternalIteratorBase<BlockHandle>* NewIterator(
+      IndexBlockIter* /*iter*/ = nullptr, bool /*dont_care*/ = true,
+      bool /*dont_care*/ = true) override {
+    return index_block_->NewIterator(icomparator_);
+  }
+
+  virtual size_t size() const override { return contents_.data.size(); }
+  virtual size_t usable_size() const override {
+    return contents_.usable_size();
+  }
+
+  virtual size_t ApproximateMemoryUsage() const override {
+    size_t usage = contents_.usable_size() +
+                   index_block_->ApproximateMemoryUsage();
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage += malloc_usable_size((void*)this);
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    return usage;
+  }
+
+ private:
+  CompactIndexReader(const InternalKeyComparator* icomparator,
+                     BlockContents&& contents, CompactIndexBlock* index_block,
+                     Statistics* stats)
+      : IndexReader(icomparator, stats),
+        contents_(std::move(contents)),
+        index_block_(index_block) {}
+
+  BlockContents contents_;
+  std::unique_ptr<CompactIndexBlock> index_block_;
+};
+
 // Index that leverages an internal hash table to quicken the lookup for a given
 // key.
 class HashIndexReader : public IndexReader {
@@ -617,9 +680,17 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep, uint64_t file_size) {
         file_size + rep->table_options.block_cache->NewId();
   }
   if (rep->table_options.persistent_cache != nullptr) {
-    GenerateCachePrefix(/*cache=*/nullptr, rep->file->file(),
-                        &rep->persistent_cache_key_prefix[0],
-                        &rep->persistent_cache_key_prefix_size);
+    if (rep->table_options.persistent_cache_admit_evicted &&
+        rep->cache_key_prefix_size != 0) {
+      // Blocks are admitted under their block cache key
+      memcpy(rep->persistent_cache_key_prefix, rep->cache_key_prefix,
+             rep->cache_key_prefix_size);
+      rep->persistent_cache_key_prefix_size = rep->cache_key_prefix_size;
+    } else {
+      GenerateCachePrefix(/*cache=*/nullptr, rep->file->file(),
+                          &rep->persistent_cache_key_prefix[0],
+                          &rep->persistent_cache_key_prefix_size);
+    }
   }
   if (rep->table_options.block_cache_compressed != nullptr) {
     GenerateCachePrefix(rep->table_options.block_cache_compressed.get(),
@@ -753,6 +824,27 @@ Slice BlockBasedTable::GetCacheKey(const char* cache_key_prefix,
   return Slice(cache_key, static_cast<size_t>(end - cache_key));
 }
 
+Cache::EvictionCallback BlockBasedTable::NewEvictedBlockAdmitter(
+    std::shared_ptr<PersistentCache> persistent_cache,
+    size_t max_pending_bytes) {
+  assert(persistent_cache != nullptr && !persistent_cache->IsCompressed());
+  // Owned by the callback, so it lives as long as the cache may call it
+  auto queue = std::make_shared<PersistentCacheAdmissionQueue>(
+      std::move(persistent_cache), max_pending_bytes);
+  return [queue](const Slice& key, void* value, size_t /*charge*/,
+                 void (*deleter)(const Slice&, void*)) {
+    // Index and filter readers, compressed blocks and entries of other
+    // users of the cache are not blocks
+    if (deleter != &DeleteCachedEntry<Block>) {
+      return;
+    }
+    auto* block = reinterpret_cast<Block*>(value);
+    if (block->size() != 0) {
+      queue->Add(key, Slice(block->data(), block->size()));
+    }
+  };
+}
+
 Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
                              const EnvOptions& env_options,
                              const BlockBasedTableOptions& table_options,
@@ -846,6 +938,8 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
                              std::string(rep->persistent_cache_key_prefix,
                                          rep->persistent_cache_key_prefix_size),
                              rep->ioptions.statistics);
+  rep->persistent_cache_options.insert_on_read =
+      !rep->table_options.persistent_cache_admit_evicted;
 
   // Read meta index
   std::unique_ptr<Block> meta;
@@ -2110,6 +2204,20 @@ void BlockBasedTableIteratorBase<TBlockIter, TValue>::Seek(
 
   SavePrevIndexValue();
 
+  // When moving forward, the first key at or after target is in the current
+  // block if the block has one, which saves the index seek
+  if (block_iter_points_to_real_block_ && block_iter_.Valid() &&
+      (key_includes_seq_
+           ? icomp_.Compare(target, block_iter_.key()) > 0
+           : icomp_.user_comparator()->Compare(ExtractUserKey(target),
+                                               block_iter_.key()) > 0)) {
+    block_iter_.Seek(target);
+    if (block_iter_.Valid() || !block_iter_.status().ok()) {
+      FindKeyForward();
+      return;
+    }
+  }
+
   index_iter_->Seek(target);
 
   if (!index_iter_->Valid()) {
@@ -2823,6 +2931,11 @@ Status BlockBasedTable::CreateIndexReader(
               rep_->table_properties_base.index_value_is_delta_encoded == 0,
           GetMemoryAllocator(rep_->table_options));
     }
+    case BlockBasedTableOptions::kCompactIndexSearch: {
+      return CompactIndexReader::Create(
+          file, prefetch_buffer, footer, footer.index_handle(), rep_->ioptions,
+          icomparator, index_reader, rep_->persistent_cache_options);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + ToString(index_type);
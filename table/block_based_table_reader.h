@@ -214,6 +214,15 @@ class BlockBasedTable : public TableReader {
                            size_t cache_key_prefix_size,
                            const BlockHandle& handle, char* cache_key);
 
+  // Returns a block cache eviction callback which queues the evicted
+  // uncompressed blocks to be written into `persistent_cache` under their
+  // block cache key by a background thread, dropping them while more than
+  // `max_pending_bytes` are queued.
+  // See BlockBasedTableOptions::persistent_cache_admit_evicted
+  static Cache::EvictionCallback NewEvictedBlockAdmitter(
+      std::shared_ptr<PersistentCache> persistent_cache,
+      size_t max_pending_bytes);
+
   // Retrieve all key value pairs from data blocks in the table.
   // The key retrieved are internal keys.
   Status GetKVPairsFromDataBlocks(std::vector<KVPairBlock>* kv_pair_blocks);
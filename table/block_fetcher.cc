@@ -149,7 +149,7 @@ inline void BlockFetcher::PrepareBufferForBlockFromFile() {
 
 inline void BlockFetcher::InsertCompressedBlockToPersistentCacheIfNeeded() {
   if (status_.ok() && read_options_.fill_cache &&
-      cache_options_.persistent_cache &&
+      cache_options_.persistent_cache && cache_options_.insert_on_read &&
       cache_options_.persistent_cache->IsCompressed()) {
     // insert to raw cache
     PersistentCacheHelper::InsertRawPage(cache_options_, handle_, used_buf_,
@@ -159,7 +159,7 @@ inline void BlockFetcher::InsertCompressedBlockToPersistentCacheIfNeeded() {
 
 inline void BlockFetcher::InsertUncompressedBlockToPersistentCacheIfNeeded() {
   if (status_.ok() && !got_from_prefetch_buffer_ && read_options_.fill_cache &&
-      cache_options_.persistent_cache &&
+      cache_options_.persistent_cache && cache_options_.insert_on_read &&
       !cache_options_.persistent_cache->IsCompressed()) {
     // insert to uncompressed cache
     PersistentCacheHelper::InsertUncompressedPage(cache_options_, handle_,
@@ -264,4 +264,18 @@ Status BlockFetcher::ReadBlockContents() {
   return status_;
 }
 
+Status ReadBlockContents(RandomAccessFileReader* file,
+                         FilePrefetchBuffer* prefetch_buffer,
+                         const Footer& footer, const ReadOptions& options,
+                         const BlockHandle& handle, BlockContents* contents,
+                         const ImmutableCFOptions& ioptions,
+                         bool do_uncompress, const Slice& compression_dict,
+                         const PersistentCacheOptions& cache_options) {
+  BlockFetcher block_fetcher(file, prefetch_buffer, footer, options, handle,
+                             contents, ioptions, do_uncompress,
+                             true /* maybe_compressed */, compression_dict,
+                             cache_options);
+  return block_fetcher.ReadBlockContents();
+}
+
 }  // namespace TERARKDB_NAMESPACE
@@ -231,6 +231,58 @@ TEST_F(BlockTest, ValueDeltaEncodingTest) {
   }
   delete iter;
 }
+// Seek() with increasing targets moves forward from the current entry
+TEST_F(BlockTest, ForwardSeekTest) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  // Even primary keys only, odd ones fall between them
+  int num_records = 10000;
+  GenerateRandomKVs(&keys, &values, 0, num_records * 2, 2);
+
+  BlockBuilder builder(16);
+  for (int i = 0; i < num_records; i++) {
+    builder.Add(keys[i], values[i]);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+
+  std::unique_ptr<InternalIteratorBase<Slice>> iter(
+      reader.NewIterator<DataBlockIter>(BytewiseComparator(),
+                                        BytewiseComparator()));
+  for (int round = 0; round < 3; ++round) {
+    iter->SeekToFirst();
+    int target = 0;
+    while (true) {
+      // Mostly short moves, sometimes far ones
+      target += rnd.OneIn(10) ? rnd.Uniform(2000) : rnd.Uniform(20);
+      if (target >= num_records * 2) {
+        break;
+      }
+      std::string key = GenerateKey(target, 0, 0, nullptr);
+      iter->Seek(key);
+      ASSERT_OK(iter->status());
+      auto it = std::lower_bound(keys.begin(), keys.end(), key);
+      if (it == keys.end()) {
+        ASSERT_FALSE(iter->Valid());
+        break;
+      }
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*it, iter->key().ToString());
+      ASSERT_EQ(values[it - keys.begin()], iter->value().ToString());
+      if (rnd.OneIn(3)) {
+        iter->Next();
+        ++it;
+        ASSERT_EQ(it != keys.end(), iter->Valid());
+        if (it != keys.end()) {
+          ASSERT_EQ(*it, iter->key().ToString());
+        }
+      }
+    }
+  }
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
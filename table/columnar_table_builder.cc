@@ -0,0 +1,286 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#include "table/columnar_table_builder.h"
+
+#include <assert.h>
+
+#include "db/dbformat.h"
+#include "db/table_properties_collector.h"
+#include "db/version_edit.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/block_based_table_builder.h"
+#include "table/columnar_table_factory.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/compression.h"
+#include "util/crc32c.h"
+#include "util/file_reader_writer.h"
+#include "utilities/col_buf_encoder.h"
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+// Compression format version of the column blocks, see
+// GetCompressFormatForVersion()
+const uint32_t kColumnarFormatVersion = 2;
+
+}  // namespace
+
+ColumnarTableBuilder::ColumnarTableBuilder(
+    const TableBuilderOptions& builder_options, uint32_t column_family_id,
+    WritableFileWriter* file, const ColumnarTableOptions& table_options)
+    : ioptions_(builder_options.ioptions),
+      table_options_(table_options),
+      file_(file),
+      value_columns_(table_options.columns.size()) {
+  properties_.format_version = kColumnarFormatVersion;
+  properties_.column_family_id = column_family_id;
+  properties_.column_family_name = builder_options.column_family_name;
+  properties_.prefix_extractor_name = "nullptr";
+  properties_.compression_name =
+      CompressionTypeToString(table_options_.compression);
+  EncodeColumnarColumns(
+      table_options_.columns,
+      &properties_
+           .user_collected_properties[ColumnarTablePropertyNames::kColumns]);
+
+  builder_options.PushIntTblPropCollectors(&table_properties_collectors_,
+                                           column_family_id);
+  ResetBlock();
+}
+
+ColumnarTableBuilder::~ColumnarTableBuilder() {}
+
+void ColumnarTableBuilder::ResetBlock() {
+  block_rows_ = 0;
+  keys_.clear();
+  wholes_.clear();
+  tails_.clear();
+  encoders_.clear();
+  for (auto& column : table_options_.columns) {
+    encoders_.emplace_back(
+        ColBufEncoder::NewColBufEncoder(ToColDeclaration(column)));
+  }
+}
+
+Status ColumnarTableBuilder::Add(const Slice& key,
+                                 const LazyBuffer& lazy_value) {
+  assert(!closed_);
+  if (!status_.ok()) {
+    return status_;
+  }
+  auto s = lazy_value.fetch();
+  if (!s.ok()) {
+    return s;
+  }
+  const Slice& value = lazy_value.slice();
+
+  ParsedInternalKey internal_key;
+  if (!ParseInternalKey(key, &internal_key)) {
+    assert(false);
+    return Status::Corruption("ParseInternalKey fail");
+  }
+  if (internal_key.type == kTypeRangeDeletion) {
+    return Status::NotSupported("Range deletion unsupported");
+  }
+
+  // Split a plain value into its columns
+  bool by_column = internal_key.type == kTypeValue;
+  Slice rest = value;
+  for (size_t i = 0; by_column && i < value_columns_.size(); ++i) {
+    size_t width = ColumnarColumnWidth(table_options_.columns[i], rest);
+    by_column = width > 0;
+    value_columns_[i] = Slice(rest.data(), width);
+    rest.remove_prefix(width);
+  }
+
+  PutVarint32(&keys_, static_cast<uint32_t>(key.size()));
+  keys_.append(key.data(), key.size());
+  if (by_column) {
+    keys_.push_back(static_cast<char>(kColumnarEntryByColumn));
+    for (size_t i = 0; i < value_columns_.size(); ++i) {
+      encoders_[i]->Append(value_columns_[i].data());
+    }
+    PutLengthPrefixedSlice(&tails_, rest);
+  } else {
+    keys_.push_back(static_cast<char>(kColumnarEntryWhole));
+    PutLengthPrefixedSlice(&wholes_, value);
+  }
+  last_key_.assign(key.data(), key.size());
+
+  properties_.num_entries++;
+  properties_.raw_key_size += key.size();
+  properties_.raw_value_size += value.size();
+  if (internal_key.type == kTypeDeletion ||
+      internal_key.type == kTypeSingleDeletion) {
+    properties_.num_deletions++;
+  } else if (internal_key.type == kTypeMerge) {
+    properties_.num_merge_operands++;
+  }
+
+  // notify property collectors
+  NotifyCollectTableCollectorsOnAdd(
+      key, value, offset_, table_properties_collectors_, ioptions_.info_log);
+
+  if (++block_rows_ >= table_options_.block_rows) {
+    status_ = FlushBlock();
+  }
+  return status_;
+}
+
+Status ColumnarTableBuilder::WriteColumn(const Slice& raw,
+                                         CompressionType type,
+                                         BlockHandle* handle) {
+  CompressionContext compression_ctx(type);
+  Slice block = CompressBlock(raw, compression_ctx, &type,
+                              kColumnarFormatVersion, &compressed_output_);
+  handle->set_offset(offset_);
+  handle->set_size(block.size());
+  Status s = file_->Append(block);
+  if (s.ok()) {
+    char trailer[kBlockTrailerSize];
+    trailer[0] = type;
+    auto crc = crc32c::Value(block.data(), block.size());
+    crc = crc32c::Extend(crc, trailer, 1);  // Extend to cover block type
+    EncodeFixed32(trailer + 1, crc32c::Mask(crc));
+    s = file_->Append(Slice(trailer, kBlockTrailerSize));
+  }
+  if (s.ok()) {
+    offset_ += block.size() + kBlockTrailerSize;
+  }
+  compressed_output_.clear();
+  return s;
+}
+
+Status ColumnarTableBuilder::FlushBlock() {
+  if (block_rows_ == 0) {
+    return Status::OK();
+  }
+  uint64_t block_offset = offset_;
+  PutVarint32(&index_, static_cast<uint32_t>(block_rows_));
+  PutLengthPrefixedSlice(&index_, last_key_);
+
+  BlockHandle handle;
+  Status s = WriteColumn(keys_, table_options_.compression, &handle);
+  if (s.ok()) {
+    handle.EncodeTo(&index_);
+    s = WriteColumn(wholes_, table_options_.compression, &handle);
+  }
+  for (size_t i = 0; s.ok() && i < encoders_.size(); ++i) {
+    handle.EncodeTo(&index_);
+    encoders_[i]->Finish();
+    s = WriteColumn(encoders_[i]->GetData(),
+                    table_options_.columns[i].compression, &handle);
+  }
+  if (s.ok()) {
+    handle.EncodeTo(&index_);
+    s = WriteColumn(tails_, table_options_.compression, &handle);
+  }
+  if (s.ok()) {
+    handle.EncodeTo(&index_);
+    properties_.num_data_blocks++;
+    properties_.data_size += offset_ - block_offset;
+  }
+  ResetBlock();
+  return s;
+}
+
+Status ColumnarTableBuilder::Finish(
+    const TablePropertyCache* prop,
+    const std::vector<SequenceNumber>* snapshots,
+    const std::vector<uint64_t>* inheritance_tree) {
+  assert(!closed_);
+  closed_ = true;
+  if (!status_.ok()) {
+    return status_;
+  }
+
+  if (prop != nullptr) {
+    properties_.purpose = prop->purpose;
+    properties_.max_read_amp = prop->max_read_amp;
+    properties_.read_amp = prop->read_amp;
+    properties_.dependence = prop->dependence;
+  }
+  if (snapshots != nullptr) {
+    properties_.snapshots = *snapshots;
+  }
+  if (inheritance_tree != nullptr) {
+    properties_.inheritance_tree = *inheritance_tree;
+  }
+
+  //  Write the following blocks
+  //  1. [meta block: index]
+  //  2. [meta block: properties]
+  //  3. [metaindex block]
+  //  4. [footer]
+  Status s = FlushBlock();
+  if (!s.ok()) {
+    return s;
+  }
+
+  MetaIndexBuilder meta_index_builder;
+  BlockHandle index_block_handle;
+  s = WriteColumn(index_, kNoCompression, &index_block_handle);
+  if (!s.ok()) {
+    return s;
+  }
+  properties_.index_size = index_.size();
+  meta_index_builder.Add(ColumnarTableIndexNames::kIndexBlock,
+                         index_block_handle);
+
+  PropertyBlockBuilder property_block_builder;
+  // -- Add basic properties
+  property_block_builder.AddTableProperty(properties_);
+
+  property_block_builder.Add(properties_.user_collected_properties);
+
+  // -- Add user collected properties
+  NotifyCollectTableCollectorsOnFinish(table_properties_collectors_,
+                                       ioptions_.info_log,
+                                       &property_block_builder);
+
+  // -- Write property block
+  BlockHandle property_block_handle;
+  s = WriteColumn(property_block_builder.Finish(), kNoCompression,
+                  &property_block_handle);
+  if (!s.ok()) {
+    return s;
+  }
+  meta_index_builder.Add(kPropertiesBlock, property_block_handle);
+
+  // -- write metaindex block
+  BlockHandle metaindex_block_handle;
+  s = WriteColumn(meta_index_builder.Finish(), kNoCompression,
+                  &metaindex_block_handle);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Write Footer
+  Footer footer(kColumnarTableMagicNumber, kColumnarFormatVersion);
+  footer.set_metaindex_handle(metaindex_block_handle);
+  footer.set_index_handle(index_block_handle);
+  std::string footer_encoding;
+  footer.EncodeTo(&footer_encoding);
+  s = file_->Append(footer_encoding);
+  if (s.ok()) {
+    offset_ += footer_encoding.size();
+  }
+  return s;
+}
+
+void ColumnarTableBuilder::Abandon() { closed_ = true; }
+
+uint64_t ColumnarTableBuilder::NumEntries() const {
+  return properties_.num_entries;
+}
+
+uint64_t ColumnarTableBuilder::FileSize() const { return offset_; }
+
+}  // namespace TERARKDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,103 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/format.h"
+#include "table/table_builder.h"
+
+namespace TERARKDB_NAMESPACE {
+
+class ColBufEncoder;
+class WritableFileWriter;
+
+class ColumnarTableBuilder : public TableBuilder {
+ public:
+  ColumnarTableBuilder(const TableBuilderOptions& builder_options,
+                       uint32_t column_family_id, WritableFileWriter* file,
+                       const ColumnarTableOptions& table_options);
+
+  // REQUIRES: Either Finish() or Abandon() has been called.
+  ~ColumnarTableBuilder();
+
+  // Add key,value to the table being constructed.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: Finish(), Abandon() have not been called
+  Status Add(const Slice& key, const LazyBuffer& value) override;
+
+  // Finish building the table.  Stops using the file passed to the
+  // constructor after this function returns.
+  // REQUIRES: Finish(), Abandon() have not been called
+  Status Finish(const TablePropertyCache* prop,
+                const std::vector<SequenceNumber>* snapshots,
+                const std::vector<uint64_t>* inheritance_tree) override;
+
+  // Indicate that the contents of this builder should be abandoned.  Stops
+  // using the file passed to the constructor after this function returns.
+  // If the caller is not going to call Finish(), it must call Abandon()
+  // before destroying this builder.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Abandon() override;
+
+  // Number of calls to Add() so far.
+  uint64_t NumEntries() const override;
+
+  // Size of the file generated so far.  If invoked after a successful
+  // Finish() call, returns the size of the final generated file.
+  uint64_t FileSize() const override;
+
+  TableProperties GetTableProperties() const override { return properties_; }
+
+ private:
+  // Start a block, encoders keep per block state
+  void ResetBlock();
+  // Write the columns of the current block and add it to the index
+  Status FlushBlock();
+  // Compress `raw` with `type` and append it with a block trailer
+  Status WriteColumn(const Slice& raw, CompressionType type,
+                     BlockHandle* handle);
+
+  const ImmutableCFOptions& ioptions_;
+  ColumnarTableOptions table_options_;
+  std::vector<std::unique_ptr<IntTblPropCollector>>
+      table_properties_collectors_;
+
+  WritableFileWriter* file_;
+  uint64_t offset_ = 0;
+  TableProperties properties_;
+  Status status_;
+  bool closed_ = false;  // Either Finish() or Abandon() has been called.
+
+  // Current block
+  size_t block_rows_ = 0;
+  std::string last_key_;
+  std::string keys_;
+  std::string wholes_;
+  std::string tails_;
+  std::vector<std::unique_ptr<ColBufEncoder>> encoders_;
+  std::vector<Slice> value_columns_;
+
+  // Index meta block
+  std::string index_;
+  std::string compressed_output_;
+
+  // No copying allowed
+  ColumnarTableBuilder(const ColumnarTableBuilder&) = delete;
+  void operator=(const ColumnarTableBuilder&) = delete;
+};
+
+}  // namespace TERARKDB_NAMESPACE
+
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,245 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#include "table/columnar_table_factory.h"
+
+#include <stdio.h>
+
+#include "port/port.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/columnar_table_builder.h"
+#include "table/columnar_table_reader.h"
+#include "util/coding.h"
+#include "util/string_util.h"
+#include "utilities/col_buf_encoder.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// kColumnarTableMagicNumber was picked by running
+//    echo rocksdb.table.columnar | sha1sum
+// and taking the leading 64 bits.
+const uint64_t kColumnarTableMagicNumber = 0x3bb2b1f0a7d9be5dull;
+
+const std::string ColumnarTablePropertyNames::kColumns =
+    "rocksdb.columnar.columns";
+const std::string ColumnarTableIndexNames::kIndexBlock =
+    "rocksdb.columnar.index";
+
+static_assert(static_cast<int>(ColumnarTableColumn::kRleDict) ==
+                  static_cast<int>(kColRleDict),
+              "ColumnarTableColumn::Encoding must match ColCompressionType");
+
+namespace {
+
+// Chunk mark of a kVariableChunk value whose last chunk uses `used` bytes
+const uint8_t kChunkMarkBase = 0xFF - 8;
+
+}  // namespace
+
+size_t ColumnarColumnWidth(const ColumnarTableColumn& column,
+                           const Slice& input) {
+  switch (column.type) {
+    case ColumnarTableColumn::kFixedLength:
+    case ColumnarTableColumn::kLongFixedLength:
+      return input.size() >= column.size ? column.size : 0;
+    case ColumnarTableColumn::kVariableLength:
+      if (input.empty() ||
+          input.size() < 1 + static_cast<uint8_t>(input[0])) {
+        return 0;
+      }
+      return 1 + static_cast<uint8_t>(input[0]);
+    case ColumnarTableColumn::kVariableChunk:
+      for (size_t pos = 0; pos + 9 <= input.size(); pos += 9) {
+        auto mark = static_cast<uint8_t>(input[pos + 8]);
+        if (mark == 0xFF) {
+          continue;
+        }
+        if (mark < kChunkMarkBase) {
+          return 0;
+        }
+        // Unused bytes are not stored unless the column is a dictionary
+        size_t used = mark - kChunkMarkBase;
+        for (size_t i = used;
+             column.encoding != ColumnarTableColumn::kDict && i < 8; ++i) {
+          if (input[pos + i] != 0) {
+            return 0;
+          }
+        }
+        return pos + 9;
+      }
+      return 0;
+  }
+  return 0;
+}
+
+size_t ColumnarDecodedWidth(const ColumnarTableColumn& column,
+                            const char* src) {
+  switch (column.type) {
+    case ColumnarTableColumn::kFixedLength:
+    case ColumnarTableColumn::kLongFixedLength:
+      return column.size;
+    case ColumnarTableColumn::kVariableLength:
+      return 1 + static_cast<uint8_t>(src[0]);
+    case ColumnarTableColumn::kVariableChunk: {
+      uint64_t size = 0;
+      GetVarint64Ptr(src, src + 10, &size);
+      return static_cast<size_t>(size / 8 + 1) * 9;
+    }
+  }
+  return 0;
+}
+
+void AppendColumnarPlaceholder(const ColumnarTableColumn& column,
+                               std::string* dst) {
+  switch (column.type) {
+    case ColumnarTableColumn::kFixedLength:
+    case ColumnarTableColumn::kLongFixedLength:
+      dst->append(column.size, '\0');
+      break;
+    case ColumnarTableColumn::kVariableLength:
+      dst->push_back('\0');
+      break;
+    case ColumnarTableColumn::kVariableChunk:
+      dst->append(8, '\0');
+      dst->push_back(static_cast<char>(kChunkMarkBase));
+      break;
+  }
+}
+
+ColDeclaration ToColDeclaration(const ColumnarTableColumn& column) {
+  static const char* kTypeNames[] = {"FixedLength", "LongFixedLength",
+                                     "VariableLength", "VariableChunk"};
+  return ColDeclaration(kTypeNames[column.type],
+                        static_cast<ColCompressionType>(column.encoding),
+                        column.size, false /* nullable */, column.big_endian);
+}
+
+void EncodeColumnarColumns(const std::vector<ColumnarTableColumn>& columns,
+                           std::string* dst) {
+  PutVarint32(dst, static_cast<uint32_t>(columns.size()));
+  for (auto& column : columns) {
+    dst->push_back(static_cast<char>(column.type));
+    dst->push_back(static_cast<char>(column.encoding));
+    PutVarint64(dst, column.size);
+    dst->push_back(column.big_endian ? 1 : 0);
+    dst->push_back(static_cast<char>(column.compression));
+  }
+}
+
+bool DecodeColumnarColumns(Slice input,
+                           std::vector<ColumnarTableColumn>* columns) {
+  uint32_t num_columns;
+  if (!GetVarint32(&input, &num_columns)) {
+    return false;
+  }
+  columns->resize(num_columns);
+  for (auto& column : *columns) {
+    uint64_t size;
+    if (input.size() < 2) {
+      return false;
+    }
+    column.type = static_cast<ColumnarTableColumn::Type>(input[0]);
+    column.encoding = static_cast<ColumnarTableColumn::Encoding>(input[1]);
+    input.remove_prefix(2);
+    if (!GetVarint64(&input, &size) || input.size() < 2 ||
+        column.type > ColumnarTableColumn::kVariableChunk ||
+        column.encoding > ColumnarTableColumn::kRleDict) {
+      return false;
+    }
+    column.size = static_cast<size_t>(size);
+    column.big_endian = input[0] != 0;
+    column.compression = static_cast<CompressionType>(input[1]);
+    input.remove_prefix(2);
+  }
+  return input.empty();
+}
+
+Status ColumnarTableFactory::NewTableReader(
+    const TableReaderOptions& table_reader_options,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    std::unique_ptr<TableReader>* table,
+    bool /*prefetch_index_and_filter_in_cache*/) const {
+  return ColumnarTableReader::Open(
+      table_reader_options.ioptions, table_reader_options.internal_comparator,
+      std::move(file), table_reader_options.file_number, file_size, table);
+}
+
+TableBuilder* ColumnarTableFactory::NewTableBuilder(
+    const TableBuilderOptions& table_builder_options, uint32_t column_family_id,
+    WritableFileWriter* file) const {
+  // Ignore the skip_filters flag, this format has no filters
+  return new ColumnarTableBuilder(table_builder_options, column_family_id,
+                                  file, table_options_);
+}
+
+Status ColumnarTableFactory::SanitizeOptions(
+    const DBOptions& /*db_opts*/, const ColumnFamilyOptions& /*cf_opts*/) const {
+  if (table_options_.block_rows == 0) {
+    return Status::InvalidArgument("block_rows must be positive");
+  }
+  for (auto& column : table_options_.columns) {
+    bool valid = true;
+    switch (column.type) {
+      case ColumnarTableColumn::kFixedLength:
+        valid = column.size > 0 && column.size <= 8;
+        break;
+      case ColumnarTableColumn::kLongFixedLength:
+        valid = column.size > 0 &&
+                column.encoding == ColumnarTableColumn::kPlain;
+        break;
+      case ColumnarTableColumn::kVariableLength:
+        valid = column.encoding == ColumnarTableColumn::kPlain;
+        break;
+      case ColumnarTableColumn::kVariableChunk:
+        valid = column.encoding == ColumnarTableColumn::kPlain ||
+                column.encoding == ColumnarTableColumn::kDict;
+        break;
+      default:
+        valid = false;
+    }
+    if (!valid) {
+      return Status::InvalidArgument("Invalid ColumnarTable column");
+    }
+  }
+  if (table_options_.columns.size() >= 64) {
+    return Status::InvalidArgument("ColumnarTable supports up to 63 columns");
+  }
+  return Status::OK();
+}
+
+std::string ColumnarTableFactory::GetPrintableTableOptions() const {
+  std::string ret;
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+
+  snprintf(buffer, kBufferSize, "  block_rows: %" ROCKSDB_PRIszt "\n",
+           table_options_.block_rows);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  compression: %d\n",
+           static_cast<int>(table_options_.compression));
+  ret.append(buffer);
+  for (size_t i = 0; i < table_options_.columns.size(); ++i) {
+    auto& column = table_options_.columns[i];
+    snprintf(buffer, kBufferSize,
+             "  column %" ROCKSDB_PRIszt
+             ": type %d encoding %d size %" ROCKSDB_PRIszt
+             " big_endian %d compression %d\n",
+             i, static_cast<int>(column.type),
+             static_cast<int>(column.encoding), column.size,
+             static_cast<int>(column.big_endian),
+             static_cast<int>(column.compression));
+    ret.append(buffer);
+  }
+  return ret;
+}
+
+TableFactory* NewColumnarTableFactory(
+    const ColumnarTableOptions& table_options) {
+  return new ColumnarTableFactory(table_options);
+}
+
+}  // namespace TERARKDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,103 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+#include "rocksdb/terark_namespace.h"
+
+namespace TERARKDB_NAMESPACE {
+
+struct ColDeclaration;
+
+// ColumnarTable stores the entries of a file in blocks of block_rows
+// entries. Every block is written as a run of separately compressed column
+// blocks, each with the usual 1-byte type + 32-bit crc trailer:
+//
+//   [keys]   per entry: varint32 key length, internal key, kind byte
+//   [whole]  per entry stored whole: varint32 length, value
+//   [col 0]  ColBufEncoder output of the entries stored by column
+//   ...
+//   [col N-1]
+//   [tail]   per entry stored by column: varint32 length, trailing bytes
+//
+// followed by the index meta block, the properties block, the metaindex
+// block and the footer. The index holds, per block, the number of entries,
+// the last key and the handles of its column blocks. The column
+// declarations are kept in the table properties, so a file is read with the
+// schema it was written with.
+extern const uint64_t kColumnarTableMagicNumber;
+
+struct ColumnarTableIndexNames {
+  static const std::string kIndexBlock;
+};
+
+enum ColumnarEntryKind : unsigned char {
+  kColumnarEntryByColumn = 0,
+  kColumnarEntryWhole = 1,
+};
+
+// Bytes `column` takes at the start of `input`, zero if `input` does not
+// hold a valid value of it.
+extern size_t ColumnarColumnWidth(const ColumnarTableColumn& column,
+                                  const Slice& input);
+
+// Bytes a value of `column` decodes to, `src` is its encoded form.
+extern size_t ColumnarDecodedWidth(const ColumnarTableColumn& column,
+                                   const char* src);
+
+// Append the value a column left out by ReadOptions::column_mask reads as.
+extern void AppendColumnarPlaceholder(const ColumnarTableColumn& column,
+                                      std::string* dst);
+
+extern ColDeclaration ToColDeclaration(const ColumnarTableColumn& column);
+
+extern void EncodeColumnarColumns(
+    const std::vector<ColumnarTableColumn>& columns, std::string* dst);
+
+extern bool DecodeColumnarColumns(Slice input,
+                                  std::vector<ColumnarTableColumn>* columns);
+
+class ColumnarTableFactory : public TableFactory {
+ public:
+  explicit ColumnarTableFactory(const ColumnarTableOptions& table_options)
+      : table_options_(table_options) {}
+  ~ColumnarTableFactory() {}
+
+  const char* Name() const override { return "ColumnarTable"; }
+
+  Status NewTableReader(
+      const TableReaderOptions& table_reader_options,
+      std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+      std::unique_ptr<TableReader>* table,
+      bool prefetch_index_and_filter_in_cache = true) const override;
+
+  TableBuilder* NewTableBuilder(
+      const TableBuilderOptions& table_builder_options,
+      uint32_t column_family_id, WritableFileWriter* file) const override;
+
+  Status SanitizeOptions(const DBOptions& db_opts,
+                         const ColumnFamilyOptions& cf_opts) const override;
+
+  std::string GetPrintableTableOptions() const override;
+
+  void* GetOptions() override { return &table_options_; }
+
+  Status GetOptionString(std::string* /*opt_string*/,
+                         const std::string& /*delimiter*/) const override {
+    return Status::OK();
+  }
+
+ private:
+  ColumnarTableOptions table_options_;
+};
+
+}  // namespace TERARKDB_NAMESPACE
+#endif  // ROCKSDB_LITE
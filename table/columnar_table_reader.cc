@@ -0,0 +1,422 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#include "table/columnar_table_reader.h"
+
+#include <algorithm>
+
+#include "rocksdb/terark_namespace.h"
+#include "table/columnar_table_factory.h"
+#include "table/get_context.h"
+#include "table/internal_iterator.h"
+#include "table/meta_blocks.h"
+#include "util/arena.h"
+#include "util/coding.h"
+#include "util/file_reader_writer.h"
+#include "utilities/col_buf_decoder.h"
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+// Iterates a ColumnarTable one decoded block at a time
+class ColumnarTableIterator : public InternalIterator {
+ public:
+  ColumnarTableIterator(const ColumnarTableReader* reader,
+                        const ReadOptions& read_options)
+      : reader_(reader),
+        read_options_(read_options),
+        block_index_(reader->NumBlocks()),
+        loaded_index_(reader->NumBlocks()),
+        row_(0) {}
+  ~ColumnarTableIterator() {}
+
+  bool Valid() const override {
+    return status_.ok() && block_index_ < reader_->NumBlocks() &&
+           row_ < block_.keys.size();
+  }
+
+  void SeekToFirst() override {
+    status_ = Status::OK();
+    if (LoadBlock(0)) {
+      row_ = 0;
+    }
+  }
+
+  void SeekToLast() override {
+    status_ = Status::OK();
+    if (reader_->NumBlocks() > 0 && LoadBlock(reader_->NumBlocks() - 1)) {
+      row_ = block_.keys.size() - 1;
+    }
+  }
+
+  void Seek(const Slice& target) override {
+    status_ = Status::OK();
+    if (!LoadBlock(reader_->FindBlock(target))) {
+      return;
+    }
+    auto& icmp = reader_->internal_comparator();
+    row_ = std::lower_bound(block_.keys.begin(), block_.keys.end(), target,
+                            [&icmp](const Slice& a, const Slice& b) {
+                              return icmp.Compare(a, b) < 0;
+                            }) -
+           block_.keys.begin();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    SeekForPrevImpl(target, &reader_->internal_comparator());
+  }
+
+  void Next() override {
+    assert(Valid());
+    if (++row_ == block_.keys.size() && LoadBlock(block_index_ + 1)) {
+      row_ = 0;
+    }
+  }
+
+  void Prev() override {
+    assert(Valid());
+    if (row_ > 0) {
+      --row_;
+    } else if (block_index_ == 0) {
+      block_index_ = reader_->NumBlocks();
+    } else if (LoadBlock(block_index_ - 1)) {
+      row_ = block_.keys.size() - 1;
+    }
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return block_.keys[row_];
+  }
+
+  LazyBuffer value() const override {
+    assert(Valid());
+    return LazyBuffer(block_.values[row_], false, reader_->FileNumber());
+  }
+
+  Status status() const override { return status_; }
+
+ private:
+  // Position on block `index`, false if there is no such block or it can
+  // not be read
+  bool LoadBlock(size_t index) {
+    block_index_ = index;
+    if (index >= reader_->NumBlocks()) {
+      return false;
+    }
+    if (index != loaded_index_) {
+      loaded_index_ = reader_->NumBlocks();
+      status_ = reader_->ReadBlock(read_options_, index,
+                                   read_options_.column_mask, &block_);
+      if (!status_.ok()) {
+        block_.Clear();
+        return false;
+      }
+      loaded_index_ = index;
+    }
+    return true;
+  }
+
+  const ColumnarTableReader* reader_;
+  const ReadOptions read_options_;
+  size_t block_index_;
+  size_t loaded_index_;
+  size_t row_;
+  ColumnarBlock block_;
+  Status status_;
+};
+
+}  // namespace
+
+ColumnarTableReader::ColumnarTableReader(
+    const ImmutableCFOptions& ioptions,
+    const InternalKeyComparator& internal_comparator,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_number,
+    uint64_t file_size)
+    : ioptions_(ioptions),
+      internal_comparator_(internal_comparator),
+      file_(std::move(file)),
+      file_number_(file_number),
+      file_size_(file_size) {}
+
+Status ColumnarTableReader::Open(
+    const ImmutableCFOptions& ioptions,
+    const InternalKeyComparator& internal_comparator,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_number,
+    uint64_t file_size, std::unique_ptr<TableReader>* table_reader) {
+  std::unique_ptr<ColumnarTableReader> reader(new ColumnarTableReader(
+      ioptions, internal_comparator, std::move(file), file_number, file_size));
+  RandomAccessFileReader* file_reader = reader->file_.get();
+
+  Status s = ReadFooterFromFile(file_reader, nullptr /* prefetch_buffer */,
+                                file_size, &reader->footer_,
+                                kColumnarTableMagicNumber);
+  if (!s.ok()) {
+    return s;
+  }
+
+  TableProperties* props = nullptr;
+  s = ReadTableProperties(file_reader, file_size, kColumnarTableMagicNumber,
+                          ioptions, &props);
+  if (!s.ok()) {
+    return s;
+  }
+  reader->table_properties_.reset(props);
+  auto& user_props = props->user_collected_properties;
+  auto columns = user_props.find(ColumnarTablePropertyNames::kColumns);
+  if (columns == user_props.end() ||
+      !DecodeColumnarColumns(columns->second, &reader->columns_)) {
+    return Status::Corruption("ColumnarTable columns not found");
+  }
+
+  BlockContents index_contents;
+  s = ReadMetaBlock(file_reader, nullptr /* prefetch_buffer */, file_size,
+                    kColumnarTableMagicNumber, ioptions,
+                    ColumnarTableIndexNames::kIndexBlock, &index_contents);
+  if (!s.ok()) {
+    return s;
+  }
+  const size_t num_handles = reader->columns_.size() + 3;
+  Slice index = index_contents.data;
+  while (!index.empty()) {
+    BlockIndex block;
+    Slice last_key;
+    if (!GetVarint32(&index, &block.num_rows) || block.num_rows == 0 ||
+        !GetLengthPrefixedSlice(&index, &last_key)) {
+      return Status::Corruption("Bad ColumnarTable index");
+    }
+    block.last_key.assign(last_key.data(), last_key.size());
+    block.handles.resize(num_handles);
+    for (auto& handle : block.handles) {
+      s = handle.DecodeFrom(&index);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    reader->blocks_.emplace_back(std::move(block));
+  }
+
+  *table_reader = std::move(reader);
+  return Status::OK();
+}
+
+size_t ColumnarTableReader::FindBlock(const Slice& target) const {
+  return std::lower_bound(blocks_.begin(), blocks_.end(), target,
+                          [this](const BlockIndex& block, const Slice& key) {
+                            return internal_comparator_.Compare(
+                                       block.last_key, key) < 0;
+                          }) -
+         blocks_.begin();
+}
+
+Status ColumnarTableReader::ReadColumn(const ReadOptions& read_options,
+                                       const BlockHandle& handle,
+                                       BlockContents* contents) const {
+  return ReadBlockContents(file_.get(), nullptr /* prefetch_buffer */, footer_,
+                           read_options, handle, contents, ioptions_,
+                           true /* do_uncompress */);
+}
+
+Status ColumnarTableReader::DecodeColumn(
+    size_t column, const Slice& data, size_t num_rows, std::string* output,
+    std::vector<uint32_t>* offsets) const {
+  auto& declaration = columns_[column];
+  std::unique_ptr<ColBufDecoder> decoder(
+      ColBufDecoder::NewColBufDecoder(ToColDeclaration(declaration)));
+  const char* src = data.data();
+  const char* limit = data.data() + data.size();
+  src += decoder->Init(src);
+  for (size_t i = 0; i < num_rows; ++i) {
+    if (src > limit ||
+        (declaration.type != ColumnarTableColumn::kFixedLength &&
+         src == limit)) {
+      return Status::Corruption("Truncated ColumnarTable column");
+    }
+    size_t offset = output->size();
+    offsets->push_back(static_cast<uint32_t>(offset));
+    output->resize(offset + ColumnarDecodedWidth(declaration, src));
+    char* dest = &(*output)[offset];
+    src += decoder->Decode(src, &dest);
+  }
+  offsets->push_back(static_cast<uint32_t>(output->size()));
+  if (src > limit) {
+    return Status::Corruption("Truncated ColumnarTable column");
+  }
+  return Status::OK();
+}
+
+Status ColumnarTableReader::ReadBlock(const ReadOptions& read_options,
+                                      size_t block, uint64_t column_mask,
+                                      ColumnarBlock* result) const {
+  assert(block < blocks_.size());
+  auto& index = blocks_[block];
+  const size_t num_columns = columns_.size();
+  result->Clear();
+
+  // Keys and the way each value is stored
+  Status s = ReadColumn(read_options, index.handles[0], &result->key_column);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<bool> whole(index.num_rows);
+  size_t num_by_column = 0;
+  Slice input = result->key_column.data;
+  for (size_t i = 0; i < index.num_rows; ++i) {
+    Slice key;
+    if (!GetLengthPrefixedSlice(&input, &key) || input.empty()) {
+      return Status::Corruption("Bad ColumnarTable key column");
+    }
+    whole[i] = input[0] == static_cast<char>(kColumnarEntryWhole);
+    num_by_column += whole[i] ? 0 : 1;
+    input.remove_prefix(1);
+    result->keys.push_back(key);
+  }
+
+  BlockContents wholes;
+  if (num_by_column < index.num_rows) {
+    s = ReadColumn(read_options, index.handles[1], &wholes);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // Decode the selected columns, each into its own buffer
+  std::vector<std::string> column_data(num_columns);
+  std::vector<std::vector<uint32_t>> column_offsets(num_columns);
+  for (size_t c = 0; num_by_column > 0 && c < num_columns; ++c) {
+    if ((column_mask & (uint64_t(1) << c)) == 0) {
+      continue;
+    }
+    BlockContents contents;
+    s = ReadColumn(read_options, index.handles[2 + c], &contents);
+    if (s.ok()) {
+      s = DecodeColumn(c, contents.data, num_by_column, &column_data[c],
+                       &column_offsets[c]);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  BlockContents tails;
+  bool read_tails = (column_mask & (uint64_t(1) << num_columns)) != 0;
+  if (num_by_column > 0 && read_tails) {
+    s = ReadColumn(read_options, index.handles[2 + num_columns], &tails);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // Rebuild the values
+  std::vector<size_t> value_offsets;
+  value_offsets.reserve(index.num_rows + 1);
+  Slice whole_input = wholes.data;
+  Slice tail_input = tails.data;
+  std::string& values = result->value_data;
+  for (size_t i = 0, by_column = 0; i < index.num_rows; ++i) {
+    value_offsets.push_back(values.size());
+    if (whole[i]) {
+      Slice value;
+      if (!GetLengthPrefixedSlice(&whole_input, &value)) {
+        return Status::Corruption("Bad ColumnarTable whole column");
+      }
+      values.append(value.data(), value.size());
+      continue;
+    }
+    for (size_t c = 0; c < num_columns; ++c) {
+      if (column_offsets[c].empty()) {
+        AppendColumnarPlaceholder(columns_[c], &values);
+      } else {
+        auto& offsets = column_offsets[c];
+        values.append(column_data[c].data() + offsets[by_column],
+                      offsets[by_column + 1] - offsets[by_column]);
+      }
+    }
+    if (read_tails) {
+      Slice tail;
+      if (!GetLengthPrefixedSlice(&tail_input, &tail)) {
+        return Status::Corruption("Bad ColumnarTable tail column");
+      }
+      values.append(tail.data(), tail.size());
+    }
+    ++by_column;
+  }
+  value_offsets.push_back(values.size());
+  for (size_t i = 0; i < index.num_rows; ++i) {
+    result->values.emplace_back(values.data() + value_offsets[i],
+                                value_offsets[i + 1] - value_offsets[i]);
+  }
+  return Status::OK();
+}
+
+InternalIterator* ColumnarTableReader::NewIterator(
+    const ReadOptions& read_options,
+    const SliceTransform* /* prefix_extractor */, Arena* arena,
+    bool /*skip_filters*/, bool /*for_compaction*/) {
+  if (arena == nullptr) {
+    return new ColumnarTableIterator(this, read_options);
+  }
+  auto mem = arena->AllocateAligned(sizeof(ColumnarTableIterator));
+  return new (mem) ColumnarTableIterator(this, read_options);
+}
+
+Status ColumnarTableReader::Get(const ReadOptions& read_options,
+                                const Slice& key, GetContext* get_context,
+                                const SliceTransform* /* prefix_extractor */,
+                                bool /*skip_filters*/) {
+  ColumnarTableIterator iter(this, read_options);
+  for (iter.Seek(key); iter.Valid(); iter.Next()) {
+    ParsedInternalKey parsed_key;
+    if (!ParseInternalKey(iter.key(), &parsed_key)) {
+      return Status::Corruption(Slice());
+    }
+    bool matched = false;
+    // The block goes away with the iterator, hand over a copy
+    if (!get_context->SaveValue(
+            parsed_key, LazyBuffer(iter.value().slice(), true, file_number_),
+            &matched)) {
+      break;
+    }
+  }
+  return iter.status();
+}
+
+uint64_t ColumnarTableReader::ApproximateOffsetOf(const Slice& key) {
+  size_t block = FindBlock(key);
+  if (block >= blocks_.size()) {
+    return footer_.index_handle().offset();
+  }
+  return blocks_[block].handles[0].offset();
+}
+
+size_t ColumnarTableReader::ApproximateMemoryUsage() const {
+  size_t usage = sizeof(*this) + blocks_.capacity() * sizeof(BlockIndex);
+  for (auto& block : blocks_) {
+    usage += block.last_key.capacity() +
+             block.handles.capacity() * sizeof(BlockHandle);
+  }
+  return usage;
+}
+
+Status ColumnarTableReader::VerifyChecksum() {
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  for (auto& block : blocks_) {
+    for (auto& handle : block.handles) {
+      BlockContents contents;
+      Status s = ReadBlockContents(file_.get(), nullptr /* prefetch_buffer */,
+                                   footer_, read_options, handle, &contents,
+                                   ioptions_, false /* do_uncompress */);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace TERARKDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,125 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "options/cf_options.h"
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/format.h"
+#include "table/table_reader.h"
+
+namespace TERARKDB_NAMESPACE {
+
+class RandomAccessFileReader;
+
+// The entries of one ColumnarTable block, with the values rebuilt from the
+// columns selected by a column mask
+struct ColumnarBlock {
+  std::vector<Slice> keys;
+  std::vector<Slice> values;
+  // Backing storage of keys and values
+  BlockContents key_column;
+  std::string value_data;
+
+  void Clear() {
+    keys.clear();
+    values.clear();
+    key_column = BlockContents();
+    value_data.clear();
+  }
+};
+
+class ColumnarTableReader : public TableReader {
+ public:
+  static Status Open(const ImmutableCFOptions& ioptions,
+                     const InternalKeyComparator& internal_comparator,
+                     std::unique_ptr<RandomAccessFileReader>&& file,
+                     uint64_t file_number, uint64_t file_size,
+                     std::unique_ptr<TableReader>* table_reader);
+
+  InternalIterator* NewIterator(const ReadOptions&,
+                                const SliceTransform* prefix_extractor,
+                                Arena* arena = nullptr,
+                                bool skip_filters = false,
+                                bool for_compaction = false) override;
+
+  Status Get(const ReadOptions& readOptions, const Slice& key,
+             GetContext* get_context, const SliceTransform* prefix_extractor,
+             bool skip_filters = false) override;
+
+  uint64_t ApproximateOffsetOf(const Slice& key) override;
+
+  void SetupForCompaction() override {}
+
+  std::shared_ptr<const TableProperties> GetTableProperties() const override {
+    return table_properties_;
+  }
+
+  size_t ApproximateMemoryUsage() const override;
+
+  uint64_t FileNumber() const override { return file_number_; }
+
+  Status VerifyChecksum() override;
+
+  size_t NumBlocks() const { return blocks_.size(); }
+
+  // Index of the first block whose last key is at or after `target`,
+  // NumBlocks() if there is none
+  size_t FindBlock(const Slice& target) const;
+
+  // Read the keys and the columns selected by `column_mask` of a block
+  Status ReadBlock(const ReadOptions& read_options, size_t block,
+                   uint64_t column_mask, ColumnarBlock* result) const;
+
+  const InternalKeyComparator& internal_comparator() const {
+    return internal_comparator_;
+  }
+
+ private:
+  struct BlockIndex {
+    std::string last_key;
+    uint32_t num_rows;
+    // keys, whole values, value columns, trailing bytes
+    std::vector<BlockHandle> handles;
+  };
+
+  ColumnarTableReader(const ImmutableCFOptions& ioptions,
+                      const InternalKeyComparator& internal_comparator,
+                      std::unique_ptr<RandomAccessFileReader>&& file,
+                      uint64_t file_number, uint64_t file_size);
+
+  Status ReadColumn(const ReadOptions& read_options, const BlockHandle& handle,
+                    BlockContents* contents) const;
+
+  Status DecodeColumn(size_t column, const Slice& data, size_t num_rows,
+                      std::string* output,
+                      std::vector<uint32_t>* offsets) const;
+
+  const ImmutableCFOptions& ioptions_;
+  const InternalKeyComparator internal_comparator_;
+  std::unique_ptr<RandomAccessFileReader> file_;
+  uint64_t file_number_;
+  uint64_t file_size_;
+  Footer footer_;
+  std::shared_ptr<const TableProperties> table_properties_;
+  std::vector<ColumnarTableColumn> columns_;
+  std::vector<BlockIndex> blocks_;
+
+  // No copying allowed
+  ColumnarTableReader(const ColumnarTableReader&) = delete;
+  void operator=(const ColumnarTableReader&) = delete;
+};
+
+}  // namespace TERARKDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,408 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/compact_index_block.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "db/dbformat.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/coding.h"
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+// The model input of a key: its first 8 bytes after the shared prefix as a
+// big endian integer, so that it is monotonic in bytewise order
+uint64_t KeyToX(const Slice& suffix) {
+  uint64_t x = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    x <<= 8;
+    if (i < suffix.size()) {
+      x |= static_cast<uint8_t>(suffix[i]);
+    }
+  }
+  return x;
+}
+
+void PutDouble(std::string* dst, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  PutFixed64(dst, bits);
+}
+
+double DecodeDouble(const char* ptr) {
+  uint64_t bits = DecodeFixed64(ptr);
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+void CompactIndexBlockBuilder::Add(const Slice& key,
+                                   const BlockHandle& handle) {
+  assert(key.size() >= 8);
+  key_offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+  keys_.append(key.data(), key.size());
+  handles_.push_back(handle);
+}
+
+Slice CompactIndexBlockBuilder::Finish(bool key_includes_seq, bool bytewise) {
+  const size_t n = handles_.size();
+  key_offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+  auto user_key = [&](size_t i) {
+    return Slice(keys_.data() + key_offsets_[i],
+                 key_offsets_[i + 1] - key_offsets_[i] - 8);
+  };
+
+  size_t prefix_len = n == 0 ? 0 : user_key(0).size();
+  for (size_t i = 1; i < n && prefix_len > 0; ++i) {
+    Slice prefix(keys_.data(), prefix_len);
+    prefix_len = user_key(i).difference_offset(prefix);
+  }
+
+  buffer_.clear();
+  if (n > 0) {
+    buffer_.append(keys_.data(), prefix_len);
+  }
+  std::string key_offsets;
+  size_t suffixes_start = buffer_.size();
+  for (size_t i = 0; i < n; ++i) {
+    PutFixed32(&key_offsets,
+               static_cast<uint32_t>(buffer_.size() - suffixes_start));
+    Slice suffix = user_key(i);
+    if (key_includes_seq) {
+      suffix = Slice(suffix.data(), suffix.size() + 8);
+    }
+    suffix.remove_prefix(prefix_len);
+    buffer_.append(suffix.data(), suffix.size());
+  }
+  uint32_t suffixes_len =
+      static_cast<uint32_t>(buffer_.size() - suffixes_start);
+  PutFixed32(&key_offsets, suffixes_len);
+  buffer_.append(key_offsets);
+
+  uint32_t flags = 0;
+  if (key_includes_seq) {
+    flags |= CompactIndexBlock::kKeyIncludesSeq;
+  }
+  uint64_t base_offset = n == 0 ? 0 : handles_[0].offset();
+  bool adjacent = true;
+  for (size_t i = 0; i < n; ++i) {
+    if (handles_[i].offset() - base_offset >
+        std::numeric_limits<uint32_t>::max()) {
+      flags |= CompactIndexBlock::kWideOffsets;
+    }
+    if (i + 1 < n && handles_[i].offset() + handles_[i].size() +
+                             kBlockTrailerSize !=
+                         handles_[i + 1].offset()) {
+      adjacent = false;
+    }
+  }
+  if (adjacent) {
+    flags |= CompactIndexBlock::kAdjacentBlocks;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t offset = handles_[i].offset() - base_offset;
+    if (flags & CompactIndexBlock::kWideOffsets) {
+      PutFixed64(&buffer_, offset);
+    } else {
+      PutFixed32(&buffer_, static_cast<uint32_t>(offset));
+    }
+  }
+  for (size_t i = adjacent && n > 0 ? n - 1 : 0; i < n; ++i) {
+    PutFixed32(&buffer_, static_cast<uint32_t>(handles_[i].size()));
+  }
+
+  // Greedy shrinking cone: extend a segment while a slope exists that keeps
+  // the first position of every distinct x within max error
+  uint32_t num_segments = 0;
+  if (bytewise && model_max_error_ > 0 && n > 0) {
+    const double max_error = model_max_error_;
+    uint64_t x0 = 0;
+    uint32_t y0 = 0;
+    double slope_lo = 0;
+    double slope_hi = std::numeric_limits<double>::infinity();
+    uint64_t last_x = 0;
+    auto finish_segment = [&] {
+      PutFixed64(&buffer_, x0);
+      PutFixed32(&buffer_, y0);
+      PutDouble(&buffer_, slope_hi == std::numeric_limits<double>::infinity()
+                              ? 0
+                              : (slope_lo + slope_hi) / 2);
+      ++num_segments;
+    };
+    for (size_t i = 0; i < n; ++i) {
+      Slice suffix = user_key(i);
+      suffix.remove_prefix(prefix_len);
+      uint64_t x = KeyToX(suffix);
+      if (i > 0 && x == last_x) {
+        continue;
+      }
+      last_x = x;
+      if (i > 0) {
+        double dx = static_cast<double>(x - x0);
+        double dy = static_cast<double>(i - y0);
+        if ((dy - max_error) / dx <= slope_hi &&
+            (dy + max_error) / dx >= slope_lo) {
+          slope_hi = std::min(slope_hi, (dy + max_error) / dx);
+          slope_lo = std::max(slope_lo, (dy - max_error) / dx);
+          continue;
+        }
+        finish_segment();
+      }
+      x0 = x;
+      y0 = static_cast<uint32_t>(i);
+      slope_lo = 0;
+      slope_hi = std::numeric_limits<double>::infinity();
+    }
+    finish_segment();
+  }
+
+  PutFixed32(&buffer_, static_cast<uint32_t>(prefix_len));
+  PutFixed32(&buffer_, suffixes_len);
+  PutFixed32(&buffer_, static_cast<uint32_t>(n));
+  PutFixed32(&buffer_, num_segments);
+  PutFixed32(&buffer_, num_segments > 0 ? model_max_error_ : 0);
+  PutFixed32(&buffer_, flags);
+  PutFixed64(&buffer_, base_offset);
+  return buffer_;
+}
+
+Status CompactIndexBlock::Create(const Slice& contents,
+                                 CompactIndexBlock** block) {
+  if (contents.size() < kTrailerSize) {
+    return Status::Corruption("compact index block too small");
+  }
+  const char* trailer = contents.data() + contents.size() - kTrailerSize;
+  std::unique_ptr<CompactIndexBlock> result(new CompactIndexBlock);
+  uint32_t prefix_len = DecodeFixed32(trailer);
+  uint32_t suffixes_len = DecodeFixed32(trailer + 4);
+  result->num_entries_ = DecodeFixed32(trailer + 8);
+  result->num_segments_ = DecodeFixed32(trailer + 12);
+  result->max_error_ = DecodeFixed32(trailer + 16);
+  result->flags_ = DecodeFixed32(trailer + 20);
+  result->base_offset_ = DecodeFixed64(trailer + 24);
+
+  const uint64_t n = result->num_entries_;
+  uint64_t offsets_len =
+      n * ((result->flags_ & kWideOffsets) ? sizeof(uint64_t)
+                                           : sizeof(uint32_t));
+  uint64_t sizes_len =
+      sizeof(uint32_t) * ((result->flags_ & kAdjacentBlocks) ? (n > 0) : n);
+  uint64_t expected_size = uint64_t(prefix_len) + suffixes_len +
+                           sizeof(uint32_t) * (n + 1) + offsets_len +
+                           sizes_len + kSegmentSize * result->num_segments_ +
+                           kTrailerSize;
+  if (expected_size != contents.size()) {
+    return Status::Corruption("compact index block size mismatch");
+  }
+
+  const char* p = contents.data();
+  result->prefix_ = Slice(p, prefix_len);
+  p += prefix_len;
+  result->suffixes_ = p;
+  p += suffixes_len;
+  result->key_offsets_ = p;
+  p += sizeof(uint32_t) * (n + 1);
+  result->handle_offsets_ = p;
+  p += offsets_len;
+  result->handle_sizes_ = p;
+  p += sizes_len;
+  result->segments_ = p;
+  if (DecodeFixed32(result->key_offsets_ + sizeof(uint32_t) * n) !=
+      suffixes_len) {
+    return Status::Corruption("compact index block bad key offsets");
+  }
+  *block = result.release();
+  return Status::OK();
+}
+
+Slice CompactIndexBlock::Suffix(uint32_t i) const {
+  assert(i < num_entries_);
+  uint32_t begin = DecodeFixed32(key_offsets_ + sizeof(uint32_t) * i);
+  uint32_t end = DecodeFixed32(key_offsets_ + sizeof(uint32_t) * (i + 1));
+  return Slice(suffixes_ + begin, end - begin);
+}
+
+BlockHandle CompactIndexBlock::Handle(uint32_t i) const {
+  assert(i < num_entries_);
+  auto offset_of = [this](uint32_t j) {
+    return base_offset_ +
+           ((flags_ & kWideOffsets)
+                ? DecodeFixed64(handle_offsets_ + sizeof(uint64_t) * j)
+                : DecodeFixed32(handle_offsets_ + sizeof(uint32_t) * j));
+  };
+  uint64_t offset = offset_of(i);
+  uint64_t size;
+  if (!(flags_ & kAdjacentBlocks)) {
+    size = DecodeFixed32(handle_sizes_ + sizeof(uint32_t) * i);
+  } else if (i + 1 < num_entries_) {
+    size = offset_of(i + 1) - offset - kBlockTrailerSize;
+  } else {
+    size = DecodeFixed32(handle_sizes_);
+  }
+  return BlockHandle(offset, size);
+}
+
+uint32_t CompactIndexBlock::Predict(const Slice& user_key) const {
+  assert(num_segments_ > 0);
+  if (!user_key.starts_with(prefix_)) {
+    return user_key.compare(prefix_) < 0 ? 0 : num_entries_;
+  }
+  uint64_t x = KeyToX(Slice(user_key.data() + prefix_.size(),
+                            user_key.size() - prefix_.size()));
+  // Last segment starting at or before x
+  uint32_t lo = 0;
+  uint32_t hi = num_segments_;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (DecodeFixed64(segments_ + kSegmentSize * mid) <= x) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  const char* segment = segments_ + kSegmentSize * lo;
+  uint64_t x0 = DecodeFixed64(segment);
+  uint32_t y0 = DecodeFixed32(segment + 8);
+  if (x <= x0) {
+    return y0;
+  }
+  double y = y0 + DecodeDouble(segment + 12) * static_cast<double>(x - x0);
+  double y_max = lo + 1 < num_segments_
+                     ? DecodeFixed32(segment + kSegmentSize + 8)
+                     : num_entries_;
+  return static_cast<uint32_t>(std::min(y + 0.5, y_max));
+}
+
+class CompactIndexBlock::Iter : public InternalIteratorBase<BlockHandle> {
+ public:
+  Iter(const CompactIndexBlock* block, const InternalKeyComparator* icomparator)
+      : block_(block),
+        icomparator_(icomparator),
+        current_(block->num_entries_) {}
+
+  virtual bool Valid() const override {
+    return current_ < block_->num_entries_;
+  }
+
+  virtual void SeekToFirst() override { SetCurrent(0); }
+
+  virtual void SeekToLast() override {
+    SetCurrent(block_->num_entries_ == 0 ? 0 : block_->num_entries_ - 1);
+  }
+
+  // Position at the first key at or after `target`
+  virtual void Seek(const Slice& target) override {
+    const uint32_t n = block_->num_entries_;
+    Slice user_target = ExtractUserKey(target);
+    uint64_t lo = 0;
+    uint64_t hi = n;
+    if (block_->num_segments_ > 0) {
+      // Entries before lo are less than target and entry hi is not, so the
+      // answer is in [lo, hi]
+      uint64_t error = block_->max_error_;
+      uint64_t predicted = block_->Predict(user_target);
+      lo = predicted > error ? predicted - error : 0;
+      hi = std::min<uint64_t>(n, predicted + error);
+      uint64_t step = error + 1;
+      while (lo > 0 && !Less(static_cast<uint32_t>(lo - 1), target)) {
+        hi = lo - 1;
+        lo = lo > step ? lo - step : 0;
+        step *= 2;
+      }
+      while (hi < n && Less(static_cast<uint32_t>(hi), target)) {
+        lo = hi + 1;
+        hi = std::min<uint64_t>(n, hi + step);
+        step *= 2;
+      }
+    }
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (Less(static_cast<uint32_t>(mid), target)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    SetCurrent(static_cast<uint32_t>(lo));
+  }
+
+  virtual void SeekForPrev(const Slice&) override {
+    assert(false);
+    current_ = block_->num_entries_;
+    status_ = Status::InvalidArgument(
+        "RocksDB internal error: should never call SeekForPrev() on index "
+        "blocks");
+  }
+
+  virtual void Next() override {
+    assert(Valid());
+    SetCurrent(current_ + 1);
+  }
+
+  virtual void Prev() override {
+    assert(Valid());
+    SetCurrent(current_ == 0 ? block_->num_entries_ : current_ - 1);
+  }
+
+  virtual Slice key() const override {
+    assert(Valid());
+    return key_;
+  }
+
+  virtual BlockHandle value() const override {
+    assert(Valid());
+    return block_->Handle(current_);
+  }
+
+  virtual Status status() const override { return status_; }
+
+ private:
+  void SetCurrent(uint32_t i) {
+    current_ = i;
+    if (Valid()) {
+      BuildKey(i, &key_);
+    }
+  }
+
+  void BuildKey(uint32_t i, std::string* key) const {
+    Slice suffix = block_->Suffix(i);
+    key->assign(block_->prefix_.data(), block_->prefix_.size());
+    key->append(suffix.data(), suffix.size());
+  }
+
+  bool Less(uint32_t i, const Slice& target) {
+    BuildKey(i, &scratch_);
+    if (block_->key_includes_seq()) {
+      return icomparator_->Compare(scratch_, target) < 0;
+    }
+    return icomparator_->user_comparator()->Compare(
+               scratch_, ExtractUserKey(target)) < 0;
+  }
+
+  const CompactIndexBlock* block_;
+  const InternalKeyComparator* icomparator_;
+  uint32_t current_;
+  std::string key_;
+  std::string scratch_;
+  Status status_;
+};
+
+InternalIteratorBase<BlockHandle>* CompactIndexBlock::NewIterator(
+    const InternalKeyComparator* icomparator) const {
+  return new Iter(this, icomparator);
+}
+
+}  // namespace TERARKDB_NAMESPACE
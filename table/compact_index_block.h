@@ -0,0 +1,120 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/format.h"
+#include "table/internal_iterator.h"
+
+namespace TERARKDB_NAMESPACE {
+
+class Comparator;
+class InternalKeyComparator;
+
+// The index block of BlockBasedTableOptions::kCompactIndexSearch.
+//
+// Separator keys are stored as one shared prefix plus a packed array of
+// suffixes addressed by fixed width offsets, block handles are stored as
+// fixed width offsets from the first data block. When the user comparator is
+// bytewise, a piecewise linear model maps the first 8 bytes of a key after
+// the shared prefix to its approximate position, so Seek() only needs to
+// compare keys in a small window around the prediction:
+//
+// +--------+----------+-------------------+-----------------+-----------+
+// | prefix | suffixes | key offsets (n+1) | block handles   | segments  |
+// +--------+----------+-------------------+-----------------+-----------+
+// | prefix len | suffixes len | n | segments | max error | flags | base  |
+// +------------+--------------+---+----------+-----------+-------+-------+
+//
+// The model is only a hint, a lookup falls back to an exponential search when
+// a prediction misses, so the result is always exact.
+class CompactIndexBlockBuilder {
+ public:
+  // `model_max_error` bounds the distance between a predicted and an actual
+  // position of the keys the model was trained on, 0 disables the model
+  explicit CompactIndexBlockBuilder(uint32_t model_max_error)
+      : model_max_error_(model_max_error) {}
+
+  // `key` is an internal key.
+  // REQUIRES: keys are added in increasing order
+  void Add(const Slice& key, const BlockHandle& handle);
+
+  // `key_includes_seq`: keep the sequence numbers of the keys, otherwise only
+  // their user keys are stored. The model and the shared prefix only look at
+  // the user keys.
+  // `bytewise`: the user comparator orders keys as byte strings, the model is
+  // only built in that case
+  Slice Finish(bool key_includes_seq, bool bytewise);
+
+  size_t NumEntries() const { return handles_.size(); }
+
+ private:
+  uint32_t model_max_error_;
+  std::string keys_;
+  std::vector<uint32_t> key_offsets_;
+  std::vector<BlockHandle> handles_;
+  std::string buffer_;
+};
+
+class CompactIndexBlock {
+ public:
+  // Parse `contents`, which must outlive the block
+  static Status Create(const Slice& contents, CompactIndexBlock** block);
+
+  // Keys are compared with `icomparator` if they include sequence numbers and
+  // with its user comparator otherwise.
+  InternalIteratorBase<BlockHandle>* NewIterator(
+      const InternalKeyComparator* icomparator) const;
+
+  bool key_includes_seq() const { return (flags_ & kKeyIncludesSeq) != 0; }
+  uint32_t NumEntries() const { return num_entries_; }
+  uint32_t NumSegments() const { return num_segments_; }
+
+  size_t ApproximateMemoryUsage() const { return sizeof(*this); }
+
+  // Number of bytes in the trailer of the block
+  static const size_t kTrailerSize = 6 * sizeof(uint32_t) + sizeof(uint64_t);
+  // Size of an encoded model segment: first x, first position, slope
+  static const size_t kSegmentSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+  enum Flags : uint32_t {
+    kKeyIncludesSeq = 1 << 0,
+    // Block handle offsets are encoded as fixed64 instead of fixed32
+    kWideOffsets = 1 << 1,
+    // Data blocks are adjacent, only the size of the last one is stored
+    kAdjacentBlocks = 1 << 2,
+  };
+
+ private:
+  class Iter;
+
+  CompactIndexBlock() = default;
+
+  Slice Suffix(uint32_t i) const;
+  BlockHandle Handle(uint32_t i) const;
+  // Approximate index of the first key at or after `user_key`
+  uint32_t Predict(const Slice& user_key) const;
+
+  Slice prefix_;
+  const char* suffixes_ = nullptr;
+  const char* key_offsets_ = nullptr;
+  const char* handle_offsets_ = nullptr;
+  const char* handle_sizes_ = nullptr;
+  const char* segments_ = nullptr;
+  uint32_t num_entries_ = 0;
+  uint32_t num_segments_ = 0;
+  uint32_t max_error_ = 0;
+  uint32_t flags_ = 0;
+  uint64_t base_offset_ = 0;
+};
+
+}  // namespace TERARKDB_NAMESPACE
@@ -306,4 +306,25 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
   return false;
 }
 
+void GetContext::MarkCoveredByRangeDeletion() {
+  assert(state_ == kNotFound || state_ == kMerge);
+  if (kNotFound == state_) {
+    state_ = kDeleted;
+  } else if (kMerge == state_) {
+    state_ = kFound;
+    if (LIKELY(lazy_val_ != nullptr)) {
+      Status s = MergeHelper::TimedFullMerge(
+          merge_operator_, user_key_, nullptr, merge_context_->GetOperands(),
+          lazy_val_, logger_, statistics_, env_);
+      if (s.ok()) {
+        lazy_val_->pin(LazyBufferPinLevel::Internal);
+      } else {
+        corrupt_ = std::move(s);
+        state_ = kCorrupt;
+      }
+    }
+  }
+  is_finished_ = true;
+}
+
 }  // namespace TERARKDB_NAMESPACE
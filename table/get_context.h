@@ -81,6 +81,18 @@ class GetContext {
     return seq_ != nullptr || min_seq_type_ != 0;
   }
 
+  // All versions of the key in a file whose largest sequence is below the
+  // max covering tombstone are deleted, so the file needn't be read unless
+  // the caller asks for the sequence of the most recent write
+  bool IsCoveredByRangeDeletion(SequenceNumber largest_seqno) const {
+    return seq_ == nullptr && max_covering_tombstone_seq_ != nullptr &&
+           *max_covering_tombstone_seq_ > largest_seqno;
+  }
+
+  // Older versions of the key are all covered by the tombstone too, so the
+  // lookup ends here: deleted, or the merge operands applied to no base value
+  void MarkCoveredByRangeDeletion();
+
   bool sample() const { return sample_; }
   bool is_index() const { return is_index_; }
 
@@ -46,6 +46,9 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       result = PartitionedIndexBuilder::CreateIndexBuilder(
           comparator, use_value_delta_encoding, table_opt);
     } break;
+    case BlockBasedTableOptions::kCompactIndexSearch: {
+      result = new CompactIndexBuilder(comparator, table_opt.format_version);
+    } break;
     default: {
       assert(!"Do not recognize the index type ");
     } break;
@@ -53,6 +56,18 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
   return result;
 }
 
+Status CompactIndexBuilder::Finish(
+    IndexBlocks* index_blocks,
+    const BlockHandle& /*last_partition_block_handle*/) {
+  // The model needs keys ordered as byte strings
+  bool bytewise = Slice(comparator_->user_comparator()->Name()) ==
+                  Slice(BytewiseComparator()->Name());
+  index_blocks->index_block_contents =
+      index_block_builder_.Finish(seperator_is_key_plus_seq_, bytewise);
+  index_size_ = index_blocks->index_block_contents.size();
+  return Status::OK();
+}
+
 PartitionedIndexBuilder* PartitionedIndexBuilder::CreateIndexBuilder(
     const InternalKeyComparator* comparator,
     const bool use_value_delta_encoding,
@@ -20,6 +20,7 @@
 #include "rocksdb/terark_namespace.h"
 #include "table/block_based_table_factory.h"
 #include "table/block_builder.h"
+#include "table/compact_index_block.h"
 #include "table/format.h"
 
 namespace TERARKDB_NAMESPACE {
@@ -322,6 +323,56 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// CompactIndexBuilder shortens separators like ShortenedIndexBuilder but
+// writes them to a CompactIndexBlock, a prefix stripped array of fixed width
+// entries with a learned model of key positions, instead of a BlockBuilder
+// block.
+class CompactIndexBuilder : public IndexBuilder {
+ public:
+  // Max distance between the predicted and the actual position of an entry
+  static const uint32_t kModelMaxError = 8;
+
+  explicit CompactIndexBuilder(const InternalKeyComparator* comparator,
+                               const uint32_t format_version)
+      : IndexBuilder(comparator), index_block_builder_(kModelMaxError) {
+    // Making the default true will disable the feature for old versions
+    seperator_is_key_plus_seq_ = (format_version <= 2);
+  }
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    if (first_key_in_next_block != nullptr) {
+      comparator_->FindShortestSeparator(last_key_in_current_block,
+                                         *first_key_in_next_block);
+      if (!seperator_is_key_plus_seq_ &&
+          comparator_->user_comparator()->Compare(
+              ExtractUserKey(*last_key_in_current_block),
+              ExtractUserKey(*first_key_in_next_block)) == 0) {
+        seperator_is_key_plus_seq_ = true;
+      }
+    } else {
+      comparator_->FindShortSuccessor(last_key_in_current_block);
+    }
+    index_block_builder_.Add(*last_key_in_current_block, block_handle);
+  }
+
+  using IndexBuilder::Finish;
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& /*last_partition_block_handle*/) override;
+
+  virtual size_t IndexSize() const override { return index_size_; }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return seperator_is_key_plus_seq_;
+  }
+
+ private:
+  CompactIndexBlockBuilder index_block_builder_;
+  bool seperator_is_key_plus_seq_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -3,17 +3,23 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "rocksdb/terark_namespace.h"
 #include "table/merging_iterator.h"
+#include "table/scoped_arena_iterator.h"
+#include "util/arena.h"
 #include "util/testharness.h"
 #include "util/testutil.h"
 
 namespace TERARKDB_NAMESPACE {
 
-class MergerTest : public testing::Test {
+// The parameter selects the loser tree instead of the binary heap
+class MergerTest : public testing::TestWithParam<bool> {
  public:
   MergerTest()
       : icomp_(BytewiseComparator()),
@@ -106,9 +112,9 @@ class MergerTest : public testing::Test {
       all_keys_.insert(all_keys_.end(), strings.begin(), strings.end());
     }
 
-    merging_iterator_.reset(
-        NewMergingIterator(&icomp_, &small_iterators[0],
-                           static_cast<int>(small_iterators.size())));
+    merging_iterator_.reset(NewMergingIterator(
+        &icomp_, &small_iterators[0], static_cast<int>(small_iterators.size()),
+        nullptr /* arena */, false /* prefix_seek_mode */, GetParam()));
     single_iterator_.reset(new test::VectorIterator(all_keys_));
   }
 
@@ -119,7 +125,7 @@ class MergerTest : public testing::Test {
   std::vector<std::string> all_keys_;
 };
 
-TEST_F(MergerTest, SeekToRandomNextTest) {
+TEST_P(MergerTest, SeekToRandomNextTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -128,7 +134,7 @@ TEST_F(MergerTest, SeekToRandomNextTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomNextSmallStringsTest) {
+TEST_P(MergerTest, SeekToRandomNextSmallStringsTest) {
   Generate(1000, 50, 2);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -137,7 +143,7 @@ TEST_F(MergerTest, SeekToRandomNextSmallStringsTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomPrevTest) {
+TEST_P(MergerTest, SeekToRandomPrevTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -146,7 +152,7 @@ TEST_F(MergerTest, SeekToRandomPrevTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomRandomTest) {
+TEST_P(MergerTest, SeekToRandomRandomTest) {
   Generate(200, 50, 50);
   for (int i = 0; i < 3; ++i) {
     SeekToRandom();
@@ -155,7 +161,7 @@ TEST_F(MergerTest, SeekToRandomRandomTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToFirstTest) {
+TEST_P(MergerTest, SeekToFirstTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToFirst();
@@ -164,7 +170,7 @@ TEST_F(MergerTest, SeekToFirstTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToLastTest) {
+TEST_P(MergerTest, SeekToLastTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToLast();
@@ -173,6 +179,140 @@ TEST_F(MergerTest, SeekToLastTest) {
   }
 }
 
+TEST_P(MergerTest, SeekForwardTest) {
+  // Increasing targets, so children already past a target are not moved.
+  // Two letter keys, so targets often hit keys that exist in several
+  // children.
+  Generate(100, 50, 2);
+  std::vector<std::string> targets;
+  for (int i = 0; i < 200; ++i) {
+    InternalKey ik(test::RandomHumanReadableString(&rnd_, 2), 0,
+                   ValueType::kTypeValue);
+    targets.push_back(ik.Encode().ToString(false));
+  }
+  std::sort(targets.begin(), targets.end());
+  for (int i = 0; i < 3; ++i) {
+    SeekToFirst();
+    for (auto& target : targets) {
+      Seek(target);
+      AssertEquivalence();
+      Next(rnd_.Uniform(3));
+    }
+    // Seek backward
+    Seek(targets[100]);
+    AssertEquivalence();
+    Next(10);
+  }
+}
+
+TEST_P(MergerTest, BuilderTest) {
+  // Children added one by one hold interleaved runs of 100 keys, so the same
+  // child usually produces the next key
+  Arena arena;
+  MergeIteratorBuilder builder(&icomp_, &arena, false /* prefix_seek_mode */,
+                               GetParam());
+  const int kChildren = 24;
+  const int kRun = 100;
+  std::vector<std::vector<std::string>> strings(kChildren);
+  for (int i = 0; i < kChildren * kRun * 10; ++i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%08d", i);
+    InternalKey ik(buf, 0, ValueType::kTypeValue);
+    strings[(i / kRun) % kChildren].push_back(
+        ik.Encode().ToString(false));
+    all_keys_.push_back(ik.Encode().ToString(false));
+  }
+  for (auto& s : strings) {
+    auto mem = arena.AllocateAligned(sizeof(test::VectorIterator));
+    builder.AddIterator(new (mem) test::VectorIterator(s));
+  }
+  ScopedArenaIterator iter(builder.Finish());
+  test::VectorIterator single(all_keys_);
+  for (iter->SeekToFirst(), single.SeekToFirst(); single.Valid();
+       iter->Next(), single.Next()) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(single.key().ToString(), iter->key().ToString());
+  }
+  ASSERT_FALSE(iter->Valid());
+  for (iter->SeekToLast(), single.SeekToLast(); single.Valid();
+       iter->Prev(), single.Prev()) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(single.key().ToString(), iter->key().ToString());
+  }
+  ASSERT_FALSE(iter->Valid());
+}
+
+INSTANTIATE_TEST_CASE_P(MergerTest, MergerTest, ::testing::Bool());
+
+// Counts the user key comparisons of a merge
+class CountingComparator : public Comparator {
+ public:
+  CountingComparator() : count_(0) {}
+  virtual const char* Name() const override {
+    return BytewiseComparator()->Name();
+  }
+  virtual int Compare(const Slice& a, const Slice& b) const override {
+    ++count_;
+    return BytewiseComparator()->Compare(a, b);
+  }
+  virtual void FindShortestSeparator(std::string* /*start*/,
+                                     const Slice& /*limit*/) const override {}
+  virtual void FindShortSuccessor(std::string* /*key*/) const override {}
+
+  mutable size_t count_;
+};
+
+// Merges `num_children` sorted runs where each child holds runs of
+// `run_length` consecutive keys, returns the number of comparisons
+size_t CountMergeComparisons(bool use_loser_tree, int num_children,
+                             int run_length) {
+  CountingComparator ucmp;
+  InternalKeyComparator icomp(&ucmp);
+  std::vector<std::vector<std::string>> strings(num_children);
+  for (int i = 0; i < 100000; ++i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%08d", i);
+    InternalKey ik(buf, 0, ValueType::kTypeValue);
+    strings[(i / run_length) % num_children].push_back(
+        ik.Encode().ToString(false));
+  }
+  std::vector<InternalIterator*> children;
+  for (auto& s : strings) {
+    children.push_back(new test::VectorIterator(s));
+  }
+  std::unique_ptr<InternalIterator> iter(
+      NewMergingIterator(&icomp, children.data(), num_children,
+                         nullptr /* arena */, false /* prefix_seek_mode */,
+                         use_loser_tree));
+  size_t count = 0;
+  ucmp.count_ = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  EXPECT_EQ(100000U, count);
+  return ucmp.count_;
+}
+
+TEST(MergerComparisonTest, LoserTreeVersusHeap) {
+  for (int num_children : {4, 32}) {
+    for (int run_length : {1, 100}) {
+      size_t heap = CountMergeComparisons(false, num_children, run_length);
+      size_t tree = CountMergeComparisons(true, num_children, run_length);
+      fprintf(stderr,
+              "children %2d run %3d: heap %9" ROCKSDB_PRIszt
+              " loser tree %9" ROCKSDB_PRIszt " comparisons\n",
+              num_children, run_length, heap, tree);
+      if (run_length == 1) {
+        ASSERT_LT(tree, heap);
+      } else {
+        // Both take a single comparison for most entries of a run
+        ASSERT_LT(tree, 120000U);
+        ASSERT_LT(heap, 120000U);
+      }
+    }
+  }
+}
+
 }  // namespace TERARKDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -24,6 +24,7 @@
 #include "util/arena.h"
 #include "util/autovector.h"
 #include "util/heap.h"
+#include "util/loser_tree.h"
 #include "util/stop_watch.h"
 #include "util/sync_point.h"
 
@@ -32,19 +33,30 @@ namespace TERARKDB_NAMESPACE {
 namespace {
 typedef BinaryHeap<IteratorWrapper*, MaxIteratorComparator> MergerMaxIterHeap;
 typedef BinaryHeap<IteratorWrapper*, MinIteratorComparator> MergerMinIterHeap;
+typedef LoserTree<IteratorWrapper*, MaxIteratorComparator> MergerMaxIterTree;
+typedef LoserTree<IteratorWrapper*, MinIteratorComparator> MergerMinIterTree;
 }  // namespace
 
 const size_t kNumIterReserve = 4;
 
 class MergingIterator : public InternalIterator {
  public:
-  MergingIterator(const InternalKeyComparator* comparator,
-                  InternalIterator** children, int n, bool is_arena_mode,
-                  bool prefix_seek_mode)
+  virtual void AddIterator(InternalIterator* iter) = 0;
+};
+
+// MinIterHeap and MaxIterHeap are either binary heaps or loser trees, see
+// MergerMinIterHeap and MergerMinIterTree
+template <class MinIterHeap, class MaxIterHeap>
+class MergingIteratorImpl : public MergingIterator {
+ public:
+  MergingIteratorImpl(const InternalKeyComparator* comparator,
+                      InternalIterator** children, int n, bool is_arena_mode,
+                      bool prefix_seek_mode)
       : is_arena_mode_(is_arena_mode),
         comparator_(comparator),
         current_(nullptr),
         direction_(kForward),
+        positioned_(false),
         minHeap_(comparator_),
         prefix_seek_mode_(prefix_seek_mode) {
     children_.resize(n);
@@ -68,8 +80,9 @@ class MergingIterator : public InternalIterator {
     }
   }
 
-  virtual void AddIterator(InternalIterator* iter) {
+  virtual void AddIterator(InternalIterator* iter) override {
     assert(direction_ == kForward);
+    positioned_ = false;
     children_.emplace_back(iter);
     auto new_wrapper = children_.back();
     if (new_wrapper.Valid()) {
@@ -81,7 +94,7 @@ class MergingIterator : public InternalIterator {
     }
   }
 
-  virtual ~MergingIterator() {
+  virtual ~MergingIteratorImpl() {
     for (auto& child : children_) {
       child.DeleteIter(is_arena_mode_);
     }
@@ -96,6 +109,7 @@ class MergingIterator : public InternalIterator {
   virtual void SeekToFirst() override {
     ClearHeaps();
     status_ = Status::OK();
+    positioned_ = true;
     for (auto& child : children_) {
       child.SeekToFirst();
       if (child.Valid()) {
@@ -113,6 +127,7 @@ class MergingIterator : public InternalIterator {
     ClearHeaps();
     InitMaxHeap();
     status_ = Status::OK();
+    positioned_ = true;
     for (auto& child : children_) {
       child.SeekToLast();
       if (child.Valid()) {
@@ -127,9 +142,27 @@ class MergingIterator : public InternalIterator {
   }
 
   virtual void Seek(const Slice& target) override {
+    // Moving forward past key(), every entry a child has already passed is
+    // at or before key() and so before target. Children at or after target
+    // are where a seek would put them and exhausted children stay exhausted,
+    // so only the children before target have to move. Prefix seek may leave
+    // children invalid at a prefix boundary, so they all seek there.
+    bool forward = positioned_ && direction_ == kForward &&
+                   current_ != nullptr && status_.ok() && !prefix_seek_mode_ &&
+                   comparator_->Compare(target, current_->key()) > 0;
     ClearHeaps();
     status_ = Status::OK();
+    positioned_ = true;
     for (auto& child : children_) {
+      if (forward && !child.Valid() && child.status().ok()) {
+        continue;
+      }
+      if (forward && child.Valid() &&
+          comparator_->Compare(child.key(), target) >= 0) {
+        PERF_TIMER_GUARD(seek_min_heap_time);
+        minHeap_.push(&child);
+        continue;
+      }
       {
         PERF_TIMER_GUARD(seek_child_seek_time);
         child.Seek(target);
@@ -155,6 +188,7 @@ class MergingIterator : public InternalIterator {
     ClearHeaps();
     InitMaxHeap();
     status_ = Status::OK();
+    positioned_ = true;
 
     for (auto& child : children_) {
       {
@@ -301,12 +335,15 @@ class MergingIterator : public InternalIterator {
   // Which direction is the iterator moving?
   enum Direction { kForward, kReverse };
   Direction direction_;
-  MergerMinIterHeap minHeap_;
+  // All children were positioned by a seek of this iterator, so in the
+  // forward direction they are at or after key()
+  bool positioned_;
+  MinIterHeap minHeap_;
   bool prefix_seek_mode_;
 
   // Max heap is used for reverse iteration, which is way less common than
   // forward.  Lazily initialize it to save memory.
-  std::unique_ptr<MergerMaxIterHeap> maxHeap_;
+  std::unique_ptr<MaxIterHeap> maxHeap_;
 
   void SwitchToForward();
 
@@ -322,7 +359,8 @@ class MergingIterator : public InternalIterator {
   }
 };
 
-void MergingIterator::SwitchToForward() {
+template <class MinIterHeap, class MaxIterHeap>
+void MergingIteratorImpl<MinIterHeap, MaxIterHeap>::SwitchToForward() {
   // Otherwise, advance the non-current children.  We advance current_
   // just after the if-block.
   ClearHeaps();
@@ -343,43 +381,69 @@ void MergingIterator::SwitchToForward() {
   direction_ = kForward;
 }
 
-void MergingIterator::ClearHeaps() {
+template <class MinIterHeap, class MaxIterHeap>
+void MergingIteratorImpl<MinIterHeap, MaxIterHeap>::ClearHeaps() {
   minHeap_.clear();
   if (maxHeap_) {
     maxHeap_->clear();
   }
 }
 
-void MergingIterator::InitMaxHeap() {
+template <class MinIterHeap, class MaxIterHeap>
+void MergingIteratorImpl<MinIterHeap, MaxIterHeap>::InitMaxHeap() {
   if (!maxHeap_) {
-    maxHeap_.reset(new MergerMaxIterHeap(comparator_));
+    maxHeap_.reset(new MaxIterHeap(comparator_));
   }
 }
 
+namespace {
+typedef MergingIteratorImpl<MergerMinIterHeap, MergerMaxIterHeap>
+    HeapMergingIterator;
+typedef MergingIteratorImpl<MergerMinIterTree, MergerMaxIterTree>
+    LoserTreeMergingIterator;
+
+template <class Impl>
+MergingIterator* NewMergingIteratorImpl(const InternalKeyComparator* cmp,
+                                        InternalIterator** list, int n,
+                                        Arena* arena, bool prefix_seek_mode) {
+  if (arena == nullptr) {
+    return new Impl(cmp, list, n, false, prefix_seek_mode);
+  } else {
+    auto mem = arena->AllocateAligned(sizeof(Impl));
+    return new (mem) Impl(cmp, list, n, true, prefix_seek_mode);
+  }
+}
+}  // namespace
+
 InternalIterator* NewMergingIterator(const InternalKeyComparator* cmp,
                                      InternalIterator** list, int n,
-                                     Arena* arena, bool prefix_seek_mode) {
+                                     Arena* arena, bool prefix_seek_mode,
+                                     bool use_loser_tree) {
   assert(n >= 0);
   if (n == 0) {
     return NewEmptyInternalIterator<LazyBuffer>(arena);
   } else if (n == 1) {
     return list[0];
+  } else if (use_loser_tree) {
+    return NewMergingIteratorImpl<LoserTreeMergingIterator>(
+        cmp, list, n, arena, prefix_seek_mode);
   } else {
-    if (arena == nullptr) {
-      return new MergingIterator(cmp, list, n, false, prefix_seek_mode);
-    } else {
-      auto mem = arena->AllocateAligned(sizeof(MergingIterator));
-      return new (mem) MergingIterator(cmp, list, n, true, prefix_seek_mode);
-    }
+    return NewMergingIteratorImpl<HeapMergingIterator>(cmp, list, n, arena,
+                                                       prefix_seek_mode);
   }
 }
 
 MergeIteratorBuilder::MergeIteratorBuilder(
-    const InternalKeyComparator* comparator, Arena* a, bool prefix_seek_mode)
+    const InternalKeyComparator* comparator, Arena* a, bool prefix_seek_mode,
+    bool use_loser_tree)
     : first_iter(nullptr), use_merging_iter(false), arena(a) {
-  auto mem = arena->AllocateAligned(sizeof(MergingIterator));
-  merge_iter =
-      new (mem) MergingIterator(comparator, nullptr, 0, true, prefix_seek_mode);
+  if (use_loser_tree) {
+    merge_iter = NewMergingIteratorImpl<LoserTreeMergingIterator>(
+        comparator, nullptr, 0, arena, prefix_seek_mode);
+  } else {
+    merge_iter = NewMergingIteratorImpl<HeapMergingIterator>(
+        comparator, nullptr, 0, arena, prefix_seek_mode);
+  }
 }
 
 MergeIteratorBuilder::~MergeIteratorBuilder() {
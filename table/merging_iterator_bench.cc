@@ -0,0 +1,148 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/env.h"
+#include "rocksdb/terark_namespace.h"
+#include "table/merging_iterator.h"
+#include "util/gflags_compat.h"
+#include "util/random.h"
+#include "util/stop_watch.h"
+#include "util/testutil.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+
+DEFINE_int32(num_keys, 1000000, "number of keys in all children together");
+
+DEFINE_int32(num_children, 32, "number of merged child iterators");
+
+DEFINE_int32(run_length, 100,
+             "average number of consecutive keys that come from the same "
+             "child, 1 spreads keys uniformly over the children");
+
+DEFINE_int32(key_size, 16, "size of each user key");
+
+DEFINE_int32(num_runs, 10, "number of test runs");
+
+DEFINE_bool(reverse, false, "iterate with SeekToLast() and Prev()");
+
+DEFINE_int32(seed, 0, "random number generator seed");
+
+namespace TERARKDB_NAMESPACE {
+
+namespace {
+
+// Big-endian, zero padded to FLAGS_key_size so bytewise order is numeric
+std::string UserKey(uint64_t val) {
+  std::string key(std::max(FLAGS_key_size, 8), '\0');
+  for (size_t i = 0; i < 8; ++i) {
+    key[key.size() - 1 - i] = static_cast<char>(val >> (i * 8));
+  }
+  return key;
+}
+
+class CountingComparator : public Comparator {
+ public:
+  virtual const char* Name() const override {
+    return BytewiseComparator()->Name();
+  }
+  virtual int Compare(const Slice& a, const Slice& b) const override {
+    ++count;
+    return BytewiseComparator()->Compare(a, b);
+  }
+  virtual void FindShortestSeparator(std::string* /*start*/,
+                                     const Slice& /*limit*/) const override {}
+  virtual void FindShortSuccessor(std::string* /*key*/) const override {}
+
+  mutable uint64_t count = 0;
+};
+
+void Run(const char* name, bool use_loser_tree,
+         const std::vector<std::vector<std::string>>& children) {
+  CountingComparator ucmp;
+  InternalKeyComparator icmp(&ucmp);
+  uint64_t total_nanos = 0;
+  uint64_t num_output = 0;
+  for (int run = 0; run < FLAGS_num_runs; ++run) {
+    std::vector<InternalIterator*> list;
+    for (auto& keys : children) {
+      list.push_back(new test::VectorIterator(keys));
+    }
+    std::unique_ptr<InternalIterator> iter(NewMergingIterator(
+        &icmp, list.data(), static_cast<int>(list.size()), nullptr /* arena */,
+        false /* prefix_seek_mode */, use_loser_tree));
+
+    StopWatchNano timer(Env::Default(), true /* auto_start */);
+    if (FLAGS_reverse) {
+      for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+        ++num_output;
+      }
+    } else {
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ++num_output;
+      }
+    }
+    total_nanos += timer.ElapsedNanos();
+  }
+
+  double n = std::max<double>(num_output, 1);
+  std::cout << std::left << std::setw(25) << name << "\n"
+            << std::setw(25) << "  Output entries: "
+            << num_output / std::max(FLAGS_num_runs, 1) << "\n"
+            << std::setw(25) << "  Time per entry: " << total_nanos / n
+            << " ns\n"
+            << std::setw(25) << "  Compares per entry: " << ucmp.count / n
+            << "\n";
+}
+
+}  // anonymous namespace
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  using namespace TERARKDB_NAMESPACE;
+
+  // Keys are dealt to the children in runs of geometrically distributed
+  // length with mean FLAGS_run_length
+  Random64 rnd(FLAGS_seed);
+  int num_children = std::max(FLAGS_num_children, 1);
+  int run_length = std::max(FLAGS_run_length, 1);
+  std::vector<std::vector<std::string>> children(num_children);
+  size_t child = 0;
+  for (int i = 0; i < FLAGS_num_keys; ++i) {
+    if (rnd.OneIn(run_length)) {
+      child = rnd.Uniform(num_children);
+    }
+    children[child].emplace_back(
+        InternalKey(UserKey(i), 1, kTypeValue).Encode().ToString());
+  }
+
+  std::cout << std::left << std::setw(25) << "Children: " << num_children
+            << "\n"
+            << std::setw(25) << "Run length: " << run_length << "\n";
+  Run("Binary heap", false, children);
+  Run("Loser tree", true, children);
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -8,6 +8,7 @@
 #include "rocksdb/terark_namespace.h"
 #include "table/block_based_table_reader.h"
 #include "table/format.h"
+#include "util/mutexlock.h"
 
 namespace TERARKDB_NAMESPACE {
 
@@ -112,4 +113,55 @@ Status PersistentCacheHelper::LookupUncompressedPage(
   return Status::OK();
 }
 
+PersistentCacheAdmissionQueue::PersistentCacheAdmissionQueue(
+    std::shared_ptr<PersistentCache> persistent_cache,
+    size_t max_pending_bytes)
+    : persistent_cache_(std::move(persistent_cache)),
+      max_pending_bytes_(max_pending_bytes),
+      cv_(&mutex_),
+      pending_bytes_(0),
+      shutdown_(false) {
+  thread_ = port::Thread(&PersistentCacheAdmissionQueue::BGThread, this);
+}
+
+PersistentCacheAdmissionQueue::~PersistentCacheAdmissionQueue() {
+  {
+    MutexLock l(&mutex_);
+    shutdown_ = true;
+    cv_.Signal();
+  }
+  thread_.join();
+}
+
+void PersistentCacheAdmissionQueue::Add(const Slice& key, const Slice& data) {
+  MutexLock l(&mutex_);
+  if (shutdown_ || pending_bytes_ + data.size() > max_pending_bytes_) {
+    return;
+  }
+  pending_bytes_ += data.size();
+  queue_.emplace_back(key.ToString(), data.ToString());
+  if (queue_.size() == 1) {
+    cv_.Signal();
+  }
+}
+
+void PersistentCacheAdmissionQueue::BGThread() {
+  MutexLock l(&mutex_);
+  while (true) {
+    while (queue_.empty() && !shutdown_) {
+      cv_.Wait();
+    }
+    if (queue_.empty()) {
+      break;
+    }
+    auto block = std::move(queue_.front());
+    queue_.pop_front();
+    mutex_.Unlock();
+    persistent_cache_->Insert(block.first, block.second.data(),
+                              block.second.size());
+    mutex_.Lock();
+    pending_bytes_ -= block.second.size();
+  }
+}
+
 }  // namespace TERARKDB_NAMESPACE
@@ -4,9 +4,14 @@
 //  (found in the LICENSE.Apache file in the root directory).
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "monitoring/statistics.h"
+#include "port/port.h"
+#include "rocksdb/persistent_cache.h"
 #include "rocksdb/terark_namespace.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
@@ -42,4 +47,34 @@ class PersistentCacheHelper {
       BlockContents* contents);
 };
 
+// Inserts blocks into a persistent cache from a background thread, so the
+// thread that evicts them from the block cache only copies them. Blocks
+// added while more than `max_pending_bytes` are queued are dropped.
+class PersistentCacheAdmissionQueue {
+ public:
+  PersistentCacheAdmissionQueue(
+      std::shared_ptr<PersistentCache> persistent_cache,
+      size_t max_pending_bytes);
+  // Inserts the blocks still queued before returning
+  ~PersistentCacheAdmissionQueue();
+
+  PersistentCacheAdmissionQueue(const PersistentCacheAdmissionQueue&) = delete;
+  PersistentCacheAdmissionQueue& operator=(
+      const PersistentCacheAdmissionQueue&) = delete;
+
+  void Add(const Slice& key, const Slice& data);
+
+ private:
+  void BGThread();
+
+  const std::shared_ptr<PersistentCache> persistent_cache_;
+  const size_t max_pending_bytes_;
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  std::deque<std::pair<std::string, std::string>> queue_;
+  size_t pending_bytes_;
+  bool shutdown_;
+  port::Thread thread_;
+};
+
 }  // namespace TERARKDB_NAMESPACE
@@ -30,6 +30,8 @@ struct PersistentCacheOptions {
   std::shared_ptr<PersistentCache> persistent_cache;
   std::string key_prefix;
   Statistics* statistics = nullptr;
+  // False if the cache is filled with blocks evicted from the block cache
+  bool insert_on_read = true;
 };
 
 }  // namespace TERARKDB_NAMESPACE
@@ -5,14 +5,20 @@
 
 #include "rocksdb/sst_file_writer.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <vector>
 
 #include "db/dbformat.h"
 #include "rocksdb/table.h"
 #include "rocksdb/terark_namespace.h"
 #include "table/block_based_table_builder.h"
+#include "port/port.h"
 #include "table/sst_file_writer_collectors.h"
+#include "util/coding.h"
 #include "util/file_reader_writer.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 
 namespace TERARKDB_NAMESPACE {
@@ -307,6 +313,238 @@ Status SstFileWriter::Finish(ExternalSstFileInfo* file_info) {
 }
 
 uint64_t SstFileWriter::FileSize() { return rep_->file_info.file_size; }
+
+struct SstFileBulkLoader::Rep {
+  // Entries of one output file, each encoded as a ValueType byte followed by
+  // the length prefixed user key and value
+  struct Batch {
+    size_t index;
+    std::string data;
+  };
+
+  Rep(const EnvOptions& _env_options, const Options& _options,
+      const SstFileBulkLoaderOptions& _bulk_load_options,
+      ColumnFamilyHandle* _cfh)
+      : env_options(_env_options),
+        options(_options),
+        bulk_load_options(_bulk_load_options),
+        cfh(_cfh),
+        closing(false) {
+    size_t num_threads = std::max<size_t>(bulk_load_options.num_threads, 1);
+    if (bulk_load_options.max_pending_files == 0) {
+      bulk_load_options.max_pending_files = num_threads;
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back(&Rep::BGWork, this);
+    }
+  }
+
+  ~Rep() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.clear();
+    }
+    JoinThreads();
+    if (!finished) {
+      DeleteFiles();
+    }
+  }
+
+  EnvOptions env_options;
+  Options options;
+  SstFileBulkLoaderOptions bulk_load_options;
+  ColumnFamilyHandle* cfh;
+  std::vector<port::Thread> threads;
+
+  // Owned by the caller's thread
+  std::unique_ptr<Batch> batch;
+  size_t num_batches = 0;
+  std::string last_key;
+  Status status;
+  bool finished = false;
+
+  // Guarded by mutex
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::unique_ptr<Batch>> pending;
+  std::vector<ExternalSstFileInfo> files;
+  Status bg_status;
+  bool closing;
+
+  Status Add(const Slice& user_key, const Slice& value,
+             const ValueType value_type) {
+    if (!status.ok()) {
+      return status;
+    }
+    if (finished) {
+      return Status::InvalidArgument("Bulk load is finished");
+    }
+    if (num_batches > 0) {
+      if (options.comparator->Compare(user_key, last_key) <= 0) {
+        return Status::InvalidArgument("Keys must be added in order");
+      }
+    }
+    if (!batch) {
+      batch.reset(new Batch{num_batches++, std::string()});
+    }
+    batch->data.push_back(static_cast<char>(value_type));
+    PutLengthPrefixedSlice(&batch->data, user_key);
+    PutLengthPrefixedSlice(&batch->data, value);
+    last_key.assign(user_key.data(), user_key.size());
+
+    if (batch->data.size() >= bulk_load_options.target_file_size) {
+      status = Submit();
+    }
+    return status;
+  }
+
+  // Hand the current batch to the builders, waits while too many batches
+  // are pending
+  Status Submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] {
+      return pending.size() < bulk_load_options.max_pending_files ||
+             !bg_status.ok();
+    });
+    if (!bg_status.ok()) {
+      batch.reset();
+      return bg_status;
+    }
+    files.resize(batch->index + 1);
+    pending.emplace_back(std::move(batch));
+    cv.notify_all();
+    return Status::OK();
+  }
+
+  void BGWork() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [this] { return !pending.empty() || closing; });
+      if (pending.empty()) {
+        return;
+      }
+      std::unique_ptr<Batch> work = std::move(pending.front());
+      pending.pop_front();
+      cv.notify_all();
+      if (!bg_status.ok()) {
+        continue;
+      }
+      lock.unlock();
+
+      ExternalSstFileInfo file_info;
+      Status s = Build(*work, &file_info);
+
+      lock.lock();
+      if (s.ok()) {
+        files[work->index] = std::move(file_info);
+      } else if (bg_status.ok()) {
+        bg_status = s;
+      }
+      cv.notify_all();
+    }
+  }
+
+  Status Build(const Batch& work, ExternalSstFileInfo* file_info) {
+    SstFileWriter writer(env_options, options, cfh);
+    Status s = writer.Open(bulk_load_options.path + "/" +
+                           bulk_load_options.file_prefix +
+                           ToString(work.index) + ".sst");
+    Slice input(work.data);
+    Slice user_key, value;
+    while (s.ok() && !input.empty()) {
+      auto value_type = static_cast<ValueType>(input[0]);
+      input.remove_prefix(1);
+      if (!GetLengthPrefixedSlice(&input, &user_key) ||
+          !GetLengthPrefixedSlice(&input, &value)) {
+        return Status::Corruption("Bad bulk load batch");
+      }
+      switch (value_type) {
+        case kTypeValue:
+          s = writer.Put(user_key, value);
+          break;
+        case kTypeMerge:
+          s = writer.Merge(user_key, value);
+          break;
+        default:
+          assert(value_type == kTypeDeletion);
+          s = writer.Delete(user_key);
+          break;
+      }
+    }
+    if (s.ok()) {
+      s = writer.Finish(file_info);
+    }
+    return s;
+  }
+
+  void JoinThreads() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closing = true;
+      cv.notify_all();
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    threads.clear();
+  }
+
+  void DeleteFiles() {
+    for (auto& file_info : files) {
+      if (!file_info.file_path.empty()) {
+        options.env->DeleteFile(file_info.file_path);
+      }
+    }
+    files.clear();
+  }
+};
+
+SstFileBulkLoader::SstFileBulkLoader(
+    const EnvOptions& env_options, const Options& options,
+    const SstFileBulkLoaderOptions& bulk_load_options,
+    ColumnFamilyHandle* column_family)
+    : rep_(new Rep(env_options, options, bulk_load_options, column_family)) {}
+
+SstFileBulkLoader::~SstFileBulkLoader() {}
+
+Status SstFileBulkLoader::Put(const Slice& user_key, const Slice& value) {
+  return rep_->Add(user_key, value, ValueType::kTypeValue);
+}
+
+Status SstFileBulkLoader::Merge(const Slice& user_key, const Slice& value) {
+  return rep_->Add(user_key, value, ValueType::kTypeMerge);
+}
+
+Status SstFileBulkLoader::Delete(const Slice& user_key) {
+  return rep_->Add(user_key, Slice(), ValueType::kTypeDeletion);
+}
+
+Status SstFileBulkLoader::Finish(std::vector<ExternalSstFileInfo>* file_info) {
+  Rep* r = rep_.get();
+  if (r->finished) {
+    return Status::InvalidArgument("Bulk load is finished");
+  }
+  if (r->status.ok() && r->batch) {
+    r->status = r->Submit();
+  }
+  r->JoinThreads();
+  if (r->status.ok()) {
+    r->status = r->bg_status;
+  }
+  if (r->status.ok() && r->files.empty()) {
+    r->status = Status::InvalidArgument("Cannot bulk load with no entries");
+  }
+  if (!r->status.ok()) {
+    r->DeleteFiles();
+    return r->status;
+  }
+  r->finished = true;
+  if (file_info != nullptr) {
+    *file_info = std::move(r->files);
+  }
+  r->files.clear();
+  return Status::OK();
+}
 #endif  // !ROCKSDB_LITE
 
 }  // namespace TERARKDB_NAMESPACE
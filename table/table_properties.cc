@@ -235,6 +235,10 @@ const std::string TablePropertiesNames::kEarliestTimeBeginCompact =
     "rocksdb.compact.earliest-time-begin";
 const std::string TablePropertiesNames::kLatestTimeEndCompact =
     "rocksdb.compact.latest-time-end";
+const std::string TablePropertiesNames::kLatestTimeExpire =
+    "rocksdb.ttl.latest-time-expire";
+const std::string TablePropertiesNames::kEarliestTimeExpire =
+    "rocksdb.ttl.earliest-time-expire";
 
 extern const std::string kPropertiesBlock = "rocksdb.properties";
 // Old property block name for backward compatibility
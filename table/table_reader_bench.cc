@@ -247,6 +247,13 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
       for_iterator ? "iterator" : (if_query_empty_keys ? "empty" : "non_empty"),
       measured_by_nanosecond ? "nanosecond" : "microsecond",
       hist.ToString().c_str());
+  if (!through_db) {
+    fprintf(stderr,
+            "Index size: %" PRIu64 "   Table reader memory: %" ROCKSDB_PRIszt
+            "\n",
+            table_reader->GetTableProperties()->index_size,
+            table_reader->ApproximateMemoryUsage());
+  }
   if (!through_db) {
     env->DeleteFile(file_name);
   } else {
@@ -274,6 +281,9 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_bool(compact_index, false,
+            "Use kCompactIndexSearch instead of kBinarySearch for "
+            "`block_based` tables");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -323,7 +333,12 @@ int main(int argc, char** argv) {
     exit(1);
 #endif  // ROCKSDB_LITE
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new TERARKDB_NAMESPACE::BlockBasedTableFactory());
+    TERARKDB_NAMESPACE::BlockBasedTableOptions table_options;
+    if (FLAGS_compact_index) {
+      table_options.index_type =
+          TERARKDB_NAMESPACE::BlockBasedTableOptions::kCompactIndexSearch;
+    }
+    tf.reset(new TERARKDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
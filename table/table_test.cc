@@ -1728,6 +1728,102 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, CompactIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kCompactIndexSearch;
+  IndexTest(table_options);
+}
+
+// Seek through a compact index with many blocks and keys of different
+// distributions, the results must match the binary search index
+TEST_P(BlockBasedTableTest, CompactIndexSeek) {
+  Random rnd(301);
+  for (int dist = 0; dist < 3; ++dist) {
+    std::vector<std::string> user_keys;
+    for (int i = 0; i < 2000; ++i) {
+      char buf[32];
+      if (dist == 0) {
+        // dense numbers behind a shared prefix
+        snprintf(buf, sizeof(buf), "user%08d", i * 3);
+        user_keys.push_back(buf);
+      } else if (dist == 1) {
+        // skewed
+        snprintf(buf, sizeof(buf), "%016" PRIx64, uint64_t(i) * i * i);
+        user_keys.push_back(buf);
+      } else {
+        user_keys.push_back(RandomString(&rnd, 4 + rnd.Uniform(12)));
+      }
+    }
+
+    std::vector<std::string> targets;
+    for (auto& user_key : user_keys) {
+      targets.push_back(user_key);
+      targets.push_back(user_key + "0");
+      std::string before = user_key;
+      before.back()--;
+      targets.push_back(before);
+    }
+    targets.push_back("");
+    targets.push_back("\xff\xff");
+
+    std::vector<std::string> results[2];
+    for (int compact = 0; compact < 2; ++compact) {
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.block_size = 64;
+      table_options.index_type =
+          compact ? BlockBasedTableOptions::kCompactIndexSearch
+                  : BlockBasedTableOptions::kBinarySearch;
+      Options options;
+      options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+      TableConstructor c(BytewiseComparator(),
+                         true /* convert_to_internal_key_ */);
+      for (auto& user_key : user_keys) {
+        c.Add(user_key, "value" + user_key);
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      const ImmutableCFOptions ioptions(options);
+      const MutableCFOptions moptions(options);
+      c.Finish(options, ioptions, moptions, table_options,
+               GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+      auto* reader = c.GetTableReader();
+      ASSERT_GT(reader->GetTableProperties()->num_data_blocks, 100u);
+
+      std::unique_ptr<InternalIterator> iter(
+          reader->NewIterator(ReadOptions(), moptions.prefix_extractor.get()));
+      for (auto& target : targets) {
+        InternalKey internal_target(target, kMaxSequenceNumber, kTypeValue);
+        iter->Seek(internal_target.Encode());
+        ASSERT_OK(iter->status());
+        results[compact].push_back(
+            iter->Valid() ? ExtractUserKey(iter->key()).ToString() : "<end>");
+      }
+      size_t count = 0;
+      for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+        ++count;
+      }
+      ASSERT_EQ(kvmap.size(), count);
+
+      for (auto& kv : kvmap) {
+        LazyBuffer value;
+        GetContext get_context(options.comparator, nullptr, nullptr, nullptr,
+                               GetContext::kNotFound, kv.first, &value,
+                               nullptr, nullptr, nullptr, nullptr, nullptr,
+                               nullptr);
+        InternalKey internal_key(kv.first, kMaxSequenceNumber, kTypeValue);
+        ASSERT_OK(reader->Get(ReadOptions(), internal_key.Encode(),
+                              &get_context, moptions.prefix_extractor.get()));
+        ASSERT_EQ(GetContext::kFound, get_context.State());
+        ASSERT_OK(value.fetch());
+        ASSERT_EQ(kv.second, value.ToString());
+      }
+      c.ResetTableReader();
+    }
+    ASSERT_EQ(results[0], results[1]);
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -26,8 +26,10 @@
 #include <sys/types.h>
 
 #include <atomic>
+#include <cmath>
 #include <condition_variable>
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -55,6 +57,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/terark_namespace.h"
+#include "rocksdb/ttl_extractor.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "rocksdb/utilities/options_util.h"
@@ -189,7 +192,16 @@ DEFINE_string(
     "\trandomreplacekeys     -- randomly replaces N keys by deleting "
     "the old version and putting the new version\n\n"
     "\ttimeseries            -- 1 writer generates time series data "
-    "and multiple readers doing random reads on id\n\n"
+    "and multiple readers doing random reads on id\n"
+    "\tupdaterandom_kvsep    -- N threads overwriting zipfian keys, meant "
+    "for values larger than --blob_size, reports write amplification of "
+    "flush, compaction and blob GC and the blob garbage ratio\n"
+    "\tscan_lazy             -- N threads doing seeks followed by "
+    "--lazy_scan_length Next() calls, reports the read amplification of the "
+    "map SSTs left by lazy compaction\n"
+    "\ttimeseries_ttl        -- 1 writer appending entries that expire "
+    "after --ttl_seconds and N-1 threads doing random reads, reports the "
+    "same as updaterandom_kvsep\n\n"
     "Meta operations:\n"
     "\tcompact     -- Compact the entire DB; If multiple, randomly choose one\n"
     "\tcompactall  -- Compact the entire DB\n"
@@ -385,6 +397,11 @@ DEFINE_int32(max_background_flushes,
              "The maximum number of concurrent background flushes"
              " that can occur in parallel.");
 
+DEFINE_bool(adaptive_background_scheduling,
+            TERARKDB_NAMESPACE::Options().adaptive_background_scheduling,
+            "Let background jobs run on idle threads of other priority pools "
+            "and adjust compaction concurrency to the device throughput");
+
 static TERARKDB_NAMESPACE::CompactionStyle FLAGS_compaction_style_e;
 DEFINE_int32(compaction_style,
              (int32_t)TERARKDB_NAMESPACE::Options().compaction_style,
@@ -569,6 +586,10 @@ DEFINE_bool(read_cache_direct_write, true,
 DEFINE_bool(read_cache_direct_read, true,
             "Whether to use Direct IO for reading from read cache");
 
+DEFINE_bool(read_cache_admit_evicted, false,
+            "Fill the read cache with blocks evicted from the block cache "
+            "instead of blocks read from the SST files");
+
 DEFINE_bool(use_keep_filter, false, "Whether to use a noop compaction filter");
 
 static bool ValidateCacheNumshardbits(const char* flagname, int32_t value) {
@@ -677,6 +698,10 @@ DEFINE_bool(optimize_filters_for_hits, false,
             "a value. For now this doesn't create bloom filters for the max "
             "level of the LSM to reduce metadata that should fit in RAM. ");
 
+DEFINE_bool(use_loser_tree_merging_iterator, false,
+            "Merge the memtables and sst files of reads, flushes and "
+            "compactions with a loser tree instead of a binary heap");
+
 DEFINE_bool(optimize_range_deletion, false,
             "Optimizes RangeDeletion when use lazy level compaction");
 
@@ -894,6 +919,11 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
               "Limited bytes allowed to DB when soft_rate_limit or "
               "level0_slowdown_writes_trigger triggers");
 
+DEFINE_bool(adaptive_write_throttling,
+            TERARKDB_NAMESPACE::Options().adaptive_write_throttling,
+            "Throttle writes with a feedback loop on flush, compaction and "
+            "garbage collection debt instead of stepwise slowdowns");
+
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
@@ -985,6 +1015,32 @@ DEFINE_uint64(max_dependence_blob_overlap, 1024, "Max dependence blob overlap");
 
 DEFINE_uint64(maintainer_job_ratio, 0.1, "Maintainer job ratio");
 
+DEFINE_string(compaction_separation_type, "trans_to_separate",
+              "Key value separation of the compact and compactall "
+              "benchmarks: trans_to_separate, ignore_separate, "
+              "auto_rebuild_blob, force_rebuild_blob or combine_value");
+static auto FLAGS_compaction_separation_type_e =
+    TERARKDB_NAMESPACE::kCompactionTransToSeparate;
+
+DEFINE_double(zipf_theta, 0.99,
+              "Skew of the zipfian key distribution, in (0, 1) (used in "
+              "updaterandom_kvsep only)");
+
+DEFINE_int32(lazy_scan_length, 100,
+             "Number of Next() calls after each seek (used in scan_lazy "
+             "only)");
+
+DEFINE_uint64(ttl_seconds, 3600,
+              "Time to live of the entries written by timeseries_ttl");
+
+DEFINE_double(ttl_gc_ratio, TERARKDB_NAMESPACE::Options().ttl_gc_ratio,
+              "Ratio of expired entries that marks an SST for compaction");
+
+DEFINE_int32(separation_stats_interval, 10,
+             "Seconds between two reports of the blob garbage ratio while "
+             "updaterandom_kvsep, scan_lazy or timeseries_ttl run, 0 to "
+             "disable");
+
 DEFINE_uint64(wal_ttl_seconds, 0, "Set the TTL for the WAL Files in seconds.");
 DEFINE_uint64(wal_size_limit_MB, 0,
               "Set the size limit for the WAL Files"
@@ -1156,6 +1212,10 @@ DEFINE_bool(use_hash_search, false,
             "if use kHashSearch "
             "instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(compact_index, false,
+            "if use kCompactIndexSearch "
+            "instead of kBinarySearch. "
+            "This is valid if only we use BlockTable");
 DEFINE_bool(use_block_based_filter, false,
             "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
@@ -1389,6 +1449,79 @@ class RandomGenerator {
   }
 };
 
+// Draws integers in [0, n) from a zipfian distribution, the way YCSB does.
+// 0 is the most popular one.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta)
+      : n_(std::max<uint64_t>(n, 2)), theta_(theta) {
+    zetan_ = Zeta(n_, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1 - std::pow(2.0 / n_, 1 - theta_)) /
+           (1 - Zeta(2, theta_) / zetan_);
+    second_ = 1 + std::pow(0.5, theta_);
+  }
+
+  uint64_t Next(Random64* rand) const {
+    double u = static_cast<double>(rand->Next() >> 11) / (uint64_t(1) << 53);
+    double uz = u * zetan_;
+    if (uz < 1) {
+      return 0;
+    }
+    if (uz < second_) {
+      return 1;
+    }
+    auto value =
+        static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+    return std::min(value, n_ - 1);
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; ++i) {
+      sum += 1 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  uint64_t n_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+  double second_;
+};
+
+// Value layout of timeseries_ttl: the payload followed by the fixed64
+// expiry time in seconds
+class BenchTtlExtractor : public TtlExtractor {
+ public:
+  Status Extract(EntryType entry_type, const Slice& /*user_key*/,
+                 const Slice& value_or_meta, bool* has_ttl,
+                 uint64_t* ttl_time_point) const override {
+    *has_ttl = (entry_type == kEntryPut || entry_type == kEntryMerge) &&
+               value_or_meta.size() >= sizeof(uint64_t);
+    if (*has_ttl) {
+      *ttl_time_point = DecodeFixed64(value_or_meta.data() +
+                                      value_or_meta.size() - sizeof(uint64_t));
+    }
+    return Status::OK();
+  }
+};
+
+class BenchTtlExtractorFactory : public TtlExtractorFactory {
+ public:
+  std::unique_ptr<TtlExtractor> CreateTtlExtractor(
+      const TtlContext& /*context*/) const override {
+    return std::unique_ptr<TtlExtractor>(new BenchTtlExtractor());
+  }
+
+  uint64_t Now() const override { return FLAGS_env->NowMicros() / 1000000; }
+
+  const char* Name() const override { return "BenchTtlExtractorFactory"; }
+};
+
 static void AppendWithSpace(std::string* str, Slice msg) {
   if (msg.empty()) return;
   if (!str->empty()) {
@@ -2079,6 +2212,19 @@ class Benchmark {
   int64_t merge_keys_;
   bool report_file_operations_;
 
+  // Bytes written by flush, compaction and blob GC, and the blob garbage
+  // ratio, see GetSeparationStats()
+  struct SeparationStats {
+    uint64_t flush_bytes = 0;
+    uint64_t compaction_bytes = 0;
+    uint64_t gc_bytes = 0;
+    double garbage_ratio = 0;
+  };
+  SeparationStats separation_baseline_;
+  std::atomic<uint64_t> separation_user_bytes_{0};
+  std::unique_ptr<ZipfianGenerator> zipf_;
+  std::atomic<int64_t> ttl_keys_written_{0};
+
   class ErrorHandlerListener : public EventListener {
    public:
     ErrorHandlerListener()
@@ -2763,6 +2909,35 @@ class Benchmark {
         method = &Benchmark::ReadRandomMergeRandom;
       } else if (name == "updaterandom") {
         method = &Benchmark::UpdateRandom;
+      } else if (name == "updaterandom_kvsep") {
+        if (FLAGS_zipf_theta <= 0 || FLAGS_zipf_theta >= 1) {
+          fprintf(stderr, "--zipf_theta must be in (0, 1)\n");
+          exit(1);
+        }
+        if (static_cast<uint64_t>(value_size_) < FLAGS_blob_size) {
+          fprintf(stdout,
+                  "WARNING: --value_size is below --blob_size, values will "
+                  "not be separated\n");
+        }
+        zipf_.reset(new ZipfianGenerator(FLAGS_num, FLAGS_zipf_theta));
+        method = &Benchmark::UpdateRandomKVSep;
+        post_process_method = &Benchmark::ReportSeparationStats;
+      } else if (name == "scan_lazy") {
+        if (!FLAGS_enable_lazy_compaction) {
+          fprintf(stdout,
+                  "WARNING: --enable_lazy_compaction is off, there will be "
+                  "no map SSTs\n");
+        }
+        method = &Benchmark::ScanLazy;
+        post_process_method = &Benchmark::ReportSeparationStats;
+      } else if (name == "timeseries_ttl") {
+        // Stays set for the benchmarks on this db that follow
+        open_options_.ttl_extractor_factory =
+            std::make_shared<BenchTtlExtractorFactory>();
+        ttl_keys_written_ = 0;
+        fresh_db = true;
+        method = &Benchmark::TimeSeriesTtl;
+        post_process_method = &Benchmark::ReportSeparationStats;
       } else if (name == "xorupdaterandom") {
         method = &Benchmark::XORUpdateRandom;
       } else if (name == "appendrandom") {
@@ -2857,6 +3032,12 @@ class Benchmark {
         Open(&open_options_);  // use open_options for the last accessed
       }
 
+      if (post_process_method == &Benchmark::ReportSeparationStats &&
+          db_.db != nullptr) {
+        separation_baseline_ = GetSeparationStats(db_.db);
+        separation_user_bytes_ = 0;
+      }
+
       if (method != nullptr) {
         fprintf(stdout, "DB path: [%s]\n", FLAGS_db.c_str());
 
@@ -3256,6 +3437,8 @@ class Benchmark {
     options.max_background_compactions = FLAGS_max_background_compactions;
     options.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
     options.max_background_flushes = FLAGS_max_background_flushes;
+    options.adaptive_background_scheduling =
+        FLAGS_adaptive_background_scheduling;
     options.compaction_style = FLAGS_compaction_style_e;
     options.compaction_pri = FLAGS_compaction_pri_e;
     options.allow_mmap_reads = FLAGS_mmap_read;
@@ -3415,6 +3598,17 @@ class Benchmark {
           block_based_options.partition_filters = true;
         }
       }
+      if (FLAGS_compact_index) {
+        if (FLAGS_use_hash_search || FLAGS_partition_index_and_filters ||
+            FLAGS_partition_index) {
+          fprintf(stderr,
+                  "compact_index is incompatible with "
+                  "hash search and partition index and is ignored");
+        } else {
+          block_based_options.index_type =
+              BlockBasedTableOptions::kCompactIndexSearch;
+        }
+      }
       if (cache_ == nullptr) {
         block_based_options.no_block_cache = true;
       }
@@ -3475,6 +3669,8 @@ class Benchmark {
 
           auto pcache = std::make_shared<BlockCacheTier>(rc_cfg);
           block_based_options.persistent_cache = pcache;
+          block_based_options.persistent_cache_admit_evicted =
+              FLAGS_read_cache_admit_evicted;
           rc_status = pcache->Open();
         }
 
@@ -3542,6 +3738,7 @@ class Benchmark {
     options.hard_pending_compaction_bytes_limit =
         FLAGS_hard_pending_compaction_bytes_limit;
     options.delayed_write_rate = FLAGS_delayed_write_rate;
+    options.adaptive_write_throttling = FLAGS_adaptive_write_throttling;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
     options.inplace_update_support = FLAGS_inplace_update_support;
@@ -3565,8 +3762,11 @@ class Benchmark {
     options.blob_file_defragment_size = FLAGS_blob_file_defragment_size;
     options.max_dependence_blob_overlap = FLAGS_max_dependence_blob_overlap;
     options.maintainer_job_ratio = FLAGS_maintainer_job_ratio;
+    options.ttl_gc_ratio = FLAGS_ttl_gc_ratio;
     options.optimize_filters_for_hits = FLAGS_optimize_filters_for_hits;
     options.optimize_range_deletion = FLAGS_optimize_range_deletion;
+    options.use_loser_tree_merging_iterator =
+        FLAGS_use_loser_tree_merging_iterator;
 
     // fill storage options
     options.advise_random_on_open = FLAGS_advise_random_on_open;
@@ -5723,19 +5923,276 @@ class Benchmark {
     }
   }
 
+  // Zipfian overwrites, meant for values large enough to be separated
+  void UpdateRandomKVSep(ThreadState* thread) {
+    RandomGenerator gen;
+    int64_t bytes = 0;
+    uint64_t next_report = 0;
+    Duration duration(FLAGS_duration, writes_);
+
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    while (!duration.Done(1)) {
+      DB* db = SelectDB(thread);
+      // Map to a different number to avoid locality, as GetRandomKey() does
+      const uint64_t kBigPrime = 0x5bd1e995;
+      uint64_t rank = zipf_->Next(&thread->rand);
+      GenerateKeyFromInt((rank * kBigPrime) % FLAGS_num, FLAGS_num, &key, -1);
+
+      if (thread->shared->write_rate_limiter) {
+        thread->shared->write_rate_limiter->Request(
+            key.size() + value_size_, Env::IO_HIGH, nullptr /*stats*/,
+            RateLimiter::OpType::kWrite);
+      }
+      Status s = db->Put(write_options_, key, gen.Generate(value_size_));
+      if (!s.ok()) {
+        fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+        exit(1);
+      }
+      bytes += key.size() + value_size_;
+      thread->stats.FinishedOps(nullptr, db, 1, kWrite);
+      MaybeReportGarbageRatio(thread, &next_report);
+    }
+    thread->stats.AddBytes(bytes);
+    separation_user_bytes_ += bytes;
+  }
+
+  // Short scans, which go through the map SSTs lazy compaction leaves
+  void ScanLazy(ThreadState* thread) {
+    ReadOptions options(FLAGS_verify_checksum, true);
+    int64_t read = 0;
+    int64_t found = 0;
+    int64_t bytes = 0;
+    uint64_t next_report = 0;
+    Duration duration(FLAGS_duration, reads_);
+
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    std::unique_ptr<Iterator> iter(SelectDB(thread)->NewIterator(options));
+    while (!duration.Done(1)) {
+      GenerateKeyFromInt(GetRandomKey(&thread->rand), FLAGS_num, &key, -1);
+      iter->Seek(key);
+      read++;
+      if (iter->Valid()) {
+        found++;
+      }
+      for (int j = 0; j < FLAGS_lazy_scan_length && iter->Valid(); ++j) {
+        bytes += iter->key().size() + iter->value().size();
+        iter->Next();
+      }
+      if (!iter->status().ok()) {
+        fprintf(stderr, "scan error: %s\n", iter->status().ToString().c_str());
+        exit(1);
+      }
+      if (thread->shared->read_rate_limiter.get() != nullptr) {
+        thread->shared->read_rate_limiter->Request(
+            1, Env::IO_HIGH, nullptr /* stats */, RateLimiter::OpType::kRead);
+      }
+      thread->stats.FinishedOps(nullptr, nullptr, 1, kSeek);
+      MaybeReportGarbageRatio(thread, &next_report);
+    }
+    char msg[100];
+    snprintf(msg, sizeof(msg), "(%" PRIu64 " of %" PRIu64 " found)", found,
+             read);
+    thread->stats.AddBytes(bytes);
+    thread->stats.AddMessage(msg);
+  }
+
+  // Thread 0 appends entries that expire after --ttl_seconds until it has
+  // written --writes of them, the others read random written keys
+  void TimeSeriesTtl(ThreadState* thread) {
+    // Only work on single database
+    assert(db_.db != nullptr);
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    int64_t bytes = 0;
+
+    if (thread->tid > 0) {
+      ReadOptions options(FLAGS_verify_checksum, true);
+      std::string value;
+      int64_t read = 0;
+      int64_t found = 0;
+      while (true) {
+        {
+          MutexLock l(&thread->shared->mu);
+          if (thread->shared->num_done >= 1) {
+            // Write thread have finished
+            break;
+          }
+        }
+        int64_t written = ttl_keys_written_.load(std::memory_order_relaxed);
+        if (written == 0) {
+          continue;
+        }
+        GenerateKeyFromInt(thread->rand.Next() % written % FLAGS_num,
+                           FLAGS_num, &key, -1);
+        Status s = db_.db->Get(options, key, &value);
+        read++;
+        if (s.ok()) {
+          found++;
+          bytes += key.size() + value.size();
+        } else if (!s.IsNotFound()) {
+          fprintf(stderr, "Get returned an error: %s\n",
+                  s.ToString().c_str());
+          abort();
+        }
+        thread->stats.FinishedOps(&db_, db_.db, 1, kRead);
+      }
+      char msg[100];
+      snprintf(msg, sizeof(msg), "(%" PRIu64 " of %" PRIu64 " found)", found,
+               read);
+      thread->stats.AddBytes(bytes);
+      thread->stats.AddMessage(msg);
+      return;
+    }
+
+    // Don't merge stats from this thread with the readers.
+    thread->stats.SetExcludeFromMerge();
+    RandomGenerator gen;
+    std::string value;
+    uint64_t next_report = 0;
+    Duration duration(FLAGS_duration, writes_);
+    while (!duration.Done(1)) {
+      int64_t key_id = ttl_keys_written_.load(std::memory_order_relaxed);
+      GenerateKeyFromInt(key_id % FLAGS_num, FLAGS_num, &key, -1);
+      Slice payload = gen.Generate(value_size_);
+      value.assign(payload.data(), payload.size());
+      PutFixed64(&value, FLAGS_env->NowMicros() / 1000000 + FLAGS_ttl_seconds);
+
+      if (thread->shared->write_rate_limiter) {
+        thread->shared->write_rate_limiter->Request(
+            key.size() + value.size(), Env::IO_HIGH, nullptr /*stats*/,
+            RateLimiter::OpType::kWrite);
+      }
+      Status s = db_.db->Put(write_options_, key, value);
+      if (!s.ok()) {
+        fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+        exit(1);
+      }
+      ttl_keys_written_.store(key_id + 1, std::memory_order_relaxed);
+      bytes += key.size() + value.size();
+      thread->stats.FinishedOps(&db_, db_.db, 1, kWrite);
+      MaybeReportGarbageRatio(thread, &next_report);
+    }
+    thread->stats.AddBytes(bytes);
+    separation_user_bytes_ += bytes;
+    thread->stats.Stop();
+    thread->stats.Report("timeseries_ttl write");
+  }
+
+  // Let thread 0 print the blob garbage ratio every
+  // --separation_stats_interval seconds
+  void MaybeReportGarbageRatio(ThreadState* thread, uint64_t* next_report) {
+    if (thread->tid != 0 || FLAGS_separation_stats_interval <= 0 ||
+        db_.db == nullptr) {
+      return;
+    }
+    uint64_t now = FLAGS_env->NowMicros();
+    if (now < *next_report) {
+      return;
+    }
+    if (*next_report != 0) {
+      std::string ratio;
+      if (db_.db->GetProperty(DB::Properties::kBlobGarbageRatio, &ratio)) {
+        fprintf(stdout, "%s ... blob garbage ratio %s\n",
+                FLAGS_env->TimeToString(now / 1000000).c_str(),
+                ratio.c_str());
+      }
+    }
+    *next_report = now + FLAGS_separation_stats_interval * 1000000ull;
+  }
+
+  SeparationStats GetSeparationStats(DB* db) {
+    const double kGB = 1048576.0 * 1024;
+    std::map<std::string, std::string> cf_stats;
+    db->GetMapProperty(DB::Properties::kCFStats, &cf_stats);
+    auto written = [&cf_stats, kGB](const std::string& level) {
+      std::string prefix = "compaction." + level + ".";
+      return static_cast<uint64_t>(
+          (std::atof(cf_stats[prefix + "WriteGB"].c_str()) +
+           std::atof(cf_stats[prefix + "WriteBlobGB"].c_str())) *
+          kGB);
+    };
+    SeparationStats stats;
+    uint64_t total = written("Sum");
+    // Blob GC outputs go to the blob level -1
+    stats.gc_bytes = written("L-1");
+    // Only L0 counts flushes and compactions together
+    stats.flush_bytes = dbstats != nullptr
+                            ? dbstats->getTickerCount(FLUSH_WRITE_BYTES)
+                            : written("L0");
+    stats.compaction_bytes =
+        total - std::min(total, stats.gc_bytes + stats.flush_bytes);
+    std::string ratio;
+    if (db->GetProperty(DB::Properties::kBlobGarbageRatio, &ratio)) {
+      stats.garbage_ratio = std::atof(ratio.c_str());
+    }
+    return stats;
+  }
+
+  // Print the write amplification of the benchmark split into flush,
+  // compaction and blob GC, the blob garbage ratio and the read
+  // amplification of the map SSTs
+  void ReportSeparationStats() {
+    if (db_.db == nullptr) {
+      return;
+    }
+    SeparationStats stats = GetSeparationStats(db_.db);
+    auto& base = separation_baseline_;
+    double user = std::max<double>(1, separation_user_bytes_.load());
+    auto diff = [](uint64_t now, uint64_t then) {
+      return static_cast<double>(now - std::min(now, then));
+    };
+    double flush = diff(stats.flush_bytes, base.flush_bytes);
+    double compaction = diff(stats.compaction_bytes, base.compaction_bytes);
+    double gc = diff(stats.gc_bytes, base.gc_bytes);
+    fprintf(stdout,
+            "Write amplification: flush %.2f compaction %.2f gc %.2f total "
+            "%.2f (user writes %.1f MB)\n",
+            flush / user, compaction / user, gc / user,
+            (flush + compaction + gc) / user, user / 1048576.0);
+    fprintf(stdout, "Blob garbage ratio: %.4f (was %.4f)\n",
+            stats.garbage_ratio, base.garbage_ratio);
+
+    TablePropertiesCollection props;
+    Status s = db_.db->GetPropertiesOfAllTables(&props);
+    if (!s.ok()) {
+      fprintf(stderr, "GetPropertiesOfAllTables: %s\n", s.ToString().c_str());
+      return;
+    }
+    size_t map_ssts = 0;
+    double read_amp = 0;
+    uint16_t max_read_amp = 0;
+    for (auto& prop : props) {
+      if (prop.second->purpose == kMapSst) {
+        ++map_ssts;
+        read_amp += prop.second->read_amp;
+        max_read_amp = std::max(max_read_amp, prop.second->max_read_amp);
+      }
+    }
+    fprintf(stdout,
+            "Map SSTs: %" ROCKSDB_PRIszt
+            " read amplification avg %.2f max %u\n",
+            map_ssts, map_ssts == 0 ? 0.0 : read_amp / map_ssts,
+            static_cast<unsigned>(max_read_amp));
+  }
+
   void Compact(ThreadState* thread) {
     DB* db = SelectDB(thread);
     CompactRangeOptions cro;
     cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+    cro.separation_type = FLAGS_compaction_separation_type_e;
     db->CompactRange(cro, nullptr, nullptr);
   }
 
   void CompactAll() {
+    CompactRangeOptions cro;
+    cro.separation_type = FLAGS_compaction_separation_type_e;
     if (db_.db != nullptr) {
-      db_.db->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+      db_.db->CompactRange(cro, nullptr, nullptr);
     }
     for (const auto& db_with_cfh : multi_dbs_) {
-      db_with_cfh.db->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+      db_with_cfh.db->CompactRange(cro, nullptr, nullptr);
     }
   }
 
@@ -5887,6 +6344,32 @@ int db_bench_tool(int argc, char** argv) {
     FLAGS_env = new TERARKDB_NAMESPACE::HdfsEnv(FLAGS_hdfs);
   }
 
+  if (!strcasecmp(FLAGS_compaction_separation_type.c_str(),
+                  "trans_to_separate")) {
+    FLAGS_compaction_separation_type_e =
+        TERARKDB_NAMESPACE::kCompactionTransToSeparate;
+  } else if (!strcasecmp(FLAGS_compaction_separation_type.c_str(),
+                         "ignore_separate")) {
+    FLAGS_compaction_separation_type_e =
+        TERARKDB_NAMESPACE::kCompactionIgnoreSeparate;
+  } else if (!strcasecmp(FLAGS_compaction_separation_type.c_str(),
+                         "auto_rebuild_blob")) {
+    FLAGS_compaction_separation_type_e =
+        TERARKDB_NAMESPACE::kCompactionAutoRebuildBlob;
+  } else if (!strcasecmp(FLAGS_compaction_separation_type.c_str(),
+                         "force_rebuild_blob")) {
+    FLAGS_compaction_separation_type_e =
+        TERARKDB_NAMESPACE::kCompactionForceRebuildBlob;
+  } else if (!strcasecmp(FLAGS_compaction_separation_type.c_str(),
+                         "combine_value")) {
+    FLAGS_compaction_separation_type_e =
+        TERARKDB_NAMESPACE::kCompactionCombineValue;
+  } else {
+    fprintf(stderr, "Unknown compaction separation type: %s\n",
+            FLAGS_compaction_separation_type.c_str());
+    exit(1);
+  }
+
   if (!strcasecmp(FLAGS_compaction_fadvice.c_str(), "NONE"))
     FLAGS_compaction_fadvice_e = TERARKDB_NAMESPACE::Options::NONE;
   else if (!strcasecmp(FLAGS_compaction_fadvice.c_str(), "NORMAL"))
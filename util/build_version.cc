@@ -0,0 +1,4 @@
+#include "build_version.h"
+const char* rocksdb_build_git_sha = "rocksdb_build_git_sha:@bed22d64f2a0f2a93519cb92a596c66009fd5b9b@";
+const char* rocksdb_build_git_date = "rocksdb_build_git_date:@2026/10/18 16:53:11@";
+const char* rocksdb_build_compile_date = __DATE__;
@@ -42,6 +42,9 @@ void CompactionJobStats::Reset() {
 
   num_single_del_fallthru = 0;
   num_single_del_mismatch = 0;
+
+  num_blob_fetches = 0;
+  total_blob_fetch_bytes = 0;
 }
 
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
@@ -74,6 +77,9 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
+
+  num_blob_fetches += stats.num_blob_fetches;
+  total_blob_fetch_bytes += stats.total_blob_fetch_bytes;
 }
 
 #else
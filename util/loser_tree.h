@@ -0,0 +1,223 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "port/port.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/autovector.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// Tournament (loser) tree with the same interface as BinaryHeap, intended as
+// a drop-in replacement in multi-way merges with many inputs.
+// Comparison to BinaryHeap:
+// - replace_top() and pop() replay one leaf-to-root path, which takes exactly
+//   ceil(logN) comparisons instead of up to ~2logN.
+// - When the same input wins twice in a row, the runner-up (the best of the
+//   losers on the winner's path) is remembered. As long as the replacement
+//   element is not worse than the runner-up, replace_top() takes a single
+//   comparison and does not touch the tree at all.
+// - push() only appends and keeps track of the top, the tree is built with
+//   N-1 comparisons on the next access, so filling it after a seek costs O(N)
+//   instead of O(NlogN).
+// - A popped input keeps its leaf, marked as exhausted, until the next push()
+//   or clear().
+//
+// As with BinaryHeap, the comparison operator provides the less-than relation
+// and top() returns the maximum.
+
+template <typename T, typename Compare = std::less<T>>
+class LoserTree {
+ public:
+  LoserTree() {}
+  explicit LoserTree(Compare cmp) : cmp_(std::move(cmp)) {}
+
+  void push(const T& value) {
+    size_t best = dirty_ ? best_ : winner_;
+    if (num_active_ < leaves_.size()) {
+      best = compact(best);
+    }
+    leaves_.push_back(value);
+    exhausted_.push_back(0);
+    size_t leaf = leaves_.size() - 1;
+    if (num_active_ == 0 || beats(leaf, best)) {
+      best = leaf;
+    }
+    ++num_active_;
+    best_ = best;
+    dirty_ = true;
+  }
+
+  const T& top() const {
+    assert(!empty());
+    if (dirty_) {
+      build();
+    }
+    return leaves_[winner_];
+  }
+
+  void replace_top(const T& value) {
+    assert(!empty());
+    if (dirty_) {
+      leaves_[best_] = value;
+      build();
+      return;
+    }
+    leaves_[winner_] = value;
+    if (runner_up_ != kUnknown) {
+      if (runner_up_ == kNone || !cmp_(value, leaves_[runner_up_])) {
+        // Same input wins again, nothing below the root changes
+        return;
+      }
+      runner_up_ = kUnknown;
+      replay(winner_);
+      return;
+    }
+    size_t last_winner = winner_;
+    replay(winner_);
+    if (winner_ == last_winner) {
+      find_runner_up();
+    }
+  }
+
+  void pop() {
+    assert(!empty());
+    if (dirty_) {
+      exhausted_[best_] = 1;
+      --num_active_;
+      if (num_active_ > 0) {
+        build();
+      }
+      return;
+    }
+    exhausted_[winner_] = 1;
+    --num_active_;
+    runner_up_ = kUnknown;
+    if (num_active_ > 0) {
+      replay(winner_);
+    }
+  }
+
+  void clear() {
+    leaves_.clear();
+    exhausted_.clear();
+    num_active_ = 0;
+    dirty_ = false;
+  }
+
+  bool empty() const { return num_active_ == 0; }
+
+  size_t size() const { return num_active_; }
+
+  const Compare& comparator() const { return cmp_; }
+
+ private:
+  static const size_t kUnknown = port::kMaxSizet;
+  static const size_t kNone = port::kMaxSizet - 1;
+
+  // Leaf `a` comes out of the tree before leaf `b`
+  bool beats(size_t a, size_t b) const {
+    if (exhausted_[a]) {
+      return false;
+    }
+    if (exhausted_[b]) {
+      return true;
+    }
+    return cmp_(leaves_[b], leaves_[a]);
+  }
+
+  // Drop the leaves of popped inputs, the tree is rebuilt afterwards anyway.
+  // Returns the new position of leaf `keep`.
+  size_t compact(size_t keep) {
+    size_t j = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < leaves_.size(); ++i) {
+      if (!exhausted_[i]) {
+        if (i == keep) {
+          kept = j;
+        }
+        leaves_[j] = leaves_[i];
+        exhausted_[j] = 0;
+        ++j;
+      }
+    }
+    leaves_.resize(j);
+    exhausted_.resize(j);
+    return kept;
+  }
+
+  // Leaf i lives at position N + i, internal node p at position p holds the
+  // loser of the match between its children, the parent of a position p is
+  // p / 2. This layout works for any N, not just powers of two.
+  void build() const {
+    size_t n = leaves_.size();
+    losers_.resize(n);
+    winners_.resize(n);
+    for (size_t p = n - 1; p >= 1; --p) {
+      size_t l = 2 * p < n ? winners_[2 * p] : 2 * p - n;
+      size_t r = 2 * p + 1 < n ? winners_[2 * p + 1] : 2 * p + 1 - n;
+      if (beats(r, l)) {
+        winners_[p] = r;
+        losers_[p] = l;
+      } else {
+        winners_[p] = l;
+        losers_[p] = r;
+      }
+    }
+    winner_ = n > 1 ? winners_[1] : 0;
+    runner_up_ = n > 1 ? kUnknown : kNone;
+    dirty_ = false;
+  }
+
+  // Leaf `leaf` changed, play its matches up to the root again
+  void replay(size_t leaf) {
+    size_t n = leaves_.size();
+    size_t challenger = leaf;
+    for (size_t p = (n + leaf) / 2; p >= 1; p /= 2) {
+      if (beats(losers_[p], challenger)) {
+        std::swap(losers_[p], challenger);
+      }
+    }
+    winner_ = challenger;
+  }
+
+  void find_runner_up() {
+    size_t n = leaves_.size();
+    size_t best = kNone;
+    for (size_t p = (n + winner_) / 2; p >= 1; p /= 2) {
+      size_t loser = losers_[p];
+      if (!exhausted_[loser] && (best == kNone || beats(loser, best))) {
+        best = loser;
+      }
+    }
+    runner_up_ = best;
+  }
+
+  Compare cmp_;
+  autovector<T> leaves_;
+  autovector<uint8_t> exhausted_;
+  size_t num_active_ = 0;
+  // The tree is rebuilt lazily after push(), so it is mutable for top()
+  mutable autovector<size_t> losers_;
+  mutable autovector<size_t> winners_;
+  mutable size_t winner_ = 0;
+  // Top as of the last push(), only used before the tree is built. The
+  // caller may change the top element in place before it calls
+  // replace_top() or pop(), so the top has to be known before the tree is
+  // built from the new values.
+  size_t best_ = 0;
+  // Best leaf among the losers on the path of winner_, kNone if all of them
+  // are exhausted, kUnknown if it has not been computed since the tree changed
+  mutable size_t runner_up_ = kUnknown;
+  mutable bool dirty_ = false;
+};
+
+}  // namespace TERARKDB_NAMESPACE
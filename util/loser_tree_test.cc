@@ -0,0 +1,184 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/loser_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/terark_namespace.h"
+
+#ifndef GFLAGS
+const int64_t FLAGS_iters = 100000;
+#else
+#include "util/gflags_compat.h"
+DEFINE_int64(iters, 100000, "number of pseudo-random operations in each test");
+#endif  // GFLAGS
+
+/*
+ * Compares the tournament tree in util/loser_tree.h against
+ * std::priority_queue on a pseudo-random sequence of operations.
+ */
+
+namespace TERARKDB_NAMESPACE {
+
+using LoserTreeTestValue = uint64_t;
+using Params = std::tuple<size_t, LoserTreeTestValue, int64_t>;
+
+class LoserTreeTest : public ::testing::TestWithParam<Params> {};
+
+TEST_P(LoserTreeTest, Test) {
+  // Same sequence of operations as HeapTest: insert, replace top and pop,
+  // growing the tree up to MAX_SIZE and then draining it.
+  const auto MAX_SIZE = std::get<0>(GetParam());
+  const auto MAX_VALUE = std::get<1>(GetParam());
+  const auto RNG_SEED = std::get<2>(GetParam());
+
+  LoserTree<LoserTreeTestValue> tree;
+  std::priority_queue<LoserTreeTestValue> ref;
+
+  std::mt19937 rng(static_cast<unsigned int>(RNG_SEED));
+  std::uniform_int_distribution<LoserTreeTestValue> value_dist(0, MAX_VALUE);
+  int ndrains = 0;
+  bool draining = false;  // hit max size, draining until we empty the tree
+  size_t size = 0;
+  for (int64_t i = 0; i < FLAGS_iters; ++i) {
+    if (size == 0) {
+      draining = false;
+    }
+
+    if (!draining && (size == 0 || std::bernoulli_distribution(0.4)(rng))) {
+      // insert
+      LoserTreeTestValue val = value_dist(rng);
+      tree.push(val);
+      ref.push(val);
+      ++size;
+      if (size == MAX_SIZE) {
+        draining = true;
+        ++ndrains;
+      }
+    } else if (std::bernoulli_distribution(0.5)(rng)) {
+      // replace top, half of the time with a value that stays on top
+      LoserTreeTestValue val = std::bernoulli_distribution(0.5)(rng)
+                                   ? value_dist(rng)
+                                   : ref.top();
+      tree.replace_top(val);
+      ref.pop();
+      ref.push(val);
+    } else {
+      // pop
+      assert(size > 0);
+      tree.pop();
+      ref.pop();
+      --size;
+    }
+
+    assert((size == 0) == ref.empty());
+    ASSERT_EQ(size == 0, tree.empty());
+    ASSERT_EQ(size, tree.size());
+    if (size > 0) {
+      ASSERT_EQ(ref.top(), tree.top());
+    }
+  }
+
+  assert(ndrains > 0);
+
+  tree.clear();
+  ASSERT_TRUE(tree.empty());
+}
+
+INSTANTIATE_TEST_CASE_P(Basic, LoserTreeTest,
+                        ::testing::Values(Params(1000, 3000,
+                                                 0x1b575cf05b708945)));
+INSTANTIATE_TEST_CASE_P(SmallValues, LoserTreeTest,
+                        ::testing::Values(Params(100, 10, 0x5ae213f7bd5dccd0)));
+INSTANTIATE_TEST_CASE_P(SmallTree, LoserTreeTest,
+                        ::testing::Values(Params(10, ULLONG_MAX,
+                                                 0x3e1fa8f4d01707cf)));
+INSTANTIATE_TEST_CASE_P(TwoElementTree, LoserTreeTest,
+                        ::testing::Values(Params(2, 5, 0x4b5e13ea988c6abc)));
+INSTANTIATE_TEST_CASE_P(OneElementTree, LoserTreeTest,
+                        ::testing::Values(Params(1, 3, 0x176a1019ab0b612e)));
+
+struct CountingGreater {
+  size_t* count;
+  bool operator()(int a, int b) const {
+    ++*count;
+    return a > b;
+  }
+};
+
+TEST(LoserTreeRunTest, SameInputWinsAgain) {
+  // 32 inputs, input i yields i * 1000 .. i * 1000 + 999, so every input is
+  // drained before the next one takes over
+  const int kInputs = 32;
+  const int kRun = 1000;
+  size_t count = 0;
+  LoserTree<int, CountingGreater> tree(CountingGreater{&count});
+  std::vector<int> next(kInputs);
+  for (int i = 0; i < kInputs; ++i) {
+    tree.push(i * kRun);
+    next[i] = i * kRun + 1;
+  }
+  int expected = 0;
+  while (!tree.empty()) {
+    int v = tree.top();
+    ASSERT_EQ(expected++, v);
+    int input = v / kRun;
+    if (next[input] < (input + 1) * kRun) {
+      tree.replace_top(next[input]++);
+    } else {
+      tree.pop();
+    }
+  }
+  ASSERT_EQ(kInputs * kRun, expected);
+  // One comparison per element within a run, plus a replay and a runner-up
+  // search of 5 comparisons each at the start of each run
+  ASSERT_LT(count, static_cast<size_t>(kInputs * (kRun + 20)));
+}
+
+struct PointeeGreater {
+  bool operator()(const int* a, const int* b) const { return *a > *b; }
+};
+
+TEST(LoserTreeRunTest, TopChangedBeforeFirstAccess) {
+  // Like a merging iterator, the caller knows which input is on top after
+  // filling the tree and advances it before the tree is ever accessed
+  std::vector<int> values = {5, 3, 9, 7};
+  LoserTree<int*, PointeeGreater> tree{PointeeGreater()};
+  for (auto& v : values) {
+    tree.push(&v);
+  }
+  values[1] = 8;
+  tree.replace_top(&values[1]);
+  ASSERT_EQ(&values[0], tree.top());
+  values[0] = 100;
+  tree.replace_top(&values[0]);
+  ASSERT_EQ(&values[3], tree.top());
+
+  tree.clear();
+  for (auto& v : values) {
+    tree.push(&v);
+  }
+  // 100, 8, 9, 7: the top is popped before it is ever accessed
+  tree.pop();
+  ASSERT_EQ(3U, tree.size());
+  ASSERT_EQ(&values[1], tree.top());
+}
+
+}  // namespace TERARKDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+#ifdef GFLAGS
+  GFLAGS_NAMESPACE::ParseCommandLineFlags(&argc, &argv, true);
+#endif  // GFLAGS
+  return RUN_ALL_TESTS();
+}
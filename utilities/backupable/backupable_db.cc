@@ -118,7 +118,8 @@ class BackupEngineImpl : public BackupEngine {
                                restore_options);
   }
 
-  virtual Status VerifyBackup(BackupID backup_id) override;
+  virtual Status VerifyBackup(BackupID backup_id,
+                              bool verify_with_checksum = false) override;
 
   Status Initialize();
 
@@ -307,7 +308,8 @@ class BackupEngineImpl : public BackupEngine {
 
   // Exactly one of src_path and contents must be non-empty. If src_path is
   // non-empty, the file is copied from this pathname. Otherwise, if contents is
-  // non-empty, the file will be created at dst_path with these contents.
+  // non-empty, the file will be created at dst_path with these contents. If
+  // dst_path is empty, src_path is only read to compute its checksum.
   struct CopyOrCreateWorkItem {
     std::string src_path;
     std::string dst_path;
@@ -471,6 +473,10 @@ class BackupEngineImpl : public BackupEngine {
       corrupt_backups_;
   std::unordered_map<std::string, std::shared_ptr<FileInfo>>
       backuped_file_infos_;
+  // Files of shared_checksum/ by "<original name>/<size>", filled for
+  // reuse_shared_file_checksums while a backup is being created
+  std::unordered_map<std::string, std::shared_ptr<FileInfo>>
+      reusable_checksum_files_;
   std::atomic<bool> stop_backup_;
 
   // options data
@@ -707,12 +713,20 @@ Status BackupEngineImpl::Initialize() {
       CopyOrCreateWorkItem work_item;
       while (files_to_copy_or_create_.read(work_item)) {
         CopyOrCreateResult result;
-        result.status = CopyOrCreateFile(
-            work_item.src_path, work_item.dst_path, work_item.contents,
-            work_item.src_env, work_item.dst_env, work_item.src_env_options,
-            work_item.sync, work_item.rate_limiter, &result.size,
-            &result.checksum_value, work_item.size_limit,
-            work_item.progress_callback);
+        if (work_item.dst_path.empty()) {
+          // Nothing to write, only checksum the source
+          result.size = 0;
+          result.status = CalculateChecksum(
+              work_item.src_path, work_item.src_env, work_item.src_env_options,
+              work_item.size_limit, &result.checksum_value);
+        } else {
+          result.status = CopyOrCreateFile(
+              work_item.src_path, work_item.dst_path, work_item.contents,
+              work_item.src_env, work_item.dst_env, work_item.src_env_options,
+              work_item.sync, work_item.rate_limiter, &result.size,
+              &result.checksum_value, work_item.size_limit,
+              work_item.progress_callback);
+        }
         work_item.result.set_value(std::move(result));
       }
     });
@@ -778,6 +792,22 @@ Status BackupEngineImpl::CreateNewBackupWithMetadata(
   // live file.
   std::unordered_set<std::string> live_dst_paths;
 
+  if (options_.share_files_with_checksum &&
+      options_.reuse_shared_file_checksums) {
+    // The checksum is part of the name in shared_checksum/, so look the live
+    // files up by their original name and size instead
+    const std::string dir_rel = GetSharedFileWithChecksumRel();
+    for (const auto& file_info : backuped_file_infos_) {
+      const std::string& file = file_info.first;
+      if (file.compare(0, dir_rel.size(), dir_rel) == 0) {
+        reusable_checksum_files_.emplace(
+            GetFileFromChecksumFile(file.substr(dir_rel.size())) + "/" +
+                TERARKDB_NAMESPACE::ToString(file_info.second->size),
+            file_info.second);
+      }
+    }
+  }
+
   std::vector<BackupAfterCopyOrCreateWorkItem> backup_items_to_finish;
   // Add a CopyOrCreateWorkItem to the channel for each live file
   db->DisableFileDeletions();
@@ -872,6 +902,7 @@ Status BackupEngineImpl::CreateNewBackupWithMetadata(
 
   // we copied all the files, enable file deletions
   db->EnableFileDeletions(false);
+  reusable_checksum_files_.clear();
 
   auto backup_time = backup_env_->NowMicros() - start_backup;
 
@@ -1051,6 +1082,8 @@ Status BackupEngineImpl::RestoreDBFromBackup(
   ROCKS_LOG_INFO(options_.info_log, "Restoring backup id %u\n", backup_id);
   ROCKS_LOG_INFO(options_.info_log, "keep_log_files: %d\n",
                  static_cast<int>(restore_options.keep_log_files));
+  ROCKS_LOG_INFO(options_.info_log, "link_shared_files: %d\n",
+                 static_cast<int>(restore_options.link_shared_files));
 
   // just in case. Ignore errors
   db_env_->CreateDirIfMissing(db_dir);
@@ -1120,6 +1153,19 @@ Status BackupEngineImpl::RestoreDBFromBackup(
     // kLogFile lives in wal_dir and all the rest live in db_dir
     dst = ((type == kLogFile) ? wal_dir : db_dir) + "/" + dst;
 
+    // 4. Shared files are immutable, they can be linked in place of a copy
+    if (restore_options.link_shared_files && backup_env_ == db_env_ &&
+        file.compare(0, GetPrivateDirRel().size(), GetPrivateDirRel()) != 0) {
+      Status link_status = db_env_->LinkFile(GetAbsolutePath(file), dst);
+      if (link_status.ok()) {
+        ROCKS_LOG_INFO(options_.info_log, "Linked %s to %s\n", file.c_str(),
+                       dst.c_str());
+        continue;
+      }
+      ROCKS_LOG_INFO(options_.info_log, "Link %s failed, copy instead: %s\n",
+                     file.c_str(), link_status.ToString().c_str());
+    }
+
     ROCKS_LOG_INFO(options_.info_log, "Restoring %s to %s\n", file.c_str(),
                    dst.c_str());
     CopyOrCreateWorkItem copy_or_create_work_item(
@@ -1154,7 +1200,8 @@ Status BackupEngineImpl::RestoreDBFromBackup(
   return s;
 }
 
-Status BackupEngineImpl::VerifyBackup(BackupID backup_id) {
+Status BackupEngineImpl::VerifyBackup(BackupID backup_id,
+                                      bool verify_with_checksum) {
   assert(initialized_);
   auto corrupt_itr = corrupt_backups_.find(backup_id);
   if (corrupt_itr != corrupt_backups_.end()) {
@@ -1189,7 +1236,39 @@ Status BackupEngineImpl::VerifyBackup(BackupID backup_id) {
       return Status::Corruption("File corrupted: " + abs_path);
     }
   }
-  return Status::OK();
+  if (!verify_with_checksum) {
+    return Status::OK();
+  }
+
+  // Stream the files through the background threads and check the results
+  // in order, so at most max_background_operations files are read at once
+  std::vector<RestoreAfterCopyOrCreateWorkItem> verify_items_to_finish;
+  for (const auto& file_info : backup->GetFiles()) {
+    CopyOrCreateWorkItem verify_work_item(
+        GetAbsolutePath(file_info->filename), "" /* dst_path */,
+        "" /* contents */, backup_env_, nullptr /* dst_env */,
+        EnvOptions() /* src_env_options */, false /* sync */,
+        nullptr /* rate_limiter */, 0 /* size_limit */);
+    verify_items_to_finish.emplace_back(verify_work_item.result.get_future(),
+                                        file_info->checksum_value);
+    files_to_copy_or_create_.write(std::move(verify_work_item));
+  }
+  Status s;
+  for (size_t i = 0; i < verify_items_to_finish.size(); ++i) {
+    auto& item = verify_items_to_finish[i];
+    item.result.wait();
+    auto result = item.result.get();
+    if (!s.ok()) {
+      continue;
+    }
+    if (!result.status.ok()) {
+      s = result.status;
+    } else if (item.checksum_value != result.checksum_value) {
+      s = Status::Corruption("Checksum check failed: " +
+                             GetAbsolutePath(backup->GetFiles()[i]->filename));
+    }
+  }
+  return s;
 }
 
 Status BackupEngineImpl::CopyOrCreateFile(
@@ -1301,10 +1380,16 @@ Status BackupEngineImpl::AddBackupFileWorkItem(
 
   if (shared && shared_checksum) {
     // add checksum and file length to the file name
-    s = CalculateChecksum(src_dir + fname, db_env_, src_env_options, size_limit,
-                          &checksum_value);
-    if (!s.ok()) {
-      return s;
+    auto reusable = reusable_checksum_files_.find(
+        dst_relative + "/" + TERARKDB_NAMESPACE::ToString(size_bytes));
+    if (reusable != reusable_checksum_files_.end()) {
+      checksum_value = reusable->second->checksum_value;
+    } else {
+      s = CalculateChecksum(src_dir + fname, db_env_, src_env_options,
+                            size_limit, &checksum_value);
+      if (!s.ok()) {
+        return s;
+      }
     }
     if (size_bytes == port::kMaxUint64) {
       return Status::NotFound("File missing: " + src_dir + fname);
@@ -1376,10 +1461,21 @@ Status BackupEngineImpl::AddBackupFileWorkItem(
       backup_env_->DeleteFile(final_dest_path);
     } else {
       // the file is present and referenced by a backup
-      ROCKS_LOG_INFO(options_.info_log,
-                     "%s already present, calculate checksum", fname.c_str());
-      s = CalculateChecksum(src_dir + fname, db_env_, src_env_options,
-                            size_limit, &checksum_value);
+      auto reusable = backuped_file_infos_.find(dst_relative);
+      if (options_.reuse_shared_file_checksums &&
+          reusable != backuped_file_infos_.end() &&
+          reusable->second->size == size_bytes) {
+        ROCKS_LOG_INFO(options_.info_log,
+                       "%s already present, reuse checksum %u",
+                       fname.c_str(), reusable->second->checksum_value);
+        checksum_value = reusable->second->checksum_value;
+      } else {
+        ROCKS_LOG_INFO(options_.info_log,
+                       "%s already present, calculate checksum",
+                       fname.c_str());
+        s = CalculateChecksum(src_dir + fname, db_env_, src_env_options,
+                              size_limit, &checksum_value);
+      }
     }
   }
   live_dst_paths.insert(final_dest_path);
@@ -1862,8 +1958,9 @@ class BackupEngineReadOnlyImpl : public BackupEngineReadOnly {
                                                      restore_options);
   }
 
-  virtual Status VerifyBackup(BackupID backup_id) override {
-    return backup_engine_->VerifyBackup(backup_id);
+  virtual Status VerifyBackup(BackupID backup_id,
+                              bool verify_with_checksum = false) override {
+    return backup_engine_->VerifyBackup(backup_id, verify_with_checksum);
   }
 
   Status Initialize() { return backup_engine_->Initialize(); }
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_set>
 
 #include "db/db_impl.h"
 #include "env/env_chroot.h"
@@ -193,6 +194,13 @@ class TestEnv : public EnvWrapper {
           ++num_direct_seq_readers_;
         }
         ++num_seq_readers_;
+        uint64_t number;
+        FileType type;
+        if (ParseFileName(f.substr(f.find_last_of('/') + 1), &number,
+                          &type) &&
+            type == kTableFile) {
+          ++num_seq_table_readers_;
+        }
       }
       return s;
     }
@@ -349,6 +357,7 @@ class TestEnv : public EnvWrapper {
     num_direct_rand_readers_ = 0;
     num_seq_readers_ = 0;
     num_direct_seq_readers_ = 0;
+    num_seq_table_readers_ = 0;
     num_writers_ = 0;
     num_direct_writers_ = 0;
   }
@@ -357,6 +366,7 @@ class TestEnv : public EnvWrapper {
   int num_direct_rand_readers() { return num_direct_rand_readers_; }
   int num_seq_readers() { return num_seq_readers_; }
   int num_direct_seq_readers() { return num_direct_seq_readers_; }
+  int num_seq_table_readers() { return num_seq_table_readers_; }
   int num_writers() { return num_writers_; }
   int num_direct_writers() { return num_direct_writers_; }
 
@@ -380,6 +390,7 @@ class TestEnv : public EnvWrapper {
   std::atomic<int> num_direct_rand_readers_;
   std::atomic<int> num_seq_readers_;
   std::atomic<int> num_direct_seq_readers_;
+  std::atomic<int> num_seq_table_readers_;
   std::atomic<int> num_writers_;
   std::atomic<int> num_direct_writers_;
 };  // TestEnv
@@ -1235,6 +1246,82 @@ TEST_F(BackupableDBTest, ShareTableFilesWithChecksumsTransition) {
   }
 }
 
+// Verify that with reuse_shared_file_checksums table files already in the
+// backup are not read again, and that the shared files can be restored by
+// hard links
+TEST_F(BackupableDBTest, IncrementalBackupAndLinkedRestore) {
+  const int keys_iteration = 5000;
+  // Keep the backup next to the DB so the shared files can be linked
+  backupable_options_->backup_env = test_db_env_.get();
+  backupable_options_->backup_log_files = false;
+  backupable_options_->reuse_shared_file_checksums = true;
+  options_.disable_auto_compactions = true;
+  OpenDBAndBackupEngineShareWithChecksum(true, false, true, true);
+  FillDB(db_.get(), 0, keys_iteration);
+  ASSERT_OK(backup_engine_->CreateNewBackup(db_.get(), true));
+
+  std::vector<LiveFileMetaData> metadata;
+  db_->GetLiveFilesMetaData(&metadata);
+  std::unordered_set<std::string> old_files;
+  for (auto& file : metadata) {
+    old_files.insert(file.name);
+  }
+
+  FillDB(db_.get(), keys_iteration, keys_iteration * 2);
+  test_db_env_->ClearFileOpenCounters();
+  ASSERT_OK(backup_engine_->CreateNewBackup(db_.get(), true));
+  metadata.clear();
+  db_->GetLiveFilesMetaData(&metadata);
+  int new_files = 0;
+  for (auto& file : metadata) {
+    new_files += old_files.count(file.name) == 0;
+  }
+  ASSERT_GT(old_files.size(), 0U);
+  ASSERT_GT(new_files, 0);
+  // Only the new table files are read, to be copied
+  ASSERT_EQ(new_files, test_db_env_->num_seq_table_readers());
+
+  ASSERT_OK(backup_engine_->VerifyBackup(2, true /* verify_with_checksum */));
+  std::vector<BackupInfo> backup_info;
+  backup_engine_->GetBackupInfo(&backup_info);
+  ASSERT_EQ(2U, backup_info.size());
+  CloseDBAndBackupEngine();
+
+  // Only the private files are written
+  OpenBackupEngine();
+  test_db_env_->ClearFileOpenCounters();
+  RestoreOptions restore_options;
+  restore_options.link_shared_files = true;
+  ASSERT_OK(backup_engine_->RestoreDBFromBackup(2, dbname_, dbname_,
+                                                restore_options));
+  ASSERT_EQ(static_cast<int>(backup_info[1].number_files - metadata.size()),
+            test_db_env_->num_writers());
+  DB* db = OpenDB();
+  AssertExists(db, 0, keys_iteration * 2);
+  delete db;
+
+  // A corruption that keeps the size is only found by the checksums
+  FileManager db_file_manager(db_chroot_env_.get());
+  std::vector<std::string> shared_files;
+  ASSERT_OK(db_chroot_env_->GetChildren(backupdir_ + "/shared_checksum",
+                                        &shared_files));
+  for (auto& file : shared_files) {
+    if (file.find(".sst") != std::string::npos) {
+      ASSERT_OK(db_file_manager.CorruptFile(
+          backupdir_ + "/shared_checksum/" + file, 10));
+      break;
+    }
+  }
+  ASSERT_OK(backup_engine_->VerifyBackup(2));
+  ASSERT_TRUE(backup_engine_->VerifyBackup(2, true).IsCorruption());
+  CloseBackupEngine();
+
+  // The restored DB does not share the rewritten file
+  db = OpenDB();
+  AssertExists(db, 0, keys_iteration * 2);
+  delete db;
+}
+
 TEST_F(BackupableDBTest, DeleteTmpFiles) {
   for (bool shared_checksum : {false, true}) {
     if (shared_checksum) {
@@ -18,9 +18,12 @@
 #include <inttypes.h>
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include "db/db_impl.h"
+#include "db/log_writer.h"
 #include "db/wal_manager.h"
 #include "port/port.h"
 #include "rocksdb/db.h"
@@ -28,6 +31,8 @@
 #include "rocksdb/terark_namespace.h"
 #include "rocksdb/transaction_log.h"
 #include "rocksdb/utilities/checkpoint.h"
+#include "util/cast_util.h"
+#include "util/file_reader_writer.h"
 #include "util/file_util.h"
 #include "util/filename.h"
 #include "util/sync_point.h"
@@ -44,6 +49,11 @@ Status Checkpoint::CreateCheckpoint(const std::string& /*checkpoint_dir*/,
   return Status::NotSupported("");
 }
 
+Status Checkpoint::CreateCompactCheckpoint(
+    const std::string& /*checkpoint_dir*/, int /*max_threads*/) {
+  return Status::NotSupported("");
+}
+
 void CheckpointImpl::CleanStagingDirectory(const std::string& full_private_path,
                                            Logger* info_log) {
   std::vector<std::string> subchildren;
@@ -66,11 +76,9 @@ void CheckpointImpl::CleanStagingDirectory(const std::string& full_private_path,
                  s.ToString().c_str());
 }
 
-// Builds an openable snapshot of RocksDB
-Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
-                                        uint64_t log_size_for_flush) {
-  DBOptions db_options = db_->GetDBOptions();
-
+Status CheckpointImpl::CreateStagingDirectory(
+    const DBOptions& db_options, const std::string& checkpoint_dir,
+    std::string* full_private_path) {
   Status s = db_->GetEnv()->FileExists(checkpoint_dir);
   if (s.ok()) {
     return Status::InvalidArgument("Directory exists");
@@ -93,14 +101,56 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
     return Status::InvalidArgument("invalid checkpoint directory name");
   }
 
-  std::string full_private_path =
+  *full_private_path =
       checkpoint_dir.substr(0, final_nonslash_idx + 1) + ".tmp";
   ROCKS_LOG_INFO(db_options.info_log,
                  "Snapshot process -- using temporary directory %s",
-                 full_private_path.c_str());
-  CleanStagingDirectory(full_private_path, db_options.info_log.get());
+                 full_private_path->c_str());
+  CleanStagingDirectory(*full_private_path, db_options.info_log.get());
   // create snapshot directory
-  s = db_->GetEnv()->CreateDir(full_private_path);
+  return db_->GetEnv()->CreateDir(*full_private_path);
+}
+
+Status CheckpointImpl::FinishStagingDirectory(
+    const DBOptions& db_options, const std::string& full_private_path,
+    const std::string& checkpoint_dir, uint64_t sequence_number, Status s) {
+  if (s.ok()) {
+    // move tmp private backup to real snapshot directory
+    s = db_->GetEnv()->RenameFile(full_private_path, checkpoint_dir);
+  }
+  if (s.ok()) {
+    std::unique_ptr<Directory> checkpoint_directory;
+    db_->GetEnv()->NewDirectory(checkpoint_dir, &checkpoint_directory);
+    if (checkpoint_directory != nullptr) {
+      s = checkpoint_directory->Fsync();
+    }
+  }
+
+  if (s.ok()) {
+    // here we know that we succeeded and installed the new snapshot
+    ROCKS_LOG_INFO(db_options.info_log, "Snapshot DONE. All is good");
+    ROCKS_LOG_INFO(db_options.info_log, "Snapshot sequence number: %" PRIu64,
+                   sequence_number);
+  } else {
+    // clean all the files we might have created
+    ROCKS_LOG_INFO(db_options.info_log, "Snapshot failed -- %s",
+                   s.ToString().c_str());
+    CleanStagingDirectory(full_private_path, db_options.info_log.get());
+  }
+  return s;
+}
+
+// Builds an openable snapshot of RocksDB
+Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
+                                        uint64_t log_size_for_flush) {
+  DBOptions db_options = db_->GetDBOptions();
+
+  std::string full_private_path;
+  Status s =
+      CreateStagingDirectory(db_options, checkpoint_dir, &full_private_path);
+  if (!s.ok() && full_private_path.empty()) {
+    return s;
+  }
   uint64_t sequence_number = 0;
   if (s.ok()) {
     db_->DisableFileDeletions();
@@ -129,30 +179,141 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
     db_->EnableFileDeletions(false);
   }
 
+  return FinishStagingDirectory(db_options, full_private_path, checkpoint_dir,
+                                sequence_number, s);
+}
+
+Status CheckpointImpl::CreateCompactCheckpoint(
+    const std::string& checkpoint_dir, int max_threads) {
+  DBOptions db_options = db_->GetDBOptions();
+  if (db_options.allow_2pc) {
+    return Status::NotSupported("Compact checkpoint does not support 2PC");
+  }
+  auto db_impl = static_cast_with_check<DBImpl, DB>(db_->GetRootDB());
+  Env* env = db_->GetEnv();
+
+  std::string full_private_path;
+  Status s =
+      CreateStagingDirectory(db_options, checkpoint_dir, &full_private_path);
+  if (!s.ok() && full_private_path.empty()) {
+    return s;
+  }
+
+  std::vector<std::string> live_files;
+  std::vector<std::string> manifest_records;
+  uint64_t manifest_number = 0;
+  uint64_t min_log_number = 0;
+  uint64_t sequence_number = 0;
+  VectorLogPtr live_wal_files;
+  bool file_deletions_disabled = false;
   if (s.ok()) {
-    // move tmp private backup to real snapshot directory
-    s = db_->GetEnv()->RenameFile(full_private_path, checkpoint_dir);
+    db_->DisableFileDeletions();
+    file_deletions_disabled = true;
+    s = db_impl->GetCurrentVersionSnapshot(&live_files, &manifest_records,
+                                           &manifest_number, &min_log_number);
+    sequence_number = db_->GetLatestSequenceNumber();
+    if (s.ok()) {
+      s = db_->GetSortedWalFiles(live_wal_files);
+    }
   }
+
+  // Link the table files and copy the OPTIONS file, files are claimed one at
+  // a time so a few large copies do not hold up the rest
+  std::atomic<size_t> next_file(0);
+  std::atomic<bool> same_fs(true);
+  auto link_files = [&](Status* status) {
+    for (size_t i = next_file.fetch_add(1);
+         i < live_files.size() && status->ok(); i = next_file.fetch_add(1)) {
+      const std::string& fname = live_files[i];
+      uint64_t number;
+      FileType type;
+      if (!ParseFileName(fname.substr(1), &number, &type)) {
+        *status = Status::Corruption("Can't parse file name. This is very bad");
+        break;
+      }
+      if (type == kTableFile && same_fs.load(std::memory_order_relaxed)) {
+        *status = env->LinkFile(db_->GetName() + fname,
+                                full_private_path + fname);
+        if (!status->IsNotSupported()) {
+          continue;
+        }
+        same_fs.store(false, std::memory_order_relaxed);
+      }
+      *status = CopyFile(env, db_->GetName() + fname,
+                         full_private_path + fname, 0 /* size */,
+                         db_options.use_fsync);
+    }
+  };
   if (s.ok()) {
-    std::unique_ptr<Directory> checkpoint_directory;
-    db_->GetEnv()->NewDirectory(checkpoint_dir, &checkpoint_directory);
-    if (checkpoint_directory != nullptr) {
-      s = checkpoint_directory->Fsync();
+    size_t num_threads = std::min<size_t>(
+        std::max(max_threads, 1), std::max<size_t>(live_files.size(), 1));
+    std::vector<Status> thread_status(num_threads);
+    std::vector<port::Thread> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(link_files, &thread_status[i]);
+    }
+    link_files(&thread_status[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto& status : thread_status) {
+      if (s.ok() && !status.ok()) {
+        s = status;
+      }
     }
   }
 
+  // Copy the WAL files the flushed tables do not cover, the last one only up
+  // to its current size
+  for (size_t i = 0; s.ok() && i < live_wal_files.size(); ++i) {
+    auto& wal = live_wal_files[i];
+    if (wal->Type() != kAliveLogFile || wal->LogNumber() < min_log_number) {
+      continue;
+    }
+    s = CopyFile(env, db_options.wal_dir + wal->PathName(),
+                 full_private_path + wal->PathName(),
+                 i + 1 == live_wal_files.size() ? wal->SizeFileBytes() : 0,
+                 db_options.use_fsync);
+  }
+  if (file_deletions_disabled) {
+    // we linked all the files, enable file deletions
+    db_->EnableFileDeletions(false);
+  }
+
+  // Write the MANIFEST, it takes the number of the live one which no table
+  // file can have
   if (s.ok()) {
-    // here we know that we succeeded and installed the new snapshot
-    ROCKS_LOG_INFO(db_options.info_log, "Snapshot DONE. All is good");
-    ROCKS_LOG_INFO(db_options.info_log, "Snapshot sequence number: %" PRIu64,
-                   sequence_number);
-  } else {
-    // clean all the files we might have created
-    ROCKS_LOG_INFO(db_options.info_log, "Snapshot failed -- %s",
-                   s.ToString().c_str());
-    CleanStagingDirectory(full_private_path, db_options.info_log.get());
+    ROCKS_LOG_INFO(db_options.info_log,
+                   "Writing manifest %" PRIu64 " of %" ROCKSDB_PRIszt
+                   " records for %" ROCKSDB_PRIszt " files",
+                   manifest_number, manifest_records.size(), live_files.size());
+    std::string manifest_fname =
+        DescriptorFileName(full_private_path, manifest_number);
+    EnvOptions env_options(db_options);
+    std::unique_ptr<WritableFile> manifest_file;
+    s = env->NewWritableFile(manifest_fname, &manifest_file, env_options);
+    if (s.ok()) {
+      log::Writer manifest_log(
+          std::unique_ptr<WritableFileWriter>(new WritableFileWriter(
+              std::move(manifest_file), manifest_fname, env_options)),
+          0, false);
+      for (auto& record : manifest_records) {
+        s = manifest_log.AddRecord(record);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      if (s.ok()) {
+        s = manifest_log.file()->Sync(db_options.use_fsync);
+      }
+    }
+    if (s.ok()) {
+      s = SetCurrentFile(env, full_private_path, manifest_number, nullptr);
+    }
   }
-  return s;
+
+  return FinishStagingDirectory(db_options, full_private_path, checkpoint_dir,
+                                sequence_number, s);
 }
 
 Status CheckpointImpl::CreateCustomCheckpoint(
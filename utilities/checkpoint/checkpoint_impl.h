@@ -31,6 +31,12 @@ class CheckpointImpl : public Checkpoint {
   virtual Status CreateCheckpoint(const std::string& checkpoint_dir,
                                   uint64_t log_size_for_flush) override;
 
+  // Links the current version by max_threads threads and writes a MANIFEST
+  // holding only that version
+  using Checkpoint::CreateCompactCheckpoint;
+  virtual Status CreateCompactCheckpoint(const std::string& checkpoint_dir,
+                                         int max_threads) override;
+
   // Checkpoint logic can be customized by providing callbacks for link, copy,
   // or create.
   Status CreateCustomCheckpoint(
@@ -49,6 +55,17 @@ class CheckpointImpl : public Checkpoint {
 
  private:
   void CleanStagingDirectory(const std::string& path, Logger* info_log);
+  // Checks that checkpoint_dir does not exist and creates the directory the
+  // checkpoint is built in before being renamed to it
+  Status CreateStagingDirectory(const DBOptions& db_options,
+                                const std::string& checkpoint_dir,
+                                std::string* full_private_path);
+  // Moves the staging directory to checkpoint_dir if s is ok, otherwise
+  // cleans it up
+  Status FinishStagingDirectory(const DBOptions& db_options,
+                                const std::string& full_private_path,
+                                const std::string& checkpoint_dir,
+                                uint64_t sequence_number, Status s);
   DB* db_;
 };
 
@@ -26,6 +26,7 @@
 #include "rocksdb/utilities/checkpoint.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "util/fault_injection_test_env.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 #include "util/testharness.h"
 
@@ -593,6 +594,73 @@ TEST_F(CheckpointTest, CheckpointWithParallelWrites) {
   thread.join();
 }
 
+TEST_F(CheckpointTest, CompactCheckpoint) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"one", "two"}, options);
+  for (int i = 0; i < 3; ++i) {
+    for (int cf = 0; cf < 3; ++cf) {
+      ASSERT_OK(Put(cf, "key" + ToString(cf), "value" + ToString(i)));
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  // The iterator keeps the files of the old version of "one" live
+  std::unique_ptr<Iterator> iter(
+      db_->NewIterator(ReadOptions(), handles_[1]));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[1], nullptr,
+                              nullptr));
+  ASSERT_OK(Put(2, "unflushed", "value"));
+
+  Checkpoint* checkpoint;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->CreateCompactCheckpoint(snapshot_name_, 4));
+  delete checkpoint;
+
+  // Only the files of the current versions are linked
+  std::vector<LiveFileMetaData> metadata;
+  db_->GetLiveFilesMetaData(&metadata);
+  std::vector<std::string> live_files;
+  uint64_t manifest_file_size;
+  ASSERT_OK(db_->GetLiveFiles(live_files, &manifest_file_size, false));
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(snapshot_name_, &files));
+  size_t num_table_files = 0;
+  size_t num_live_table_files = 0;
+  for (auto& file : files) {
+    num_table_files += file.find(".sst") != std::string::npos;
+  }
+  for (auto& file : live_files) {
+    num_live_table_files += file.find(".sst") != std::string::npos;
+  }
+  ASSERT_EQ(metadata.size(), num_table_files);
+  ASSERT_LT(num_table_files, num_live_table_files);
+  iter.reset();
+
+  options.create_if_missing = false;
+  std::vector<ColumnFamilyDescriptor> column_families;
+  for (auto& name : {kDefaultColumnFamilyName, std::string("one"),
+                     std::string("two")}) {
+    column_families.push_back(ColumnFamilyDescriptor(name, options));
+  }
+  std::vector<ColumnFamilyHandle*> cphandles;
+  DB* snapshot_db;
+  ASSERT_OK(DB::Open(options, snapshot_name_, column_families, &cphandles,
+                     &snapshot_db));
+  std::string result;
+  for (int cf = 0; cf < 3; ++cf) {
+    ASSERT_OK(snapshot_db->Get(ReadOptions(), cphandles[cf],
+                               "key" + ToString(cf), &result));
+    ASSERT_EQ("value2", result);
+  }
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), cphandles[2], "unflushed",
+                             &result));
+  ASSERT_EQ("value", result);
+  for (auto h : cphandles) {
+    delete h;
+  }
+  delete snapshot_db;
+}
+
 TEST_F(CheckpointTest, CheckpointWithUnsyncedDataDropped) {
   Options options = CurrentOptions();
   std::unique_ptr<FaultInjectionTestEnv> env(new FaultInjectionTestEnv(env_));
@@ -173,13 +173,13 @@ size_t LongFixedLengthColBufDecoder::Decode(const char* src, char** dest) {
   }
   memcpy(*dest, src, size_);
   *dest += size_;
-  return size_ + 1;
+  return nullable_ ? size_ + 1 : size_;
 }
 
 size_t VariableLengthColBufDecoder::Decode(const char* src, char** dest) {
   uint8_t len;
   len = *src;
-  memcpy(dest, reinterpret_cast<char*>(&len), 1);
+  memcpy(*dest, reinterpret_cast<char*>(&len), 1);
   *dest += 1;
   src += 1;
   memcpy(*dest, src, len);
@@ -15,6 +15,7 @@
 #include <thread>
 
 #include "rocksdb/terark_namespace.h"
+#include "table/persistent_cache_helper.h"
 #include "utilities/persistent_cache/block_cache_tier.h"
 
 namespace TERARKDB_NAMESPACE {
@@ -284,6 +285,34 @@ static void UniqueIdCallback(void* arg) {
 }
 #endif
 
+TEST_F(PersistentCacheTierTest, AdmissionQueue) {
+  auto cache = std::make_shared<VolatileCacheTier>(/*is_compressed=*/false);
+  const size_t kBlockSize = 1024;
+  const std::string block(kBlockSize, 'x');
+  {
+    PersistentCacheAdmissionQueue queue(cache, 1024 * kBlockSize);
+    for (int i = 0; i < 100; ++i) {
+      queue.Add("key" + ToString(i), block);
+    }
+    // The queued blocks are written before the queue goes away
+  }
+  for (int i = 0; i < 100; ++i) {
+    std::unique_ptr<char[]> data;
+    size_t size;
+    ASSERT_OK(cache->Lookup("key" + ToString(i), &data, &size));
+    ASSERT_EQ(block, std::string(data.get(), size));
+  }
+
+  // Nothing is queued past the budget
+  {
+    PersistentCacheAdmissionQueue queue(cache, 0);
+    queue.Add("dropped", block);
+  }
+  std::unique_ptr<char[]> data;
+  size_t size;
+  ASSERT_NOK(cache->Lookup("dropped", &data, &size));
+}
+
 TEST_F(PersistentCacheTierTest, FactoryTest) {
   for (auto nvm_opt : {true, false}) {
     ASSERT_FALSE(cache_);
@@ -312,7 +341,7 @@ PersistentCacheDBTest::PersistentCacheDBTest() : DBTestBase("/cache_test") {
 // test template
 void PersistentCacheDBTest::RunTest(
     const std::function<std::shared_ptr<PersistentCacheTier>(bool)>& new_pcache,
-    const size_t max_keys = 100 * 1024, const size_t max_usecase = 5) {
+    const size_t max_keys = 100 * 1024, const size_t max_usecase = 6) {
   if (!Snappy_Supported()) {
     return;
   }
@@ -379,6 +408,15 @@ void PersistentCacheDBTest::RunTest(
         table_options.block_cache_compressed = nullptr;
         options.table_factory.reset(NewBlockBasedTableFactory(table_options));
         break;
+      case 5:
+        // page cache filled with blocks evicted from a small block cache
+        pcache = new_pcache(/*is_compressed=*/false);
+        table_options.persistent_cache = pcache;
+        table_options.persistent_cache_admit_evicted = true;
+        table_options.block_cache = NewLRUCache(64 * 1024, 0);
+        table_options.block_cache_compressed = nullptr;
+        options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+        break;
       default:
         FAIL();
     }
@@ -432,6 +470,14 @@ void PersistentCacheDBTest::RunTest(
         ASSERT_EQ(compressed_block_hit, 0);
         ASSERT_EQ(compressed_block_miss, 0);
         break;
+      case 5:
+        // page cache, small block cache spilling to the page cache
+        ASSERT_GT(page_miss, 0);
+        ASSERT_GT(page_hit, 0);
+        ASSERT_GT(block_miss, 0);
+        ASSERT_EQ(compressed_block_hit, 0);
+        ASSERT_EQ(compressed_block_miss, 0);
+        break;
       default:
         FAIL();
     }
@@ -0,0 +1,100 @@
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include "hdr_metrics_reporter.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <memory>
+
+#include "rocksdb/terark_namespace.h"
+
+namespace TERARKDB_NAMESPACE {
+
+uint64_t HdrCountReporterHandle::GetCount() const {
+  uint64_t res = 0;
+  for (size_t i = 0; i < per_core_count_.Size(); ++i) {
+    res += per_core_count_.AccessAtCore(i)->count.load(
+        std::memory_order_relaxed);
+  }
+  return res;
+}
+
+HistReporterHandle* HdrMetricsReporterFactory::BuildHistReporter(
+    const std::string& name, const std::string& tags, Logger* logger,
+    Env* const env) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  // Reporters with the same name and tags (e.g. several DBs sharing this
+  // factory) are aggregated into one histogram
+  for (auto& h : hist_reporters_) {
+    if (name == h.name() && tags == h.tags()) {
+      return &h;
+    }
+  }
+  hist_reporters_.emplace_back(name, tags, logger, env);
+  return &hist_reporters_.back();
+}
+
+CountReporterHandle* HdrMetricsReporterFactory::BuildCountReporter(
+    const std::string& name, const std::string& tags, Logger* /*logger*/,
+    Env* const /*env*/) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& c : count_reporters_) {
+    if (name == c.name() && tags == c.tags()) {
+      return &c;
+    }
+  }
+  count_reporters_.emplace_back(name, tags);
+  return &count_reporters_.back();
+}
+
+HdrHistReporterHandle* HdrMetricsReporterFactory::GetHistReporter(
+    const std::string& name, const std::string& tags) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& h : hist_reporters_) {
+    if (name == h.name() && tags == h.tags()) {
+      return &h;
+    }
+  }
+  return nullptr;
+}
+
+HdrCountReporterHandle* HdrMetricsReporterFactory::GetCountReporter(
+    const std::string& name, const std::string& tags) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& c : count_reporters_) {
+    if (name == c.name() && tags == c.tags()) {
+      return &c;
+    }
+  }
+  return nullptr;
+}
+
+std::string HdrMetricsReporterFactory::ToString() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::string r;
+  char buf[512];
+  std::unique_ptr<HdrHistogramStat> snapshot(new HdrHistogramStat);
+  for (auto& h : hist_reporters_) {
+    snapshot->Clear();
+    h.GetHistogram().Snapshot(snapshot.get());
+    snprintf(buf, sizeof(buf),
+             "%s [%s] COUNT : %" PRIu64 " AVG : %.2f P50 : %.2f P99 : %.2f"
+             " P99.9 : %.2f P99.99 : %.2f MAX : %" PRIu64 "\n",
+             h.name().c_str(), h.tags().c_str(), snapshot->num(),
+             snapshot->Average(), snapshot->Percentile(50),
+             snapshot->Percentile(99), snapshot->Percentile(99.9),
+             snapshot->Percentile(99.99), snapshot->max());
+    r.append(buf);
+  }
+  for (auto& c : count_reporters_) {
+    snprintf(buf, sizeof(buf), "%s [%s] COUNT : %" PRIu64 "\n",
+             c.name().c_str(), c.tags().c_str(), c.GetCount());
+    r.append(buf);
+  }
+  return r;
+}
+
+}  // namespace TERARKDB_NAMESPACE
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "monitoring/hdr_histogram.h"
+#include "rocksdb/env.h"
+#include "rocksdb/metrics_reporter.h"
+#include "rocksdb/terark_namespace.h"
+#include "util/core_local.h"
+
+namespace TERARKDB_NAMESPACE {
+
+// In-process reporter that keeps every record in a per-core sharded
+// HdrHistogramImpl. AddRecord() never locks, percentiles are computed when
+// read through HdrMetricsReporterFactory.
+class HdrHistReporterHandle : public HistReporterHandle {
+ public:
+  HdrHistReporterHandle(const std::string& name, const std::string& tags,
+                        Logger* logger, Env* const env)
+      : name_(name), tags_(tags), logger_(logger), env_(env) {}
+
+  ~HdrHistReporterHandle() override = default;
+
+ public:
+  void AddRecord(size_t val) override { hist_.Add(val); }
+
+  const char* GetName() override { return name_.c_str(); }
+  const char* GetTag() override { return tags_.c_str(); }
+  Logger* GetLogger() override { return logger_; }
+  Env* GetEnv() override { return env_; }
+
+  const std::string& name() const { return name_; }
+  const std::string& tags() const { return tags_; }
+  const HdrHistogramImpl& GetHistogram() const { return hist_; }
+  HdrHistogramImpl& GetHistogram() { return hist_; }
+
+ private:
+  const std::string name_;
+  const std::string tags_;
+  Logger* logger_;
+  Env* env_;
+
+  HdrHistogramImpl hist_;
+};
+
+class HdrCountReporterHandle : public CountReporterHandle {
+ public:
+  HdrCountReporterHandle(const std::string& name, const std::string& tags)
+      : name_(name), tags_(tags) {}
+
+  ~HdrCountReporterHandle() override = default;
+
+ public:
+  void AddCount(size_t val) override {
+    auto& count = per_core_count_.Access()->count;
+    count.store(count.load(std::memory_order_relaxed) + val,
+                std::memory_order_relaxed);
+  }
+
+  const std::string& name() const { return name_; }
+  const std::string& tags() const { return tags_; }
+
+  uint64_t GetCount() const;
+
+ private:
+  struct ALIGN_AS(CACHE_LINE_SIZE) CoreCount {
+    std::atomic<uint64_t> count{0};
+
+    void* operator new[](size_t s) { return port::cacheline_aligned_alloc(s); }
+    void operator delete[](void* p) { port::cacheline_aligned_free(p); }
+  };
+
+  const std::string name_;
+  const std::string tags_;
+
+  CoreLocalArray<CoreCount> per_core_count_;
+};
+
+class HdrMetricsReporterFactory : public MetricsReporterFactory {
+ public:
+  HdrMetricsReporterFactory() = default;
+
+  ~HdrMetricsReporterFactory() override = default;
+
+ public:
+  HistReporterHandle* BuildHistReporter(const std::string& name,
+                                        const std::string& tags, Logger* logger,
+                                        Env* const env) override;
+
+  CountReporterHandle* BuildCountReporter(const std::string& name,
+                                          const std::string& tags,
+                                          Logger* logger,
+                                          Env* const env) override;
+
+  // Returns nullptr if no reporter named `name` with `tags` was built
+  HdrHistReporterHandle* GetHistReporter(const std::string& name,
+                                         const std::string& tags);
+  HdrCountReporterHandle* GetCountReporter(const std::string& name,
+                                           const std::string& tags);
+
+  // Dumps all histograms (count, average, P50 ... P99.99) and counters
+  std::string ToString() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<HdrHistReporterHandle> hist_reporters_;
+  std::deque<HdrCountReporterHandle> count_reporters_;
+};
+
+}  // namespace TERARKDB_NAMESPACE